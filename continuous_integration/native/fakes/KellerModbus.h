@@ -0,0 +1,62 @@
+/**
+ * @file KellerModbus.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief The Keller driver for the host tests, talking to the simulated
+ * Modbus slave in SensorModbusMaster.h.
+ *
+ * Like the real driver, getValues() reads the pressure and the temperature
+ * in separate transactions.
+ */
+
+#ifndef NATIVE_FAKES_KELLERMODBUS_H_
+#define NATIVE_FAKES_KELLERMODBUS_H_
+
+#include <SensorModbusMaster.h>
+
+#include <math.h>
+
+typedef enum kellerModel {
+    Acculevel_kellerModel = 0,
+    Nanolevel_kellerModel,
+    OTHER
+} kellerModel;
+
+class keller {
+ public:
+    bool begin(kellerModel model, byte modbusSlaveID, Stream* stream,
+               int enablePin = -1) {
+        _model = model;
+        return _modbus.begin(modbusSlaveID, stream, enablePin);
+    }
+    void setDebugStream(Stream* stream) {
+        _modbus.setDebugStream(stream);
+    }
+
+    bool getValues(float& valueP1, float& valueTOB1) {
+        valueP1   = _modbus.getRegisters(0x03, 0x0002, 2)
+              ? _modbus.float32FromFrame(bigEndian)
+              : -9999;
+        valueTOB1 = _modbus.getRegisters(0x03, 0x0008, 2)
+            ? _modbus.float32FromFrame(bigEndian)
+            : -9999;
+        return true;
+    }
+
+    /// The water depth for a pressure and temperature, from P = rho * g * h
+    float calcWaterDepthM(float& waterPressureBar, float& waterTemperatureC) {
+        float t            = waterTemperatureC;
+        float waterDensity = 999.84847 + 6.337563e-2 * t -
+            8.523829e-3 * pow(t, 2) + 6.943248e-5 * pow(t, 3) -
+            3.821216e-7 * pow(t, 4);
+        return 1e5 * waterPressureBar / (waterDensity * 9.80665);
+    }
+
+ private:
+    kellerModel  _model = OTHER;
+    modbusMaster _modbus;
+};
+
+#endif  // NATIVE_FAKES_KELLERMODBUS_H_
@@ -0,0 +1,74 @@
+/**
+ * @file SDI12.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief An SDI-12 bus for the host tests, answered by the test.
+ *
+ * Each command sent is recorded in SDI12::commands and answered with whatever
+ * SDI12::responder returns for it, which is then read back like a reply from
+ * a sensor.  The responder is shared by every SDI12 object, so it stands in
+ * for all of the sensors on all of the pins.
+ */
+
+#ifndef NATIVE_FAKES_SDI12_H_
+#define NATIVE_FAKES_SDI12_H_
+
+#include <Arduino.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class SDI12 : public Stream {
+ public:
+    explicit SDI12(int8_t) {}
+
+    void begin() {}
+    void end() {}
+    void setTimeoutValue(int16_t) {}
+    void clearBuffer() {
+        _reply.clear();
+        _readPosition = 0;
+    }
+
+    void sendCommand(const char* cmd, int8_t = 0) {
+        commands.push_back(cmd);
+        _reply        = responder ? responder(cmd) : std::string();
+        _readPosition = 0;
+    }
+    void sendCommand(String& cmd, int8_t extraWakeTime = 0) {
+        sendCommand(cmd.c_str(), extraWakeTime);
+    }
+
+    int available() override {
+        return static_cast<int>(_reply.size() - _readPosition);
+    }
+    int read() override {
+        return available() > 0
+            ? static_cast<uint8_t>(_reply[_readPosition++])
+            : -1;
+    }
+    int peek() override {
+        return available() > 0 ? static_cast<uint8_t>(_reply[_readPosition])
+                               : -1;
+    }
+    size_t write(uint8_t) override {
+        return 1;
+    }
+    using Print::write;
+
+    static void handleInterrupt() {}
+
+    /// Returns the reply to each command, including its line ending
+    static inline std::function<std::string(const std::string&)> responder;
+    /// Every command sent on any SDI12 object, in order
+    static inline std::vector<std::string> commands;
+
+ private:
+    std::string _reply;
+    size_t      _readPosition = 0;
+};
+
+#endif  // NATIVE_FAKES_SDI12_H_
@@ -0,0 +1,117 @@
+/**
+ * @file SensorModbusMaster.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief A Modbus RTU master for the host tests, answered by a simulated
+ * slave.
+ *
+ * Each register read is answered from modbusMaster::registers, keyed by the
+ * slave address and register number, as a real slave would answer it: with a
+ * response frame of the address, function code, byte count, and big-endian
+ * register values.  Every transaction is counted, along with the time its
+ * request and response would take on an RS-485 bus at 9600 baud.
+ */
+
+#ifndef NATIVE_FAKES_SENSORMODBUSMASTER_H_
+#define NATIVE_FAKES_SENSORMODBUSMASTER_H_
+
+#include <Arduino.h>
+
+#include <map>
+#include <utility>
+
+/// The byte order of the values in the registers
+enum endianness { littleEndian = 0, bigEndian };
+
+class modbusMaster {
+ public:
+    bool begin(byte modbusSlaveID, Stream* stream, int8_t enablePin = -1) {
+        _slaveID = modbusSlaveID;
+        (void)stream;
+        (void)enablePin;
+        return true;
+    }
+    bool begin(byte modbusSlaveID, Stream& stream, int8_t enablePin = -1) {
+        return begin(modbusSlaveID, &stream, enablePin);
+    }
+    void setDebugStream(Stream*) {}
+
+    /// Reads numRegisters registers starting at regNum into the response frame
+    bool getRegisters(byte regType, int regNum, int numRegisters) {
+        transactions++;
+        // address, function, start register, count, and CRC
+        const int requestBytes = 8;
+        if (!respond || numRegisters < 1 ||
+            3 + 2 * numRegisters + 2 > static_cast<int>(sizeof(_frame))) {
+            busTime_us += frameTime_us(requestBytes);
+            return false;
+        }
+        _frame[0] = _slaveID;
+        _frame[1] = regType;
+        _frame[2] = static_cast<byte>(2 * numRegisters);
+        for (int r = 0; r < numRegisters; r++) {
+            uint16_t value = registers[std::make_pair(_slaveID, regNum + r)];
+            _frame[3 + 2 * r] = value >> 8;
+            _frame[4 + 2 * r] = value & 0xFF;
+        }
+        busTime_us += frameTime_us(requestBytes) +
+            frameTime_us(3 + 2 * numRegisters + 2);
+        return true;
+    }
+
+    /// Decodes the float starting at start_index of the last response frame
+    float float32FromFrame(endianness endian, int start_index = 3) {
+        uint8_t bytes[4];
+        for (int i = 0; i < 4; i++) {
+            bytes[i] = endian == bigEndian ? _frame[start_index + 3 - i]
+                                           : _frame[start_index + i];
+        }
+        float value;
+        memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    /// Decodes the unsigned integer at start_index of the last response frame
+    uint16_t uint16FromFrame(endianness endian = bigEndian,
+                             int        start_index = 3) {
+        return endian == bigEndian
+            ? (_frame[start_index] << 8) | _frame[start_index + 1]
+            : (_frame[start_index + 1] << 8) | _frame[start_index];
+    }
+    /// Decodes the signed integer at start_index of the last response frame
+    int16_t int16FromFrame(endianness endian = bigEndian,
+                           int        start_index = 3) {
+        return static_cast<int16_t>(uint16FromFrame(endian, start_index));
+    }
+
+    /// Puts a float in two registers, high word first, as Keller sensors do
+    static void setFloatRegisters(byte address, int regNum, float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        registers[std::make_pair(address, regNum)]     = bits >> 16;
+        registers[std::make_pair(address, regNum + 1)] = bits & 0xFFFF;
+    }
+
+    /// The register values of every simulated slave, by address and number
+    static inline std::map<std::pair<byte, int>, uint16_t> registers;
+    /// Whether the slaves answer
+    static inline bool respond = true;
+    /// The number of transactions started
+    static inline uint32_t transactions = 0;
+    /// The time the transactions would take on the bus, in microseconds
+    static inline uint32_t busTime_us = 0;
+
+ private:
+    // 10 bits per character at 9600 baud, and the 3.5 character silence
+    // that ends an RTU frame
+    static uint32_t frameTime_us(int bytes) {
+        return static_cast<uint32_t>((bytes + 3.5) * 10 * 1000000 / 9600);
+    }
+
+    byte _slaveID = 0;
+    byte _frame[256];
+};
+
+#endif  // NATIVE_FAKES_SENSORMODBUSMASTER_H_
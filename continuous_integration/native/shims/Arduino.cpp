@@ -0,0 +1,294 @@
+/**
+ * @file Arduino.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Implements the host stand-in for the Arduino core.
+ */
+
+#include "Arduino.h"
+
+#include <ctype.h>
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+
+static unsigned long virtualMillis = 0;
+static uint8_t       pinLevels[256];
+static int           analogValues[256];
+
+unsigned long millis() {
+    return virtualMillis++;
+}
+unsigned long micros() {
+    return 1000UL * virtualMillis++;
+}
+void delay(unsigned long ms) {
+    virtualMillis += ms;
+}
+void delayMicroseconds(unsigned int) {}
+void yield() {}
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t val) {
+    pinLevels[pin] = val ? HIGH : LOW;
+}
+int digitalRead(uint8_t pin) {
+    return pinLevels[pin];
+}
+int analogRead(uint8_t pin) {
+    return analogValues[pin];
+}
+void analogReference(uint8_t) {}
+void attachInterrupt(uint8_t, void (*)(), int) {}
+void detachInterrupt(uint8_t) {}
+long random(long howbig) {
+    return howbig > 0 ? rand() % howbig : 0;
+}
+long random(long howsmall, long howbig) {
+    return howbig > howsmall ? howsmall + random(howbig - howsmall) : howsmall;
+}
+void randomSeed(unsigned long seed) {
+    srand(static_cast<unsigned int>(seed));
+}
+
+namespace native {
+void setMillis(unsigned long ms) {
+    virtualMillis = ms;
+}
+void advanceMillis(unsigned long ms) {
+    virtualMillis += ms;
+}
+void setAnalogValue(uint8_t pin, int value) {
+    analogValues[pin] = value;
+}
+}  // namespace native
+
+
+static char* unsignedToBase(unsigned long long value, char* str, int base) {
+    char  digits[66];
+    int   n = 0;
+    char* out;
+    if (base < 2 || base > 36) { base = 10; }
+    do {
+        int d       = static_cast<int>(value % base);
+        digits[n++] = static_cast<char>(d < 10 ? '0' + d : 'a' + d - 10);
+        value /= base;
+    } while (value != 0);
+    out = str;
+    while (n > 0) { *out++ = digits[--n]; }
+    *out = '\0';
+    return str;
+}
+
+char* itoa(int value, char* str, int base) {
+    return ltoa(value, str, base);
+}
+char* ltoa(long value, char* str, int base) {
+    if (value < 0 && base == 10) {
+        str[0] = '-';
+        unsignedToBase(0ULL - static_cast<unsigned long long>(value), str + 1,
+                       base);
+        return str;
+    }
+    return unsignedToBase(static_cast<unsigned long>(value), str, base);
+}
+char* ultoa(unsigned long value, char* str, int base) {
+    return unsignedToBase(value, str, base);
+}
+char* dtostrf(double val, signed char width, unsigned char prec, char* sout) {
+    sprintf(sout, "%*.*f", width, prec, val);
+    return sout;
+}
+
+
+String::String(unsigned char v, unsigned char base)
+    : String(static_cast<unsigned long>(v), base) {}
+String::String(int v, unsigned char base)
+    : String(static_cast<long>(v), base) {}
+String::String(unsigned int v, unsigned char base)
+    : String(static_cast<unsigned long>(v), base) {}
+String::String(long v, unsigned char base) {
+    char buf[68];
+    assign(ltoa(v, buf, base));
+}
+String::String(unsigned long v, unsigned char base) {
+    char buf[68];
+    assign(ultoa(v, buf, base));
+}
+String::String(float v, unsigned char decimals)
+    : String(static_cast<double>(v), decimals) {}
+String::String(double v, unsigned char decimals) {
+    char buf[350];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    assign(buf);
+}
+
+void String::replace(const String& from, const String& to) {
+    if (from._s.empty()) { return; }
+    size_t pos = 0;
+    while ((pos = _s.find(from._s, pos)) != std::string::npos) {
+        _s.replace(pos, from._s.size(), to._s);
+        pos += to._s.size();
+    }
+}
+void String::trim() {
+    size_t first = 0;
+    while (first < _s.size() && isspace(static_cast<unsigned char>(_s[first])))
+        first++;
+    size_t last = _s.size();
+    while (last > first && isspace(static_cast<unsigned char>(_s[last - 1])))
+        last--;
+    assign(_s.substr(first, last - first));
+}
+void String::toUpperCase() {
+    for (char& c : _s) c = static_cast<char>(toupper(c));
+}
+void String::toLowerCase() {
+    for (char& c : _s) c = static_cast<char>(tolower(c));
+}
+void String::toCharArray(char* buf, unsigned int size) const {
+    if (size == 0 || buf == nullptr) { return; }
+    size_t n = std::min<size_t>(size - 1, _s.size());
+    memcpy(buf, _s.c_str(), n);
+    buf[n] = '\0';
+}
+
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++)) {
+            n++;
+        } else {
+            break;
+        }
+    }
+    return n;
+}
+size_t Print::print(long n, int base) {
+    char buf[68];
+    return write(ltoa(n, buf, base));
+}
+size_t Print::print(unsigned long n, int base) {
+    char buf[68];
+    return write(ultoa(n, buf, base));
+}
+size_t Print::print(long long n, int base) {
+    if (n < 0 && base == 10) {
+        return print('-') + print(0ULL - static_cast<unsigned long long>(n));
+    }
+    return print(static_cast<unsigned long long>(n), base);
+}
+size_t Print::print(unsigned long long n, int base) {
+    char buf[68];
+    return write(unsignedToBase(n, buf, base));
+}
+size_t Print::print(double n, int digits) {
+    char buf[350];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+}
+
+
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) { return c; }
+    } while (millis() - start < _timeout);
+    return -1;
+}
+int Stream::timedPeek() {
+    unsigned long start = millis();
+    do {
+        int c = peek();
+        if (c >= 0) { return c; }
+    } while (millis() - start < _timeout);
+    return -1;
+}
+int Stream::peekNextDigit(bool allowDecimal) {
+    while (true) {
+        int c = timedPeek();
+        if (c < 0 || c == '-' || (c >= '0' && c <= '9') ||
+            (allowDecimal && c == '.')) {
+            return c;
+        }
+        read();
+    }
+}
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) { break; }
+        *buffer++ = static_cast<char>(c);
+        count++;
+    }
+    return count;
+}
+size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length) {
+    size_t index = 0;
+    while (index < length) {
+        int c = timedRead();
+        if (c < 0 || c == terminator) { break; }
+        *buffer++ = static_cast<char>(c);
+        index++;
+    }
+    return index;
+}
+String Stream::readString() {
+    std::string ret;
+    int         c;
+    while ((c = timedRead()) >= 0) { ret += static_cast<char>(c); }
+    return String(ret);
+}
+String Stream::readStringUntil(char terminator) {
+    std::string ret;
+    int         c;
+    while ((c = timedRead()) >= 0 && c != terminator) {
+        ret += static_cast<char>(c);
+    }
+    return String(ret);
+}
+long Stream::parseInt() {
+    bool negative = false;
+    long value    = 0;
+    int  c        = peekNextDigit(false);
+    if (c < 0) { return 0; }
+    do {
+        if (c == '-') {
+            negative = true;
+        } else {
+            value = value * 10 + c - '0';
+        }
+        read();
+        c = timedPeek();
+    } while (c >= '0' && c <= '9');
+    return negative ? -value : value;
+}
+float Stream::parseFloat() {
+    std::string text;
+    int         c = peekNextDigit(true);
+    if (c < 0) { return 0; }
+    do {
+        text += static_cast<char>(c);
+        read();
+        c = timedPeek();
+    } while ((c >= '0' && c <= '9') || c == '.');
+    return static_cast<float>(atof(text.c_str()));
+}
+bool Stream::find(const char* target) {
+    size_t len   = strlen(target);
+    size_t index = 0;
+    if (len == 0) { return true; }
+    int c;
+    while ((c = timedRead()) >= 0) {
+        if (c == target[index]) {
+            if (++index >= len) { return true; }
+        } else {
+            index = (c == target[0]) ? 1 : 0;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,406 @@
+/**
+ * @file Arduino.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief A minimal host (Linux) stand-in for the Arduino core.
+ *
+ * This only implements the parts of the Arduino API that the library core
+ * uses.  Time is virtual: every call to millis() or micros() advances the
+ * clock by one millisecond so that busy-wait loops always terminate, and
+ * delay() advances it by the requested amount without sleeping.  The pins
+ * are a plain array that digitalWrite() sets and digitalRead() returns.
+ */
+
+#ifndef NATIVE_SHIMS_ARDUINO_H_
+#define NATIVE_SHIMS_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+using std::max;
+using std::min;
+
+#define ARDUINO 10819
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define DEFAULT 1
+#define NOT_A_PIN 0
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t*>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t*>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t*>(addr))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define memcpy_P memcpy
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bit(b) (1UL << (b))
+#define _BV(b) (1UL << (b))
+#define digitalPinToInterrupt(p) (p)
+
+class __FlashStringHelper;
+#define F(string_literal) \
+    (reinterpret_cast<const __FlashStringHelper*>(PSTR(string_literal)))
+
+/**
+ * @brief Arduino's String, backed by std::string.
+ *
+ * Like Arduino's, any String holding text keeps it on the heap; the small
+ * string optimization is defeated so that allocation counts match a board.
+ */
+class String {
+ public:
+    String() {}
+    String(const char* c) : String(std::string(c ? c : "")) {}  // NOLINT
+    String(const __FlashStringHelper* c)                        // NOLINT
+        : String(std::string(reinterpret_cast<const char*>(c))) {}
+    String(const std::string& c) {  // NOLINT
+        assign(c);
+    }
+    String(const String& o) {
+        assign(o._s);
+    }
+    String& operator=(const String& o) {
+        if (this != &o) { assign(o._s); }
+        return *this;
+    }
+    explicit String(char c) : String(std::string(1, c)) {}
+    explicit String(unsigned char v, unsigned char base = DEC);
+    explicit String(int v, unsigned char base = DEC);
+    explicit String(unsigned int v, unsigned char base = DEC);
+    explicit String(long v, unsigned char base = DEC);
+    explicit String(unsigned long v, unsigned char base = DEC);
+    explicit String(float v, unsigned char decimals = 2);
+    explicit String(double v, unsigned char decimals = 2);
+
+    unsigned int length() const {
+        return static_cast<unsigned int>(_s.size());
+    }
+    const char* c_str() const {
+        return _s.c_str();
+    }
+    bool reserve(unsigned int n) {
+        _s.reserve(n);
+        return true;
+    }
+
+    String& operator+=(const String& o) {
+        return append(o._s.c_str(), o._s.size());
+    }
+    String& operator+=(const char* o) {
+        return append(o, strlen(o));
+    }
+    String& operator+=(const __FlashStringHelper* o) {
+        return *this += reinterpret_cast<const char*>(o);
+    }
+    String& operator+=(char o) {
+        return append(&o, 1);
+    }
+    template <typename T>
+    String& operator+=(T o) {
+        return *this += String(o);
+    }
+    bool concat(const String& o) {
+        *this += o;
+        return true;
+    }
+
+    friend String operator+(const String& a, const String& b) {
+        return String(a._s + b._s);
+    }
+    friend String operator+(const String& a, const char* b) {
+        return String(a._s + b);
+    }
+    friend String operator+(const char* a, const String& b) {
+        return String(a + b._s);
+    }
+    friend String operator+(const String& a, char b) {
+        return String(a._s + b);
+    }
+    template <typename T>
+    friend String operator+(const String& a, T b) {
+        return a + String(b);
+    }
+
+    bool operator==(const String& o) const {
+        return _s == o._s;
+    }
+    bool operator==(const char* o) const {
+        return _s == o;
+    }
+    bool operator!=(const String& o) const {
+        return _s != o._s;
+    }
+    bool operator!=(const char* o) const {
+        return _s != o;
+    }
+    bool equals(const String& o) const {
+        return _s == o._s;
+    }
+    char operator[](unsigned int i) const {
+        return i < _s.size() ? _s[i] : '\0';
+    }
+    char& operator[](unsigned int i) {
+        return _s[i];
+    }
+    char charAt(unsigned int i) const {
+        return (*this)[i];
+    }
+    void setCharAt(unsigned int i, char c) {
+        if (i < _s.size()) { _s[i] = c; }
+    }
+
+    String substring(unsigned int from) const {
+        return from < _s.size() ? String(_s.substr(from)) : String();
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) { std::swap(from, to); }
+        if (from >= _s.size()) { return String(); }
+        return String(_s.substr(from, to - from));
+    }
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t p = _s.find(c, from);
+        return p == std::string::npos ? -1 : static_cast<int>(p);
+    }
+    int indexOf(const String& o, unsigned int from = 0) const {
+        size_t p = _s.find(o._s, from);
+        return p == std::string::npos ? -1 : static_cast<int>(p);
+    }
+    int lastIndexOf(char c) const {
+        size_t p = _s.rfind(c);
+        return p == std::string::npos ? -1 : static_cast<int>(p);
+    }
+    bool startsWith(const String& o) const {
+        return _s.compare(0, o._s.size(), o._s) == 0;
+    }
+    bool endsWith(const String& o) const {
+        return _s.size() >= o._s.size() &&
+            _s.compare(_s.size() - o._s.size(), o._s.size(), o._s) == 0;
+    }
+    void replace(const String& from, const String& to);
+    void remove(unsigned int index) {
+        if (index < _s.size()) { _s.erase(index); }
+    }
+    void remove(unsigned int index, unsigned int count) {
+        if (index < _s.size()) { _s.erase(index, count); }
+    }
+    void trim();
+    void toUpperCase();
+    void toLowerCase();
+    long toInt() const {
+        return atol(_s.c_str());
+    }
+    float toFloat() const {
+        return static_cast<float>(atof(_s.c_str()));
+    }
+    void toCharArray(char* buf, unsigned int size) const;
+
+ private:
+    void assign(const std::string& text) {
+        _s.clear();
+        _s.shrink_to_fit();
+        if (!text.empty()) { _s.reserve(std::max<size_t>(text.size(), 16)); }
+        _s = text;
+    }
+    String& append(const char* text, size_t n) {
+        if (n > 0 && _s.capacity() < 16) { _s.reserve(16 + n); }
+        _s.append(text, n);
+        return *this;
+    }
+
+    std::string _s;
+};
+
+/**
+ * @brief Arduino's Print base class.
+ */
+class Print {
+ public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) {
+        if (str == nullptr) { return 0; }
+        return write(reinterpret_cast<const uint8_t*>(str), strlen(str));
+    }
+    size_t write(const char* buffer, size_t size) {
+        return write(reinterpret_cast<const uint8_t*>(buffer), size);
+    }
+    virtual int availableForWrite() {
+        return 0;
+    }
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper* s) {
+        return write(reinterpret_cast<const char*>(s));
+    }
+    size_t print(const String& s) {
+        return write(s.c_str(), s.length());
+    }
+    size_t print(const char* s) {
+        return write(s);
+    }
+    size_t print(char c) {
+        return write(static_cast<uint8_t>(c));
+    }
+    size_t print(unsigned char n, int base = DEC) {
+        return print(static_cast<unsigned long>(n), base);
+    }
+    size_t print(int n, int base = DEC) {
+        return print(static_cast<long>(n), base);
+    }
+    size_t print(unsigned int n, int base = DEC) {
+        return print(static_cast<unsigned long>(n), base);
+    }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(long long n, int base = DEC);
+    size_t print(unsigned long long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println() {
+        return write("\r\n");
+    }
+    // by reference, as the core takes a String
+    template <typename T>
+    size_t println(const T& v) {
+        size_t n = print(v);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T& v, int format) {
+        size_t n = print(v, format);
+        return n + println();
+    }
+};
+
+/**
+ * @brief Arduino's Stream base class.
+ *
+ * The parsing helpers use the same one second default timeout as the core,
+ * measured on the virtual clock.
+ */
+class Stream : public Print {
+ public:
+    virtual int available() = 0;
+    virtual int read()      = 0;
+    virtual int peek()      = 0;
+
+    void setTimeout(unsigned long timeout) {
+        _timeout = timeout;
+    }
+    unsigned long getTimeout() {
+        return _timeout;
+    }
+    size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        return readBytes(reinterpret_cast<char*>(buffer), length);
+    }
+    size_t readBytesUntil(char terminator, char* buffer, size_t length);
+    size_t readBytesUntil(char terminator, uint8_t* buffer, size_t length) {
+        return readBytesUntil(terminator, reinterpret_cast<char*>(buffer),
+                              length);
+    }
+    String readString();
+    String readStringUntil(char terminator);
+    long   parseInt();
+    float  parseFloat();
+    bool   find(const char* target);
+
+ protected:
+    int timedRead();
+    int timedPeek();
+    int peekNextDigit(bool allowDecimal);
+
+    unsigned long _timeout = 1000;
+};
+
+/**
+ * @brief A serial port that writes to stdout and never has anything to read.
+ */
+class HardwareSerial : public Stream {
+ public:
+    void begin(unsigned long) {}
+    void end() {}
+    int  available() override {
+        return 0;
+    }
+    int read() override {
+        return -1;
+    }
+    int peek() override {
+        return -1;
+    }
+    size_t write(uint8_t c) override {
+        return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+    using Print::write;
+    explicit operator bool() const {
+        return true;
+    }
+};
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+unsigned long millis();
+unsigned long micros();
+void          delay(unsigned long ms);
+void          delayMicroseconds(unsigned int us);
+void          yield();
+void          pinMode(uint8_t pin, uint8_t mode);
+void          digitalWrite(uint8_t pin, uint8_t val);
+int           digitalRead(uint8_t pin);
+int           analogRead(uint8_t pin);
+void          analogReference(uint8_t mode);
+void          attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void          detachInterrupt(uint8_t pin);
+inline void   noInterrupts() {}
+inline void   interrupts() {}
+long          random(long howbig);
+long          random(long howsmall, long howbig);
+void          randomSeed(unsigned long seed);
+
+char* itoa(int value, char* str, int base);
+char* ltoa(long value, char* str, int base);
+char* ultoa(unsigned long value, char* str, int base);
+char* dtostrf(double val, signed char width, unsigned char prec, char* sout);
+
+/**
+ * @brief Controls for the emulated board, for use by the host tests.
+ */
+namespace native {
+/// Set the virtual clock, in milliseconds since boot
+void setMillis(unsigned long ms);
+/// Move the virtual clock forward
+void advanceMillis(unsigned long ms);
+/// Set the value analogRead() returns for a pin
+void setAnalogValue(uint8_t pin, int value);
+}  // namespace native
+
+#endif  // NATIVE_SHIMS_ARDUINO_H_
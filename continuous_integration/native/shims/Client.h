@@ -0,0 +1,38 @@
+/**
+ * @file Client.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Arduino's abstract network client, for the host build.
+ */
+
+#ifndef NATIVE_SHIMS_CLIENT_H_
+#define NATIVE_SHIMS_CLIENT_H_
+
+#include <Arduino.h>
+
+class IPAddress {
+ public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _address{a, b, c, d} {}
+    uint8_t operator[](int i) const {
+        return _address[i];
+    }
+
+ private:
+    uint8_t _address[4] = {0, 0, 0, 0};
+};
+
+class Client : public Stream {
+ public:
+    virtual int     connect(IPAddress ip, uint16_t port)     = 0;
+    virtual int     connect(const char* host, uint16_t port) = 0;
+    virtual int     read(uint8_t* buf, size_t size)          = 0;
+    virtual void    stop()                                   = 0;
+    virtual uint8_t connected()                              = 0;
+    virtual explicit operator bool()                         = 0;
+    using Stream::read;
+};
+
+#endif  // NATIVE_SHIMS_CLIENT_H_
@@ -0,0 +1,37 @@
+/**
+ * @file NativeBoard.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Board definitions for the host build.
+ *
+ * This is force-included ahead of every source file, standing in for the
+ * values that KnownProcessors.h and the board's core normally supply.
+ */
+
+#ifndef NATIVE_SHIMS_NATIVEBOARD_H_
+#define NATIVE_SHIMS_NATIVEBOARD_H_
+
+#include <stdint.h>
+
+#define LOGGER_BOARD "Native"
+#define OPERATING_VOLTAGE 3.3
+#define BATTERY_PIN -1
+#define BATTERY_MULTIPLIER -1
+#define MS_OUTPUT Serial
+#define MS_USE_DS3231
+
+/**
+ * @brief A watchdog that never bites; the library only has AVR and SAMD ones.
+ */
+class extendedWatchDogNative {
+ public:
+    static void setupWatchDog(uint32_t) {}
+    static void enableWatchDog() {}
+    static void disableWatchDog() {}
+    static void resetWatchDog() {}
+};
+#define extendedWatchDog extendedWatchDogNative
+
+#endif  // NATIVE_SHIMS_NATIVEBOARD_H_
@@ -0,0 +1,22 @@
+/**
+ * @file SPI.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief A do-nothing SPI bus for the host build.
+ */
+
+#ifndef NATIVE_SHIMS_SPI_H_
+#define NATIVE_SHIMS_SPI_H_
+
+#include <Arduino.h>
+
+class SPIClass {
+ public:
+    void begin() {}
+    void end() {}
+};
+extern SPIClass SPI;
+
+#endif  // NATIVE_SHIMS_SPI_H_
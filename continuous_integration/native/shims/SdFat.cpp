@@ -0,0 +1,173 @@
+/**
+ * @file SdFat.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Implements the directory-backed SD card and the other host
+ * peripherals.
+ */
+
+#include "SdFat.h"
+#include "Sodaq_DS3231.h"
+#include "Wire.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+SPIClass     SPI;
+TwoWire      Wire;
+Sodaq_DS3231 rtc;
+
+static std::string sdDirectory = ".";
+static bool        sdPresent   = true;
+static long        sdReadLimit = -1;
+
+void (*File::_dateTimeCallback)(uint16_t*, uint16_t*) = nullptr;
+
+namespace native {
+void setSdDirectory(const char* path) {
+    sdDirectory = path;
+}
+void setSdCardPresent(bool present) {
+    sdPresent = present;
+}
+void setSdReadLimit(long bytes) {
+    sdReadLimit = bytes;
+}
+}  // namespace native
+
+static std::string sdPath(const char* path) {
+    while (*path == '/') { path++; }
+    return sdDirectory + "/" + path;
+}
+
+
+File::~File() {
+    close();
+}
+
+bool File::open(const char* path, oflag_t oflag) {
+    close();
+    if (!sdPresent) { return false; }
+    _path = sdPath(path);
+    _fd   = ::open(_path.c_str(), oflag & ~O_AT_END, 0644);
+    if (_fd >= 0 && (oflag & O_AT_END)) { seekEnd(); }
+    return _fd >= 0;
+}
+
+bool File::close() {
+    if (_fd < 0) { return false; }
+    ::close(_fd);
+    _fd = -1;
+    return true;
+}
+
+int File::available() {
+    uint64_t end = fileSize();
+    uint64_t pos = curPosition();
+    return end > pos ? static_cast<int>(std::min<uint64_t>(end - pos, 0x7FFF))
+                     : 0;
+}
+
+int File::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int File::peek() {
+    uint64_t pos = curPosition();
+    int      b   = read();
+    seekSet(pos);
+    return b;
+}
+
+int File::read(void* buf, size_t count) {
+    if (_fd < 0) { return -1; }
+    if (sdReadLimit >= 0 && count > static_cast<size_t>(sdReadLimit)) {
+        count = static_cast<size_t>(sdReadLimit);
+    }
+    int n = static_cast<int>(::read(_fd, buf, count));
+    if (sdReadLimit >= 0 && n > 0) { sdReadLimit -= n; }
+    return n;
+}
+
+size_t File::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t File::write(const void* buf, size_t count) {
+    if (_fd < 0) { return 0; }
+    ssize_t n = ::write(_fd, buf, count);
+    return n < 0 ? 0 : static_cast<size_t>(n);
+}
+
+bool File::sync() {
+    return _fd >= 0 && fsync(_fd) == 0;
+}
+
+bool File::seekSet(uint64_t pos) {
+    return _fd >= 0 && lseek(_fd, static_cast<off_t>(pos), SEEK_SET) >= 0;
+}
+
+bool File::seekEnd(int64_t offset) {
+    return _fd >= 0 && lseek(_fd, static_cast<off_t>(offset), SEEK_END) >= 0;
+}
+
+uint64_t File::curPosition() const {
+    if (_fd < 0) { return 0; }
+    off_t pos = lseek(_fd, 0, SEEK_CUR);
+    return pos < 0 ? 0 : static_cast<uint64_t>(pos);
+}
+
+uint64_t File::fileSize() const {
+    struct stat st;
+    if (_fd < 0 || fstat(_fd, &st) != 0) { return 0; }
+    return static_cast<uint64_t>(st.st_size);
+}
+
+bool File::truncate() {
+    return truncate(curPosition());
+}
+
+bool File::truncate(uint64_t length) {
+    if (_fd < 0 || ftruncate(_fd, static_cast<off_t>(length)) != 0) {
+        return false;
+    }
+    return seekSet(length);
+}
+
+bool File::remove() {
+    if (_fd < 0) { return false; }
+    close();
+    return ::unlink(_path.c_str()) == 0;
+}
+
+bool File::timestamp(uint8_t, uint16_t, uint8_t, uint8_t, uint8_t, uint8_t,
+                     uint8_t) {
+    return _fd >= 0;
+}
+
+
+bool SdFat::cardBegin(const SdSpiConfig&) {
+    return sdPresent;
+}
+
+bool SdFat::volumeBegin() {
+    struct stat st;
+    return sdPresent && stat(sdDirectory.c_str(), &st) == 0 &&
+        S_ISDIR(st.st_mode);
+}
+
+bool SdFat::exists(const char* path) {
+    struct stat st;
+    return sdPresent && stat(sdPath(path).c_str(), &st) == 0;
+}
+
+bool SdFat::remove(const char* path) {
+    return sdPresent && ::unlink(sdPath(path).c_str()) == 0;
+}
+
+bool SdFat::mkdir(const char* path, bool) {
+    return sdPresent && ::mkdir(sdPath(path).c_str(), 0755) == 0;
+}
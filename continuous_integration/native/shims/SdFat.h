@@ -0,0 +1,132 @@
+/**
+ * @file SdFat.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief An SD card for the host build, backed by a directory.
+ *
+ * File names are resolved inside the directory given to
+ * native::setSdDirectory() (the current directory by default).  Only the
+ * parts of the SdFat API that the library uses are implemented.
+ */
+
+#ifndef NATIVE_SHIMS_SDFAT_H_
+#define NATIVE_SHIMS_SDFAT_H_
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <fcntl.h>
+
+typedef int      oflag_t;
+typedef uint8_t  SdCsPin_t;
+typedef SPIClass SpiPort_t;
+
+#define O_READ O_RDONLY
+#define O_WRITE O_WRONLY
+#define O_AT_END 0x40000000
+
+#define SHARED_SPI 0
+#define DEDICATED_SPI 1
+#define USER_SPI_BEGIN 2
+#define SD_SCK_MHZ(maxMhz) (1000000UL * (maxMhz))
+#define SPI_FULL_SPEED SD_SCK_MHZ(50)
+
+#define T_ACCESS 1
+#define T_CREATE 2
+#define T_WRITE 4
+
+#define FAT_DATE(year, month, day) \
+    static_cast<uint16_t>(((year) - 1980) << 9 | (month) << 5 | (day))
+#define FAT_TIME(hour, minute, second) \
+    static_cast<uint16_t>((hour) << 11 | (minute) << 5 | (second) >> 1)
+
+namespace native {
+/// Set the directory that stands in for the root of the SD card
+void setSdDirectory(const char* path);
+/// Make every SD card operation fail, as if the card were missing
+void setSdCardPresent(bool present);
+/// Let only this many more bytes be read from files; -1 for no limit
+void setSdReadLimit(long bytes);
+}  // namespace native
+
+class SdSpiConfig {
+ public:
+    SdSpiConfig(SdCsPin_t, uint8_t, uint32_t = SD_SCK_MHZ(50),
+                SpiPort_t* = nullptr) {}
+};
+
+class File : public Stream {
+ public:
+    File() {}
+    File(const File&)            = delete;
+    File& operator=(const File&) = delete;
+    ~File() override;
+
+    bool open(const char* path, oflag_t oflag = O_RDONLY);
+    bool close();
+    bool isOpen() const {
+        return _fd >= 0;
+    }
+    explicit operator bool() const {
+        return isOpen();
+    }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    int read(void* buf, size_t count);
+    using Print::write;
+    size_t write(uint8_t b) override;
+    size_t write(const void* buf, size_t count);
+    size_t write(const uint8_t* buf, size_t count) override {
+        return write(static_cast<const void*>(buf), count);
+    }
+    void flush() override {
+        sync();
+    }
+    bool sync();
+
+    bool     seekSet(uint64_t pos);
+    bool     seekEnd(int64_t offset = 0);
+    uint64_t curPosition() const;
+    uint64_t fileSize() const;
+    uint64_t size() const {
+        return fileSize();
+    }
+    bool truncate();
+    bool truncate(uint64_t length);
+    bool remove();
+    bool timestamp(uint8_t flags, uint16_t year, uint8_t month, uint8_t day,
+                   uint8_t hour, uint8_t minute, uint8_t second);
+
+    static void dateTimeCallback(void (*callback)(uint16_t* date,
+                                                  uint16_t* time)) {
+        _dateTimeCallback = callback;
+    }
+
+ private:
+    int         _fd = -1;
+    std::string _path;
+
+    static void (*_dateTimeCallback)(uint16_t*, uint16_t*);
+};
+typedef File SdFile;
+typedef File FsFile;
+
+class SdFat {
+ public:
+    bool begin(SdCsPin_t = 0) {
+        return cardBegin(SdSpiConfig(0, 0)) && volumeBegin();
+    }
+    bool begin(const SdSpiConfig& config) {
+        return cardBegin(config) && volumeBegin();
+    }
+    bool cardBegin(const SdSpiConfig&);
+    bool volumeBegin();
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool mkdir(const char* path, bool pFlag = true);
+};
+
+#endif  // NATIVE_SHIMS_SDFAT_H_
@@ -0,0 +1,62 @@
+/**
+ * @file Sodaq_DS3231.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief A DS3231 real time clock for the host build that runs on the virtual
+ * millis() clock.
+ */
+
+#ifndef NATIVE_SHIMS_SODAQ_DS3231_H_
+#define NATIVE_SHIMS_SODAQ_DS3231_H_
+
+#include <Arduino.h>
+
+enum Sodaq_DS3231_Period { EverySecond, EveryMinute, EveryHour };
+enum Sodaq_DS3231_Match {
+    MATCH_SECONDS,
+    MATCH_MINUTES,
+    MATCH_HOURS,
+    MATCH_DATE,
+    MATCH_DAY,
+};
+
+class DateTime {
+ public:
+    explicit DateTime(uint32_t t = 0) : _epoch(t) {}
+    uint32_t getEpoch() const {
+        return _epoch;
+    }
+
+ private:
+    uint32_t _epoch;
+};
+
+class Sodaq_DS3231 {
+ public:
+    void begin() {}
+    DateTime now() {
+        return DateTime(static_cast<uint32_t>(_setEpoch +
+                                              (millis() - _setMillis) / 1000));
+    }
+    void setEpoch(uint32_t ts) {
+        _setEpoch  = ts;
+        _setMillis = millis();
+    }
+    void enableInterrupts(Sodaq_DS3231_Period) {}
+    void enableInterrupts(Sodaq_DS3231_Match, uint8_t, uint8_t, uint8_t,
+                          uint8_t) {}
+    void disableInterrupts() {}
+    void clearINTStatus() {}
+    float getTemperature() {
+        return 20.0f;
+    }
+
+ private:
+    uint32_t      _setEpoch  = 0;
+    unsigned long _setMillis = 0;
+};
+extern Sodaq_DS3231 rtc;
+
+#endif  // NATIVE_SHIMS_SODAQ_DS3231_H_
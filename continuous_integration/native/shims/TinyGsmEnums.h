@@ -0,0 +1,33 @@
+/**
+ * @file TinyGsmEnums.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief The TinyGSM enums that the modem base class refers to.
+ */
+
+#ifndef NATIVE_SHIMS_TINYGSMENUMS_H_
+#define NATIVE_SHIMS_TINYGSMENUMS_H_
+
+enum SimStatus {
+    SIM_ERROR  = 0,
+    SIM_READY  = 1,
+    SIM_LOCKED = 2,
+};
+
+enum RegStatus {
+    REG_NO_RESULT    = -1,
+    REG_UNREGISTERED = 0,
+    REG_SEARCHING    = 2,
+    REG_DENIED       = 3,
+    REG_OK_HOME      = 1,
+    REG_OK_ROAMING   = 5,
+    REG_UNKNOWN      = 4,
+};
+
+enum class SSLAuthMode { NO_VALIDATION, CA_VALIDATION, MUTUAL_AUTHENTICATION };
+
+enum class SSLVersion { SSL3_0, TLS1_0, TLS1_1, TLS1_2, TLS1_3, ALL_SSL };
+
+#endif  // NATIVE_SHIMS_TINYGSMENUMS_H_
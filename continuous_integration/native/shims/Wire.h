@@ -0,0 +1,47 @@
+/**
+ * @file Wire.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief An I2C bus for the host build with nothing attached to it.
+ *
+ * Every transmission ends with a NACK (status 2) and every request returns no
+ * bytes, which is what a real bus does when the addressed device is missing.
+ */
+
+#ifndef NATIVE_SHIMS_WIRE_H_
+#define NATIVE_SHIMS_WIRE_H_
+
+#include <Arduino.h>
+
+class TwoWire : public Stream {
+ public:
+    void begin() {}
+    void end() {}
+    void setClock(uint32_t) {}
+    void setTimeout(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    uint8_t endTransmission(bool = true) {
+        return 2;
+    }
+    uint8_t requestFrom(uint8_t, uint8_t, bool = true) {
+        return 0;
+    }
+    int available() override {
+        return 0;
+    }
+    int read() override {
+        return -1;
+    }
+    int peek() override {
+        return -1;
+    }
+    size_t write(uint8_t) override {
+        return 1;
+    }
+    using Print::write;
+};
+extern TwoWire Wire;
+
+#endif  // NATIVE_SHIMS_WIRE_H_
@@ -0,0 +1,25 @@
+/**
+ * @file pins_arduino.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Pin definitions for the host stand-in board.
+ */
+
+#ifndef NATIVE_SHIMS_PINS_ARDUINO_H_
+#define NATIVE_SHIMS_PINS_ARDUINO_H_
+
+#define NUM_DIGITAL_PINS 32
+#define NUM_ANALOG_INPUTS 8
+#define LED_BUILTIN 13
+#define A0 24
+#define A1 25
+#define A2 26
+#define A3 27
+#define A4 28
+#define A5 29
+#define A6 30
+#define A7 31
+
+#endif  // NATIVE_SHIMS_PINS_ARDUINO_H_
@@ -0,0 +1,99 @@
+/**
+ * @file AllocationCounter.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Counts heap allocations made with new, including those by String.
+ *
+ * This replaces the global operator new, so include it in only one source
+ * file of a test.  Allocations are only counted while an AllocationCount is
+ * in scope, so a test can leave out the allocations of its own bookkeeping.
+ */
+
+#ifndef NATIVE_TESTS_ALLOCATIONCOUNTER_H_
+#define NATIVE_TESTS_ALLOCATIONCOUNTER_H_
+
+#include <stdlib.h>
+
+#include <new>
+
+static bool   countingAllocations = false;
+static size_t allocationCount     = 0;
+static size_t allocatedBytes      = 0;
+
+/**
+ * @brief Counts the allocations made while it is in scope.
+ */
+class AllocationCount {
+ public:
+    AllocationCount() {
+        _startCount         = allocationCount;
+        _startBytes         = allocatedBytes;
+        _wasCounting        = countingAllocations;
+        countingAllocations = true;
+    }
+    ~AllocationCount() {
+        countingAllocations = _wasCounting;
+    }
+    /// The number of allocations since this was created
+    size_t count() const {
+        return allocationCount - _startCount;
+    }
+    /// The number of bytes allocated since this was created
+    size_t bytes() const {
+        return allocatedBytes - _startBytes;
+    }
+
+ private:
+    size_t _startCount;
+    size_t _startBytes;
+    bool   _wasCounting;
+};
+
+/**
+ * @brief Stops counting allocations while it is in scope.
+ */
+class AllocationPause {
+ public:
+    AllocationPause() : _wasCounting(countingAllocations) {
+        countingAllocations = false;
+    }
+    ~AllocationPause() {
+        countingAllocations = _wasCounting;
+    }
+
+ private:
+    bool _wasCounting;
+};
+
+// Not inlined, so the compiler doesn't see the malloc() and free() inside
+// them and warn that they don't match
+#define NOT_INLINED __attribute__((noinline))
+
+NOT_INLINED void* operator new(size_t size) {
+    if (countingAllocations) {
+        allocationCount++;
+        allocatedBytes += size;
+    }
+    void* p = malloc(size > 0 ? size : 1);
+    if (p == nullptr) { throw std::bad_alloc(); }
+    return p;
+}
+NOT_INLINED void* operator new[](size_t size) {
+    return operator new(size);
+}
+NOT_INLINED void operator delete(void* p) noexcept {
+    free(p);
+}
+NOT_INLINED void operator delete[](void* p) noexcept {
+    free(p);
+}
+NOT_INLINED void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+NOT_INLINED void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+#endif  // NATIVE_TESTS_ALLOCATIONCOUNTER_H_
@@ -0,0 +1,139 @@
+/**
+ * @file RecordingClient.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief A network client that records each request and answers it with a
+ * fixed HTTP response.
+ */
+
+#ifndef NATIVE_TESTS_RECORDINGCLIENT_H_
+#define NATIVE_TESTS_RECORDINGCLIENT_H_
+
+#include <Client.h>
+
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+class RecordingClient : public Client {
+ public:
+    int connect(IPAddress, uint16_t) override {
+        return open();
+    }
+    int connect(const char*, uint16_t) override {
+        return open();
+    }
+    size_t write(uint8_t c) override {
+        if (!_connected) { return 0; }
+        requests.back() += static_cast<char>(c);
+        bytesSent++;
+        return 1;
+    }
+    size_t write(const uint8_t* buf, size_t size) override {
+        if (!_connected) { return 0; }
+        requests.back().append(reinterpret_cast<const char*>(buf), size);
+        bytesSent += size;
+        return size;
+    }
+    using Print::write;
+    int available() override {
+        return _connected ? static_cast<int>(response.size() - _readPosition)
+                          : 0;
+    }
+    int read() override {
+        return available() > 0 ? response[_readPosition++] : -1;
+    }
+    int read(uint8_t* buf, size_t size) override {
+        size_t n = 0;
+        while (n < size && available() > 0) { buf[n++] = read(); }
+        return static_cast<int>(n);
+    }
+    int peek() override {
+        return available() > 0 ? response[_readPosition] : -1;
+    }
+    void stop() override {
+        _connected = false;
+    }
+    uint8_t connected() override {
+        return _connected;
+    }
+    explicit operator bool() override {
+        return _connected;
+    }
+
+    /// Gets the body of a request, checking it against its Content-Length or
+    /// taking it out of its chunks; false if the framing is wrong
+    static bool decodeBody(const std::string& request, std::string& body) {
+        size_t start = request.find("\r\n\r\n");
+        if (start == std::string::npos) { return false; }
+        start += 4;
+        body.clear();
+        size_t length = request.find("Content-Length: ");
+        if (length < start) {
+            body = request.substr(start);
+            return strtoul(request.c_str() + length + 16, nullptr, 10) ==
+                body.size();
+        }
+        if (request.find("Transfer-Encoding: chunked") > start) {
+            return false;
+        }
+        // each chunk is its size in hex and CRLF, the data, and CRLF, up to
+        // an empty chunk and a final CRLF
+        size_t pos = start;
+        while (true) {
+            size_t line = request.find("\r\n", pos);
+            if (line == std::string::npos) { return false; }
+            size_t size = strtoul(request.c_str() + pos, nullptr, 16);
+            if (size == 0) { return request.size() == line + 4; }
+            if (request.size() < line + 2 + size + 2 ||
+                request.compare(line + 2 + size, 2, "\r\n") != 0) {
+                return false;
+            }
+            body.append(request, line + 2, size);
+            pos = line + 2 + size + 2;
+        }
+    }
+
+    /// Every timestamp posted to Monitor My Watershed, in the order sent
+    std::vector<std::string> postedTimestamps() const {
+        std::vector<std::string> timestamps;
+        const std::string        tag = "\"timestamp\":";
+        std::string              request;
+        for (const std::string& sent : requests) {
+            if (!decodeBody(sent, request)) { continue; }
+            size_t pos = request.find(tag);
+            if (pos == std::string::npos) { continue; }
+            pos += tag.size();
+            size_t end = request[pos] == '[' ? request.find(']', pos)
+                                             : request.find('"', pos + 1);
+            while ((pos = request.find('"', pos)) < end) {
+                size_t close = request.find('"', pos + 1);
+                timestamps.push_back(request.substr(pos + 1, close - pos - 1));
+                pos = close + 1;
+            }
+        }
+        return timestamps;
+    }
+
+    bool                     acceptConnections = true;
+    std::string              response = "HTTP/1.1 201 Created\r\n\r\n";
+    std::vector<std::string> requests;
+    size_t                   bytesSent = 0;
+
+ private:
+    int open() {
+        if (!acceptConnections) { return 0; }
+        requests.emplace_back();
+        _connected    = true;
+        _readPosition = 0;
+        return 1;
+    }
+
+    bool   _connected    = false;
+    size_t _readPosition = 0;
+};
+
+#endif  // NATIVE_TESTS_RECORDINGCLIENT_H_
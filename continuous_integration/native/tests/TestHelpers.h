@@ -0,0 +1,173 @@
+/**
+ * @file TestHelpers.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Check macros and a scriptable sensor for the host tests.
+ *
+ * Each test is its own executable; its main() returns testResult(), which is
+ * non-zero if any check failed.
+ */
+
+#ifndef NATIVE_TESTS_TESTHELPERS_H_
+#define NATIVE_TESTS_TESTHELPERS_H_
+
+#include <Arduino.h>
+#include "SensorBase.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int testFailures = 0;
+
+#define TEST_CHECK(condition)                                           \
+    do {                                                                \
+        if (!(condition)) {                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__,     \
+                   #condition);                                         \
+            testFailures++;                                             \
+        }                                                               \
+    } while (0)
+
+#define TEST_CHECK_EQUAL(actual, expected)                                \
+    do {                                                                  \
+        long long testActual   = static_cast<long long>(actual);          \
+        long long testExpected = static_cast<long long>(expected);        \
+        if (testActual != testExpected) {                                 \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__,        \
+                   __LINE__, #actual, testActual, testExpected);          \
+            testFailures++;                                               \
+        }                                                                 \
+    } while (0)
+
+#define TEST_CHECK_STRING(actual, expected)                                 \
+    do {                                                                    \
+        const char* testActual   = (actual);                                \
+        const char* testExpected = (expected);                              \
+        if (strcmp(testActual, testExpected) != 0) {                        \
+            printf("%s:%d: %s is \"%s\", expected \"%s\"\n", __FILE__,      \
+                   __LINE__, #actual, testActual, testExpected);            \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (0)
+
+static inline int testResult() {
+    if (testFailures) {
+        printf("%d check(s) failed\n", testFailures);
+    } else {
+        printf("All checks passed\n");
+    }
+    return testFailures ? 1 : 0;
+}
+
+/**
+ * @brief A sensor whose readings and failures are set by the test.
+ */
+class ScriptedSensor : public Sensor {
+ public:
+    explicit ScriptedSensor(const char* name, uint8_t returnedValues = 1,
+                            uint32_t warmUpTime_ms      = 0,
+                            uint32_t measurementTime_ms = 0,
+                            int8_t   powerPin           = -1)
+        : Sensor(name, returnedValues, warmUpTime_ms, 0, measurementTime_ms,
+                 powerPin, -1, 1) {}
+
+    String getSensorLocation() override {
+        return String("scripted");
+    }
+
+    bool addSingleMeasurementResult() override {
+        if (!initializeMeasurementResult()) { return false; }
+        attempts++;
+        if (failing) { return finalizeMeasurementAttempt(false); }
+        for (uint8_t i = 0; i < _numReturnedValues; i++) {
+            verifyAndAddMeasurementResult(i, reading + i);
+        }
+        return finalizeMeasurementAttempt(true);
+    }
+
+    float reading  = 10.0f;
+    bool  failing  = false;
+    int   attempts = 0;
+};
+
+/**
+ * @brief A sensor returning a list of readings for its first result, one per
+ * measurement, starting over when the list runs out.
+ */
+class ListSensor : public ScriptedSensor {
+ public:
+    explicit ListSensor(const char* name, int8_t powerPin = -1)
+        : ScriptedSensor(name, 1, 0, 0, powerPin) {}
+
+    bool addSingleMeasurementResult() override {
+        if (!initializeMeasurementResult()) { return false; }
+        if (failing) { return finalizeMeasurementAttempt(false); }
+        verifyAndAddMeasurementResult(0, readings[attempts++ % count]);
+        return finalizeMeasurementAttempt(true);
+    }
+
+    /// Sets the readings and the number of measurements to average them over
+    void setReadings(const float* list, uint8_t n) {
+        readings = list;
+        count    = n;
+        attempts = 0;
+        setNumberMeasurementsToAverage(n);
+    }
+
+    const float* readings = nullptr;
+    uint8_t      count    = 1;
+};
+
+/**
+ * @brief A stream keeping what is printed to it in a fixed buffer, so
+ * printing to it doesn't allocate.
+ */
+class CaptureStream : public Stream {
+ public:
+    size_t write(uint8_t c) override {
+        if (_length + 1 >= sizeof(_text)) { return 0; }
+        _text[_length++] = static_cast<char>(c);
+        _text[_length]   = '\0';
+        return 1;
+    }
+    using Print::write;
+    int available() override {
+        return 0;
+    }
+    int read() override {
+        return -1;
+    }
+    int peek() override {
+        return -1;
+    }
+
+    void clear() {
+        _length  = 0;
+        _text[0] = '\0';
+    }
+    const char* text() const {
+        return _text;
+    }
+    /// The text of line number n, counting from 0, without its line ending
+    const char* line(int n) {
+        const char* start = _text;
+        for (; n > 0 && start != nullptr; n--) {
+            start = strchr(start, '\n');
+            if (start != nullptr) { start++; }
+        }
+        if (start == nullptr) { return ""; }
+        size_t len = strcspn(start, "\r\n");
+        memcpy(_line, start, len);
+        _line[len] = '\0';
+        return _line;
+    }
+
+ private:
+    char   _text[2048] = "";
+    char   _line[512];
+    size_t _length = 0;
+};
+
+#endif  // NATIVE_TESTS_TESTHELPERS_H_
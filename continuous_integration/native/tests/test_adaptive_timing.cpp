@@ -0,0 +1,110 @@
+/**
+ * @file test_adaptive_timing.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks that adaptive timing shortens the warm-up and stabilization
+ * times step by step to their floors, and falls back to the datasheet values
+ * after a failure or a disagreeing first reading.
+ */
+
+#include "TestHelpers.h"
+#include "AllocationCounter.h"
+#include "VariableArray.h"
+
+// The datasheet times; the steps are 10% and the floors 25% of them
+const uint32_t warmUp_ms        = 1000;
+const uint32_t stabilization_ms = 2000;
+
+ListSensor    listSensor("Timed", 22);
+Variable      result(&listSensor, 0, 3, "a", "meter", "result", nullptr);
+Variable*     variableList[] = {&result};
+VariableArray varArray(1, variableList);
+
+const float steady[]    = {10.0f, 10.1f, 9.9f};
+const float unsettled[] = {20.0f, 10.0f, 10.0f};
+
+// Runs an update and returns how long it took on the virtual clock
+static uint32_t timedUpdate() {
+    uint32_t start = millis();
+    varArray.completeUpdate();
+    return millis() - start;
+}
+
+static void testConverges() {
+    listSensor.setReadings(steady, 3);
+    uint32_t firstUpdate_ms = timedUpdate();
+    TEST_CHECK_EQUAL(listSensor.getWarmUpTime(), 900);
+    TEST_CHECK_EQUAL(listSensor.getStabilizationTime(), 1800);
+
+    uint32_t lastWarmUp_ms = listSensor.getWarmUpTime();
+    for (int i = 0; i < 10; i++) {
+        timedUpdate();
+        TEST_CHECK(listSensor.getWarmUpTime() <= lastWarmUp_ms);
+        lastWarmUp_ms = listSensor.getWarmUpTime();
+    }
+    TEST_CHECK_EQUAL(listSensor.getWarmUpTime(), 250);
+    TEST_CHECK_EQUAL(listSensor.getStabilizationTime(), 500);
+    // the update waits for the learned times; this sensor does nothing to
+    // wake, so both waits start at power on and the longer one sets the pace
+    TEST_CHECK(timedUpdate() + 1400 < firstUpdate_ms);
+}
+
+static void testFallsBackAfterFailure() {
+    listSensor.failing = true;
+    timedUpdate();
+    listSensor.failing = false;
+    TEST_CHECK_EQUAL(listSensor.getWarmUpTime(), warmUp_ms);
+    TEST_CHECK_EQUAL(listSensor.getStabilizationTime(), stabilization_ms);
+
+    // the times that failed aren't tried again
+    Sensor::LearnedTiming timing;
+    TEST_CHECK(listSensor.getLearnedTiming(timing));
+    TEST_CHECK_EQUAL(timing.warmUpFloor_ms, 350);
+    TEST_CHECK_EQUAL(timing.stabilizationFloor_ms, 700);
+    listSensor.setReadings(steady, 3);
+    for (int i = 0; i < 10; i++) { timedUpdate(); }
+    TEST_CHECK_EQUAL(listSensor.getWarmUpTime(), 350);
+    TEST_CHECK_EQUAL(listSensor.getStabilizationTime(), 700);
+}
+
+static void testFallsBackAfterDisagreement() {
+    // a first reading far from the later ones means the sensor wasn't stable,
+    // but it was warmed up
+    listSensor.setReadings(unsettled, 3);
+    timedUpdate();
+    TEST_CHECK_EQUAL(listSensor.getWarmUpTime(), warmUp_ms);
+    TEST_CHECK_EQUAL(listSensor.getStabilizationTime(), stabilization_ms);
+    Sensor::LearnedTiming timing;
+    TEST_CHECK(listSensor.getLearnedTiming(timing));
+    TEST_CHECK_EQUAL(timing.warmUpFloor_ms, 350);
+    TEST_CHECK_EQUAL(timing.stabilizationFloor_ms, 900);
+}
+
+static void testRestoreIsBounded() {
+    Sensor::LearnedTiming saved = {10, 99999, 0, 0};
+    TEST_CHECK(listSensor.setLearnedTiming(saved));
+    TEST_CHECK_EQUAL(listSensor.getWarmUpTime(), 250);
+    TEST_CHECK_EQUAL(listSensor.getStabilizationTime(), stabilization_ms);
+}
+
+int main() {
+    listSensor.setWarmUpTime(warmUp_ms);
+    listSensor.setStabilizationTime(stabilization_ms);
+    // without adaptive timing there is nothing to save or restore
+    Sensor::LearnedTiming timing;
+    TEST_CHECK(!listSensor.getLearnedTiming(timing));
+    {
+        AllocationCount allocations;
+        TEST_CHECK(listSensor.enableAdaptiveTiming());
+        TEST_CHECK_EQUAL(allocations.count(), 0);
+    }
+    varArray.begin();
+    TEST_CHECK(varArray.setupSensors());
+    testConverges();
+    testFallsBackAfterFailure();
+    testFallsBackAfterDisagreement();
+    testRestoreIsBounded();
+    return testResult();
+}
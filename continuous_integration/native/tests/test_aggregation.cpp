@@ -0,0 +1,113 @@
+/**
+ * @file test_aggregation.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks the median, trimmed mean, and MAD-filtered mean of the
+ * measurements to average, and that their values are kept in the sensor's
+ * own buffer.
+ */
+
+#include "TestHelpers.h"
+#include "AllocationCounter.h"
+#include "VariableArray.h"
+
+#include <math.h>
+
+ListSensor    listSensor("List");
+Variable      result(&listSensor, 0, 3, "a", "meter", "result", nullptr);
+Variable*     variableList[] = {&result};
+VariableArray varArray(1, variableList);
+
+// Aggregates the readings with the method and returns the result
+static float aggregate(MeasurementAggregation method, const float* readings,
+                       uint8_t count) {
+    listSensor.setReadings(readings, count);
+    TEST_CHECK(listSensor.setAggregationMethod(method));
+    varArray.completeUpdate();
+    return result.getValue();
+}
+
+static void testMedian() {
+    const float odd[] = {5.0f, 1.0f, 9.0f, 3.0f, 7.0f};
+    TEST_CHECK(aggregate(MeasurementAggregation::MEDIAN, odd, 5) == 5.0f);
+    // an even count averages the middle two
+    const float even[] = {4.0f, 1.0f, 3.0f, 2.0f};
+    TEST_CHECK(aggregate(MeasurementAggregation::MEDIAN, even, 4) == 2.5f);
+}
+
+static void testTrimmedMean() {
+    // a quarter is dropped from each end
+    const float eight[] = {100.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 1.0f};
+    TEST_CHECK(aggregate(MeasurementAggregation::TRIMMED_MEAN, eight, 8) ==
+               4.5f);
+    const float four[] = {10.0f, 1.0f, 3.0f, 2.0f};
+    TEST_CHECK(aggregate(MeasurementAggregation::TRIMMED_MEAN, four, 4) ==
+               2.5f);
+    // at least one from each end of three values, and none from two
+    const float three[] = {1.0f, 50.0f, 4.0f};
+    TEST_CHECK(aggregate(MeasurementAggregation::TRIMMED_MEAN, three, 3) ==
+               4.0f);
+    const float two[] = {1.0f, 3.0f};
+    TEST_CHECK(aggregate(MeasurementAggregation::TRIMMED_MEAN, two, 2) ==
+               2.0f);
+}
+
+static void testMadFilteredMean() {
+    // the median is 10.05 and the MAD 0.15, so only the spike is dropped
+    const float spiky[] = {10.0f, 10.2f, 9.8f, 50.0f, 10.1f, 9.9f};
+    float       mean = aggregate(MeasurementAggregation::MAD_FILTERED_MEAN,
+                                 spiky, 6);
+    TEST_CHECK(fabsf(mean - 10.0f) < 1e-5f);
+    // with a MAD of 0 only the values equal to the median are kept
+    const float flat[] = {5.0f, 5.0f, 6.0f, 5.0f};
+    TEST_CHECK(aggregate(MeasurementAggregation::MAD_FILTERED_MEAN, flat, 4) ==
+               5.0f);
+}
+
+static void testFewValues() {
+    const MeasurementAggregation methods[] = {
+        MeasurementAggregation::MEDIAN, MeasurementAggregation::TRIMMED_MEAN,
+        MeasurementAggregation::MAD_FILTERED_MEAN};
+    const float single[]   = {7.0f};
+    const float rejected[] = {MS_INVALID_VALUE, MS_INVALID_VALUE,
+                              MS_INVALID_VALUE};
+    const float mixed[]    = {MS_INVALID_VALUE, 4.0f, MS_INVALID_VALUE, 2.0f};
+    for (MeasurementAggregation method : methods) {
+        TEST_CHECK(aggregate(method, single, 1) == 7.0f);
+        // every value rejected leaves the result invalid
+        TEST_CHECK(aggregate(method, rejected, 3) == MS_INVALID_VALUE);
+        // only the valid values are aggregated
+        TEST_CHECK(aggregate(method, mixed, 4) == 3.0f);
+    }
+}
+
+static void testFixedBuffer() {
+    const float readings[MS_MAX_SAMPLES_TO_AGGREGATE + 1] = {};
+    AllocationCount allocations;
+    TEST_CHECK(aggregate(MeasurementAggregation::MEDIAN, readings,
+                         MS_MAX_SAMPLES_TO_AGGREGATE) == 0.0f);
+    TEST_CHECK_EQUAL(allocations.count(), 0);
+
+    // more values than fit use the mean
+    listSensor.setReadings(readings, MS_MAX_SAMPLES_TO_AGGREGATE + 1);
+    TEST_CHECK(listSensor.getAggregationMethod() ==
+               MeasurementAggregation::MEAN);
+    TEST_CHECK(!listSensor.setAggregationMethod(
+        MeasurementAggregation::TRIMMED_MEAN));
+    TEST_CHECK(listSensor.getAggregationMethod() ==
+               MeasurementAggregation::MEAN);
+    TEST_CHECK_EQUAL(allocations.count(), 0);
+}
+
+int main() {
+    varArray.begin();
+    TEST_CHECK(varArray.setupSensors());
+    testMedian();
+    testTrimmedMean();
+    testMadFilteredMean();
+    testFewValues();
+    testFixedBuffer();
+    return testResult();
+}
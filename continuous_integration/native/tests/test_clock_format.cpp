@@ -0,0 +1,140 @@
+/**
+ * @file test_clock_format.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks the cached ISO8601 formatter against gmtime() and times it
+ * against gmtime() and strftime().
+ */
+
+#include "TestHelpers.h"
+#include "ClockSupport.h"
+
+#include <time.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+
+static const time_t year2100 = 4102444800;
+
+static std::string reference(time_t t, int8_t offset) {
+    struct tm parts;
+    gmtime_r(&t, &parts);
+    char   text[40];
+    size_t len = strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &parts);
+    snprintf(text + len, sizeof(text) - len, "%c%02d:00",
+             offset < 0 ? '-' : '+', abs(offset));
+    return text;
+}
+
+static long mismatches = 0;
+
+static void check(time_t t, int8_t offset) {
+    char        buffer[loggerClock::ISO8601_BUFFER_SIZE];
+    uint8_t     len = loggerClock::formatDateTime_ISO8601(buffer, epochTime(t),
+                                                          offset);
+    std::string expected = reference(t, offset);
+    if (expected != buffer || len != expected.size()) {
+        if (mismatches++ < 10) {
+            printf("%lld at %+d is \"%s\", expected \"%s\"\n",
+                   static_cast<long long>(t), offset, buffer,
+                   expected.c_str());
+        }
+    }
+}
+
+static void testRandomTimes() {
+    std::mt19937                           rng(25);
+    std::uniform_int_distribution<int64_t> anyTime(0, year2100 - 1);
+    std::uniform_int_distribution<int>     anyOffset(-12, 14);
+    for (int i = 0; i < 500000; i++) {
+        check(static_cast<time_t>(anyTime(rng)),
+              static_cast<int8_t>(anyOffset(rng)));
+    }
+    TEST_CHECK_EQUAL(mismatches, 0);
+}
+
+// A publisher formats its buffered records in order, usually a few minutes
+// apart, so most of them are on the same day as the one before
+static void testConsecutiveTimes() {
+    mismatches = 0;
+    // across the end of a leap February, a year, and a century leap day
+    const time_t starts[] = {1709164800 - 3 * 86400, 1735689600 - 3 * 86400,
+                             951782400 - 3 * 86400};
+    const int    steps[]  = {1, 60, 300, 3599, 86399, 86400};
+    for (time_t start : starts) {
+        for (int step : steps) {
+            for (time_t t = start; t < start + 7 * 86400; t += step) {
+                check(t, -5);
+            }
+        }
+    }
+    // the same time again, and with a new offset
+    check(1735689600, -5);
+    check(1735689600, -5);
+    check(1735689600, 3);
+    check(1735689600, -5);
+    // backwards by a second and by a day
+    check(1735689599, -5);
+    check(1735689599 - 86400, 0);
+    TEST_CHECK_EQUAL(mismatches, 0);
+}
+
+static void testOtherEpochs() {
+    char unixTime[loggerClock::ISO8601_BUFFER_SIZE];
+    char y2k[loggerClock::ISO8601_BUFFER_SIZE];
+    loggerClock::formatDateTime_ISO8601(unixTime, epochTime(1735689600), 0);
+    loggerClock::formatDateTime_ISO8601(
+        y2k, epochTime(1735689600 - 946684800, epochStart::y2k_epoch), 0);
+    TEST_CHECK_STRING(y2k, unixTime);
+    TEST_CHECK_STRING(unixTime, "2025-01-01T00:00:00+00:00");
+
+    String text = loggerClock::formatDateTime_ISO8601(epochTime(1735689600),
+                                                      -5);
+    TEST_CHECK_STRING(text.c_str(), "2025-01-01T00:00:00-05:00");
+}
+
+// Formats a day of five minute records with the cache and with gmtime()
+static void benchmark() {
+    const time_t start = 1735689600;
+    char         buffer[40];
+    size_t       written = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 100; pass++) {
+        for (time_t t = start; t < start + 86400; t += 300) {
+            written += loggerClock::formatDateTime_ISO8601(
+                buffer, epochTime(t + pass * 86400), -5);
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 100; pass++) {
+        for (time_t t = start; t < start + 86400; t += 300) {
+            time_t    local = t + pass * 86400;
+            struct tm parts;
+            gmtime_r(&local, &parts);
+            written += strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S",
+                                &parts);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double count = 100.0 * 288;
+    printf("formatDateTime_ISO8601: %.1f ns per timestamp\n",
+           std::chrono::duration<double, std::nano>(middle - begin).count() /
+               count);
+    printf("gmtime and strftime:    %.1f ns per timestamp\n",
+           std::chrono::duration<double, std::nano>(end - middle).count() /
+               count);
+    TEST_CHECK(written > 0);
+}
+
+int main() {
+    testRandomTimes();
+    testConsecutiveTimes();
+    testOtherEpochs();
+    benchmark();
+    return testResult();
+}
@@ -0,0 +1,118 @@
+/**
+ * @file test_keller.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Measures a Keller sensor against a simulated Modbus slave, counting
+ * the transactions and bus time of each measurement, and decodes values from
+ * a register range.
+ */
+
+#include "TestHelpers.h"
+#include "VariableArray.h"
+#include "sensors/KellerAcculevel.h"
+
+const byte kellerAddress = 0x01;
+
+KellerAcculevel          acculevel(kellerAddress, Serial1, -1);
+KellerAcculevel_Pressure pressure(&acculevel, nullptr, "pressure");
+KellerAcculevel_Temp     temperature(&acculevel, nullptr, "temperature");
+KellerAcculevel_Height   height(&acculevel, nullptr, "height");
+Variable* variableList[] = {&pressure, &temperature, &height};
+VariableArray varArray(3, variableList);
+
+static void setReadings(float pressureBar, float temperatureC) {
+    modbusMaster::setFloatRegisters(kellerAddress, KELLER_P1_REGISTER,
+                                    pressureBar);
+    modbusMaster::setFloatRegisters(kellerAddress, KELLER_TOB1_REGISTER,
+                                    temperatureC);
+    // the registers between them hold other values
+    modbusMaster::setFloatRegisters(kellerAddress, 0x0004, 123.0f);
+    modbusMaster::setFloatRegisters(kellerAddress, 0x0006, 456.0f);
+}
+
+static void testBatchedRead() {
+    setReadings(0.5f, 15.0f);
+    modbusMaster::transactions = 0;
+    modbusMaster::busTime_us   = 0;
+    TEST_CHECK(varArray.completeUpdate());
+    TEST_CHECK_EQUAL(modbusMaster::transactions, 1);
+    TEST_CHECK(pressure.getValue() == 500.0f);
+    TEST_CHECK(temperature.getValue() == 15.0f);
+
+    float pressureBar = 0.5f;
+    float temperatureC = 15.0f;
+    keller driver;
+    TEST_CHECK(fabsf(height.getValue() -
+                     driver.calcWaterDepthM(pressureBar, temperatureC)) <
+               1e-6f);
+    TEST_CHECK(fabsf(height.getValue() - 5.1f) < 0.01f);
+    uint32_t batchedTime_us = modbusMaster::busTime_us;
+
+    // the driver reads the same two values in two transactions
+    driver.begin(Acculevel_kellerModel, kellerAddress, &Serial1);
+    modbusMaster::transactions = 0;
+    modbusMaster::busTime_us   = 0;
+    driver.getValues(pressureBar, temperatureC);
+    TEST_CHECK_EQUAL(modbusMaster::transactions, 2);
+    TEST_CHECK(pressureBar == 0.5f);
+    TEST_CHECK(temperatureC == 15.0f);
+
+    printf("Keller measurement at 9600 baud: 1 transaction, %.1f ms on the "
+           "bus; the driver's reads: 2 transactions, %.1f ms\n",
+           batchedTime_us / 1000.0, modbusMaster::busTime_us / 1000.0);
+    TEST_CHECK(batchedTime_us < modbusMaster::busTime_us);
+}
+
+static void testNoResponse() {
+    modbusMaster::respond = false;
+    TEST_CHECK(!varArray.completeUpdate());
+    TEST_CHECK(pressure.getValue() == MS_INVALID_VALUE);
+    TEST_CHECK(temperature.getValue() == MS_INVALID_VALUE);
+    TEST_CHECK(height.getValue() == MS_INVALID_VALUE);
+    modbusMaster::respond = true;
+
+    // a sensor reporting the error value fails the measurement too
+    setReadings(-9999.0f, 15.0f);
+    TEST_CHECK(!varArray.completeUpdate());
+    TEST_CHECK(pressure.getValue() == MS_INVALID_VALUE);
+    TEST_CHECK(height.getValue() == MS_INVALID_VALUE);
+}
+
+static void testRegisterRange() {
+    modbusMaster modbus;
+    modbus.begin(0x02, &Serial1);
+    modbusMaster::registers[std::make_pair(0x02, 10)] = 0xFFFE;
+    modbusMaster::registers[std::make_pair(0x02, 11)] = 0x0102;
+    modbusMaster::setFloatRegisters(0x02, 12, 2.5f);
+
+    ModbusRegisterRange range(modbus, 10, 13);
+    // nothing is decoded before the range is read
+    TEST_CHECK(range.getFloat(12) == MS_INVALID_VALUE);
+    modbusMaster::transactions = 0;
+    TEST_CHECK(range.read());
+    TEST_CHECK_EQUAL(modbusMaster::transactions, 1);
+    TEST_CHECK_EQUAL(range.getInt16(10), -2);
+    TEST_CHECK_EQUAL(range.getUint16(11), 0x0102);
+    TEST_CHECK_EQUAL(range.getUint16(11, littleEndian), 0x0201);
+    TEST_CHECK(range.getFloat(12) == 2.5f);
+    // a value running past either end of the range wasn't read
+    TEST_CHECK(range.getFloat(13) == MS_INVALID_VALUE);
+    TEST_CHECK(range.getFloat(9) == MS_INVALID_VALUE);
+    TEST_CHECK_EQUAL(range.getUint16(14), 0);
+
+    // more registers than one read may request are never sent
+    ModbusRegisterRange tooLong(modbus, 0, ModbusRegisterRange::MAX_REGISTERS);
+    TEST_CHECK(!tooLong.read());
+    TEST_CHECK_EQUAL(modbusMaster::transactions, 1);
+}
+
+int main() {
+    varArray.begin();
+    TEST_CHECK(varArray.setupSensors());
+    testBatchedRead();
+    testNoResponse();
+    testRegisterRange();
+    return testResult();
+}
@@ -0,0 +1,100 @@
+/**
+ * @file test_log_buffer.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks that every value read back from a LogBuffer prints exactly
+ * as the value that was added to it.
+ */
+
+#include "TestHelpers.h"
+#include "LogBuffer.h"
+#include "VariableBase.h"
+
+#include <random>
+
+static float noValue() {
+    return 0;
+}
+
+LogBuffer buffer;
+
+// Adds a value as a one-variable record and pops it back out
+static float roundTrip(float value) {
+    int record = buffer.addRecord(1);
+    buffer.setRecordValue(record, 0, value);
+    uint32_t timestamp;
+    float    stored = MS_INVALID_VALUE;
+    TEST_CHECK(buffer.popRecord(timestamp, &stored));
+    return stored;
+}
+
+static bool printsSame(Variable& variable, float value) {
+    char added[Variable::VALUE_BUFFER_SIZE];
+    char stored[Variable::VALUE_BUFFER_SIZE];
+    variable.formatValueChars(value, added);
+    variable.formatValueChars(roundTrip(value), stored);
+    if (strcmp(added, stored) != 0) {
+        printf("%.9g was added as %s but reads back as %s\n",
+               static_cast<double>(value), added, stored);
+        return false;
+    }
+    return true;
+}
+
+static void testReportedValues() {
+    Variable twoPlaces(noValue, 2, "v", "u", "v");
+    buffer.setNumVariables(1);
+    buffer.setVariableResolution(0, 2);
+
+    // These rounded the other way in float before being quantized
+    TEST_CHECK(printsSame(twoPlaces, 0.145f));
+    TEST_CHECK(printsSame(twoPlaces, 9.995f));
+    TEST_CHECK(printsSame(twoPlaces, -9.995f));
+    TEST_CHECK(printsSame(twoPlaces, 1.005f));
+
+    char text[Variable::VALUE_BUFFER_SIZE];
+    twoPlaces.formatValueChars(roundTrip(0.145f), text);
+    TEST_CHECK_STRING(text, "0.14");
+    twoPlaces.formatValueChars(roundTrip(9.995f), text);
+    TEST_CHECK_STRING(text, "9.99");
+
+    TEST_CHECK(roundTrip(MS_INVALID_VALUE) == MS_INVALID_VALUE);
+    TEST_CHECK(isnan(roundTrip(NAN)));
+    TEST_CHECK(roundTrip(1e20f) == 1e20f);
+}
+
+static void testRandomValues() {
+    std::mt19937 random(20250807);
+    for (uint8_t resolution = 0;
+         resolution <= LogBuffer::MAX_QUANTIZED_RESOLUTION; resolution++) {
+        Variable variable(noValue, resolution, "v", "u", "v");
+        buffer.setNumVariables(1);
+        buffer.setVariableResolution(0, resolution);
+
+        int mismatches = 0;
+        for (int i = 0; i < 200000; i++) {
+            // Random bit patterns cover every magnitude; values on a decimal
+            // step near a rounding tie are the ones most likely to differ
+            uint32_t bits = random();
+            float    value;
+            if (i % 2) {
+                memcpy(&value, &bits, sizeof(value));
+                if (isnan(value) || isinf(value)) { continue; }
+            } else {
+                float step = 1.0f / static_cast<float>(pow(10, resolution));
+                value      = (static_cast<float>(bits % 2000000) - 1000000) *
+                    step / 2;
+            }
+            if (!printsSame(variable, value)) { mismatches++; }
+        }
+        TEST_CHECK_EQUAL(mismatches, 0);
+    }
+}
+
+int main() {
+    testReportedValues();
+    testRandomValues();
+    return testResult();
+}
@@ -0,0 +1,77 @@
+/**
+ * @file test_logger_output.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks the CSV file header and data rows and that printing them
+ * doesn't allocate.
+ */
+
+#include "TestHelpers.h"
+#include "AllocationCounter.h"
+#include "LoggerBase.h"
+
+static float calculated() {
+    return 2.5f;
+}
+
+ScriptedSensor sensor("Scripted", 2);
+Variable  first(&sensor, 0, 2, "temperature", "degreeCelsius", "waterTemp",
+                "uuid-1");
+Variable  second(&sensor, 1, 1, "depth", "meter", "waterDepth", nullptr);
+Variable  ratio(calculated, 3, "ratio", "dimensionless", "ratio", "uuid-3");
+Variable* variableList[] = {&first, &second, &ratio};
+VariableArray varArray(3, variableList);
+
+Logger logger("native", "feature-uuid", 5, 10, -1, &varArray);
+
+static void testFileHeader() {
+    logger.setFileName("native_2025-01-01.csv");
+    Logger::setLoggerTimeZone(-5);
+    CaptureStream stream;
+    {
+        AllocationCount allocations;
+        logger.printFileHeader(&stream);
+        TEST_CHECK_EQUAL(allocations.count(), 0);
+    }
+    TEST_CHECK_STRING(stream.line(0), "Data Logger: native");
+    TEST_CHECK_STRING(stream.line(1), "Data Logger File: native_2025-01-01.csv");
+    TEST_CHECK_STRING(stream.line(2), "Sampling Feature UUID: feature-uuid,");
+    TEST_CHECK_STRING(stream.line(3),
+                      "\"Sensor Name:\",\"Scripted\",\"Scripted\","
+                      "\"Calculated\"");
+    TEST_CHECK_STRING(stream.line(4),
+                      "\"Variable Name:\",\"temperature\",\"depth\","
+                      "\"ratio\"");
+    TEST_CHECK_STRING(stream.line(5),
+                      "\"Result Unit:\",\"degreeCelsius\",\"meter\","
+                      "\"dimensionless\"");
+    TEST_CHECK_STRING(stream.line(6),
+                      "\"Result UUID:\",\"uuid-1\",\"\",\"uuid-3\"");
+    TEST_CHECK_STRING(stream.line(7),
+                      "\"Date and Time in UTC-5\",\"waterTemp\","
+                      "\"waterDepth\",\"ratio\"");
+}
+
+static void testDataRow() {
+    sensor.reading = 12.345f;
+    varArray.completeUpdate();
+    Logger::markedLocalUnixTime = 1735689600 + 3723;  // 2025-01-01 01:02:03
+    CaptureStream stream;
+    {
+        AllocationCount allocations;
+        logger.printVariableValuesCSV(&stream);
+        TEST_CHECK_EQUAL(allocations.count(), 0);
+    }
+    TEST_CHECK_STRING(stream.text(),
+                      "2025-01-01 01:02:03,12.35,13.3,2.500\r\n");
+}
+
+int main() {
+    varArray.begin();
+    TEST_CHECK(varArray.setupSensors());
+    testFileHeader();
+    testDataRow();
+    return testResult();
+}
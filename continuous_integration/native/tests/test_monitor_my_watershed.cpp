@@ -0,0 +1,225 @@
+/**
+ * @file test_monitor_my_watershed.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Publishes to a recording client, spooling to a directory standing in
+ * for the SD card while the client is offline, and times sending the buffer.
+ *
+ * This is built twice, the second time with the publisher sending chunked
+ * request bodies.
+ */
+
+#include "TestHelpers.h"
+#include "RecordingClient.h"
+#include "AllocationCounter.h"
+#include "LoggerBase.h"
+#include "publishers/MonitorMyWatershedPublisher.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+
+static float reading = 0;
+static float readingA() {
+    return reading;
+}
+static float readingB() {
+    return reading * 2;
+}
+
+Variable  varA(readingA, 2, "a", "meter", "a", "uuid-a");
+Variable  varB(readingB, 3, "b", "meter", "b", "uuid-b");
+Variable* variableList[] = {&varA, &varB};
+VariableArray varArray(2, variableList);
+
+Logger logger("native", "feature-uuid", 5, 10, -1, &varArray);
+
+// Exposes sending the buffer without logging another record
+class TestPublisher : public MonitorMyWatershedPublisher {
+ public:
+    TestPublisher() : MonitorMyWatershedPublisher(logger, "token", 1000, 0) {}
+    using MonitorMyWatershedPublisher::flushDataBuffer;
+};
+
+static const time_t firstRecord = 1735689600;  // 2025-01-01 00:00:00
+
+// Logs and publishes one record per five minutes
+static void logRecords(TestPublisher& publisher, RecordingClient& client,
+                       int count) {
+    for (int i = 0; i < count; i++) {
+        reading                     = static_cast<float>(i);
+        Logger::markedLocalUnixTime = firstRecord + 300 * i;
+        varArray.completeUpdate();
+        publisher.publishData(&client);
+    }
+}
+
+// The records in the buffer are sent before the older spooled ones, so this
+// compares the sorted timestamps; each record must be sent exactly once
+static bool sentEachRecordOnce(std::vector<std::string> posted, int count) {
+    std::sort(posted.begin(), posted.end());
+    if (posted.size() != static_cast<size_t>(count)) {
+        printf("%zu records were sent instead of %d\n", posted.size(), count);
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        char expected[loggerClock::ISO8601_BUFFER_SIZE];
+        Logger::formatDateTime_ISO8601(expected, firstRecord + 300 * i);
+        if (posted[i] != expected) {
+            printf("expected record %s but found %s\n", expected,
+                   posted[i].c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool spoolExists() {
+    File spool;
+    return spool.open("spool.bin", O_RDONLY);
+}
+
+static void testSpoolDrain() {
+    TestPublisher publisher;
+    publisher.setSpoolFileName("spool.bin");
+    RecordingClient client;
+
+    // offline long enough to spill the buffer to the spool several times
+    client.acceptConnections = false;
+    logRecords(publisher, client, 600);
+    TEST_CHECK(spoolExists());
+
+    // back online, every record is sent and the spool is removed
+    client.acceptConnections = true;
+    TEST_CHECK_EQUAL(publisher.flushDataBuffer(&client), 201);
+    TEST_CHECK(sentEachRecordOnce(client.postedTimestamps(), 600));
+    TEST_CHECK(!spoolExists());
+
+    // the values of the spooled and buffered records were kept
+    std::string sent;
+    for (const std::string& request : client.requests) { sent += request; }
+    TEST_CHECK(sent.find("\"uuid-a\":[0.00,1.00,2.00,") != std::string::npos);
+    TEST_CHECK(sent.find("\"uuid-b\":[0.000,2.000,4.000,") !=
+               std::string::npos);
+    TEST_CHECK(sent.find(",599.00]") != std::string::npos);
+    TEST_CHECK(sent.find(",1198.000]") != std::string::npos);
+}
+
+static void testSpoolReadFailure() {
+    TestPublisher publisher;
+    publisher.setSpoolFileName("spool.bin");
+    RecordingClient client;
+
+    client.acceptConnections = false;
+    logRecords(publisher, client, 300);
+    TEST_CHECK(spoolExists());
+
+    // the spool header is 5 bytes and each record 12; the read fails part
+    // way through the fourth spooled record
+    client.acceptConnections = true;
+    native::setSdReadLimit(5 + 12 * 3 + 6);
+    publisher.flushDataBuffer(&client);
+    native::setSdReadLimit(-1);
+
+    // the records read before the failure are sent and the rest are kept
+    size_t sentBeforeFailure = client.postedTimestamps().size();
+    TEST_CHECK(sentBeforeFailure > 0);
+    TEST_CHECK(spoolExists());
+
+    // a -1 means there was nothing left in the buffer to send
+    TEST_CHECK_EQUAL(publisher.flushDataBuffer(&client), -1);
+    TEST_CHECK(spoolExists());
+    TEST_CHECK_EQUAL(client.postedTimestamps().size(), sentBeforeFailure);
+
+    // the next record starts a new flush that drains the rest of the spool
+    Logger::markedLocalUnixTime = firstRecord + 300 * 300;
+    publisher.publishData(&client, true);
+    TEST_CHECK(sentEachRecordOnce(client.postedTimestamps(), 301));
+    TEST_CHECK(client.postedTimestamps().size() > sentBeforeFailure);
+    TEST_CHECK(!spoolExists());
+}
+
+// Keeps the recording out of the allocation count
+class QuietClient : public RecordingClient {
+ public:
+    int connect(const char* host, uint16_t port) override {
+        AllocationPause pause;
+        return RecordingClient::connect(host, port);
+    }
+    size_t write(uint8_t c) override {
+        AllocationPause pause;
+        return RecordingClient::write(c);
+    }
+    size_t write(const uint8_t* buf, size_t size) override {
+        AllocationPause pause;
+        return RecordingClient::write(buf, size);
+    }
+    using Print::write;
+};
+
+// Each request's body is framed by its Content-Length or its chunks
+static bool bodiesFramed(const RecordingClient& client) {
+    std::string body;
+    for (const std::string& request : client.requests) {
+        if (!RecordingClient::decodeBody(request, body)) {
+            printf("A request's body doesn't match its framing:\n%s\n",
+                   request.c_str());
+            return false;
+        }
+        if (body.front() != '{' || body.back() != '}') { return false; }
+    }
+    return true;
+}
+
+// Buffers records and times sending them, counting the allocations made
+static void benchmarkFlush() {
+    const int     recordsPerFlush = 50;
+    const int     flushes         = 200;
+    TestPublisher publisher;
+    QuietClient   client;
+    size_t        allocations = 0;
+    double        seconds     = 0;
+    for (int flush = 0; flush < flushes; flush++) {
+        for (int i = 0; i < recordsPerFlush; i++) {
+            reading                     = i * 1.375f - 20;
+            Logger::markedLocalUnixTime = firstRecord + 300 * i;
+            varArray.completeUpdate();
+            publisher.publishData(&client);
+        }
+        AllocationCount count;
+        auto            start = std::chrono::steady_clock::now();
+        TEST_CHECK_EQUAL(publisher.flushDataBuffer(&client), 201);
+        seconds += std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+        allocations += count.count();
+    }
+    TEST_CHECK_EQUAL(client.postedTimestamps().size(),
+                     recordsPerFlush * flushes);
+    TEST_CHECK(bodiesFramed(client));
+    TEST_CHECK_EQUAL(allocations, 0);
+    printf("flushDataBuffer%s: %.0f bytes/s, %.1f allocations per flush of "
+           "%d records (%zu bytes)\n",
+           MS_MMW_USE_CHUNKED_TRANSFER ? " (chunked)" : "",
+           client.bytesSent / seconds,
+           static_cast<double>(allocations) / flushes, recordsPerFlush,
+           client.bytesSent / flushes);
+}
+
+int main() {
+    char directory[] = "/tmp/ms_native_sdXXXXXX";
+    TEST_CHECK(mkdtemp(directory) != nullptr);
+    native::setSdDirectory(directory);
+
+    varArray.begin();
+    testSpoolDrain();
+    testSpoolReadFailure();
+    benchmarkFlush();
+
+    rmdir(directory);
+    return testResult();
+}
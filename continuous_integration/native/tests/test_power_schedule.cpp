@@ -0,0 +1,285 @@
+/**
+ * @file test_power_schedule.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks the simulated timing of a complete update against the order
+ * and times the sensors actually finish in.
+ *
+ * Also checks that optimizeSensorOrder() groups the sensors by power pin and
+ * that printPowerPinReport() compares each pin's predicted and achieved
+ * on-time.
+ *
+ * The test is built twice, the second time with the variable array idling
+ * between sensor events, to check that idling doesn't miss or delay any of
+ * them.
+ */
+
+#include "TestHelpers.h"
+#include "VariableArray.h"
+
+/**
+ * @brief A sensor that actively wakes and starts its measurements, as the
+ * update simulation assumes, and records when it was woken, put to sleep,
+ * and polled.
+ */
+class TimedSensor : public ScriptedSensor {
+ public:
+    TimedSensor(const char* name, uint32_t warmUpTime_ms,
+                uint32_t stabilizationTime_ms, uint32_t measurementTime_ms,
+                uint8_t measurements, int8_t powerPin)
+        : ScriptedSensor(name, 1, warmUpTime_ms, measurementTime_ms,
+                         powerPin) {
+        setStabilizationTime(stabilizationTime_ms);
+        setNumberMeasurementsToAverage(measurements);
+    }
+
+    bool wake() override {
+        if (!Sensor::wake()) { return false; }
+        _millisSensorActivated = millis();
+        wokeAt                 = _millisSensorActivated;
+        return true;
+    }
+    bool startSingleMeasurement() override {
+        if (!Sensor::startSingleMeasurement()) { return false; }
+        _millisMeasurementRequested = millis();
+        return true;
+    }
+    bool sleep() override {
+        finishedAt  = millis();
+        finishOrder = ++finishCount;
+        // like a sensor put to sleep by a command, it has to be woken again
+        _millisSensorActivated      = 0;
+        _millisMeasurementRequested = 0;
+        clearStatusBits(WAKE_ATTEMPTED, WAKE_SUCCESSFUL, MEASUREMENT_ATTEMPTED,
+                        MEASUREMENT_SUCCESSFUL);
+        return true;
+    }
+
+    bool isWarmedUp() override {
+        polls++;
+        return Sensor::isWarmedUp();
+    }
+    bool isStable() override {
+        polls++;
+        return Sensor::isStable();
+    }
+    bool isMeasurementComplete() override {
+        polls++;
+        return Sensor::isMeasurementComplete();
+    }
+
+    uint32_t   wokeAt      = 0;
+    uint32_t   finishedAt  = 0;
+    int        finishOrder = 0;
+    static int finishCount;
+    static int polls;
+};
+int TimedSensor::finishCount = 0;
+int TimedSensor::polls       = 0;
+
+// Listed so that none of them finish in list order.  The two sensors on pin
+// 30 keep it on until the slower one finishes.
+TimedSensor alone("Alone", 200, 100, 250, 2, 31);
+TimedSensor fastShared("FastShared", 100, 0, 300, 1, 30);
+TimedSensor unpowered("Unpowered", 0, 0, 100, 3, -1);
+TimedSensor slowShared("SlowShared", 1000, 500, 200, 2, 30);
+
+Variable  aloneValue(&alone, 0, 1, "a", "meter", "alone", nullptr);
+Variable  fastValue(&fastShared, 0, 1, "b", "meter", "fastShared", nullptr);
+Variable  unpoweredValue(&unpowered, 0, 1, "c", "meter", "unpowered", nullptr);
+Variable  slowValue(&slowShared, 0, 1, "d", "meter", "slowShared", nullptr);
+Variable* variableList[] = {&aloneValue, &fastValue, &unpoweredValue,
+                            &slowValue};
+VariableArray varArray(4, variableList);
+
+TimedSensor* sensors[] = {&alone, &fastShared, &unpowered, &slowShared};
+
+// Runs a complete update and returns when it started
+static uint32_t timedUpdate() {
+    TimedSensor::finishCount = 0;
+    TimedSensor::polls       = 0;
+    uint32_t start           = millis();
+    TEST_CHECK(varArray.completeUpdate());
+    return start;
+}
+
+static void testSimulatedUpdate() {
+    CaptureStream stream;
+    TEST_CHECK_EQUAL(varArray.simulateCompleteUpdate(&stream), 1900);
+    TEST_CHECK_EQUAL(varArray.simulateCompleteUpdate(), 1900);
+
+    TEST_CHECK_STRING(stream.line(0), "Simulated update of 4 sensors:");
+    TEST_CHECK_STRING(stream.line(1), "  0 Alone at scripted finished at 800 "
+                                      "ms, powered 800 ms, idle 0 ms");
+    // the faster sensor on the shared pin waits for the slower one
+    TEST_CHECK_STRING(stream.line(2),
+                      "  1 FastShared at scripted finished at 400 ms, "
+                      "powered 1900 ms, idle 1500 ms");
+    TEST_CHECK_STRING(stream.line(3), "  2 Unpowered at scripted finished at "
+                                      "300 ms, always powered");
+    TEST_CHECK_STRING(stream.line(4),
+                      "  3 SlowShared at scripted finished at 1900 ms, "
+                      "powered 1900 ms, idle 0 ms");
+    TEST_CHECK_STRING(stream.line(5), "  Power pin 31 on for 800 ms");
+    TEST_CHECK_STRING(stream.line(6), "  Power pin 30 on for 1900 ms");
+    TEST_CHECK_STRING(stream.line(7), "Total predicted awake time: 1900 ms");
+}
+
+static void testPredictedOrder() {
+    uint32_t start = timedUpdate();
+
+    // the sensors finish in the simulated order, each no earlier than
+    // predicted and not long after
+    const uint32_t predicted[] = {800, 400, 300, 1900};
+    const int      order[]     = {3, 2, 1, 4};
+    for (uint8_t i = 0; i < 4; i++) {
+        uint32_t finished = sensors[i]->finishedAt - start;
+        printf("%s finished at %u ms, predicted %u ms\n",
+               sensors[i]->getSensorName().c_str(),
+               static_cast<unsigned>(finished),
+               static_cast<unsigned>(predicted[i]));
+        TEST_CHECK_EQUAL(sensors[i]->finishOrder, order[i]);
+        TEST_CHECK(finished >= predicted[i]);
+        TEST_CHECK(finished < predicted[i] + 100);
+    }
+    TEST_CHECK(aloneValue.getValue() == 10.0f);
+    TEST_CHECK(slowValue.getValue() == 10.0f);
+}
+
+static void testIdleBetweenEvents() {
+    uint32_t start = timedUpdate();
+    printf("%d sensor polls in a %u ms update\n", TimedSensor::polls,
+           static_cast<unsigned>(slowShared.finishedAt - start));
+
+    // each sensor is woken as soon as it has warmed up
+    for (TimedSensor* sensor : sensors) {
+        uint32_t woke = sensor->wokeAt - start;
+        TEST_CHECK(woke >= sensor->getWarmUpTime());
+        TEST_CHECK(woke < sensor->getWarmUpTime() + 50);
+    }
+#if MS_VARIABLEARRAY_IDLE_BETWEEN_EVENTS
+    // the sensors are only polled once something is due
+    TEST_CHECK(TimedSensor::polls < 100);
+#else
+    // without idling, every pass of the loop polls the unfinished sensors
+    TEST_CHECK(TimedSensor::polls > 100);
+#endif
+
+    // a long wait is broken into idles of no more than the cap
+    TimedSensor  sluggish("Sluggish", 3 * MS_VARIABLEARRAY_MAX_IDLE_MS + 500,
+                          0, 0, 1, 32);
+    Variable     sluggishValue(&sluggish, 0, 1, "e", "meter", "sluggish",
+                               nullptr);
+    Variable*    sluggishList[] = {&sluggishValue};
+    VariableArray sluggishArray(1, sluggishList);
+    sluggishArray.begin();
+    TimedSensor::polls = 0;
+    start              = millis();
+    TEST_CHECK(sluggishArray.completeUpdate());
+    TEST_CHECK(sluggish.wokeAt - start >= sluggish.getWarmUpTime());
+    TEST_CHECK(sluggish.wokeAt - start < sluggish.getWarmUpTime() + 50);
+#if MS_VARIABLEARRAY_IDLE_BETWEEN_EVENTS
+    TEST_CHECK(TimedSensor::polls >= 4);
+    TEST_CHECK(TimedSensor::polls < 10);
+#endif
+}
+
+// The name of the sensor at a position in the array's sensor list, as listed
+// by the simulation report
+static const char* listedSensor(VariableArrayBase& array, uint8_t position) {
+    static char   name[32];
+    CaptureStream stream;
+    array.simulateCompleteUpdate(&stream);
+    const char* line  = stream.line(position + 1);
+    const char* start = strchr(line + 2, ' ');
+    const char* end   = strstr(line, " at ");
+    name[0]           = '\0';
+    if (start != nullptr && end != nullptr && end > start) {
+        size_t len = min(static_cast<size_t>(end - start - 1),
+                         sizeof(name) - 1);
+        memcpy(name, start + 1, len);
+        name[len] = '\0';
+    }
+    return name;
+}
+
+static void testOptimizedOrder() {
+    // the shared pin's group goes first, its slowest sensor leading
+    varArray.optimizeSensorOrder();
+    TEST_CHECK_STRING(listedSensor(varArray, 0), "SlowShared");
+    TEST_CHECK_STRING(listedSensor(varArray, 1), "FastShared");
+    TEST_CHECK_STRING(listedSensor(varArray, 2), "Alone");
+    TEST_CHECK_STRING(listedSensor(varArray, 3), "Unpowered");
+    // only the order changed
+    TEST_CHECK_EQUAL(varArray.simulateCompleteUpdate(), 1900);
+    TEST_CHECK(varArray.arrayOfVars[0] == &aloneValue);
+
+    // sensors chained through a secondary pin are one group, and groups with
+    // the same latency keep their order
+    TimedSensor quick("Quick", 0, 0, 50, 1, 41);
+    TimedSensor middle("Middle", 0, 0, 300, 1, 50);
+    TimedSensor bridge("Bridge", 0, 0, 100, 1, 40);
+    TimedSensor tied("Tied", 100, 0, 200, 1, 60);
+    TimedSensor slowest("Slowest", 0, 0, 600, 1, 40);
+    bridge.setSecondaryPowerPin(41);
+    Variable  quickValue(&quick, 0, 1, "f", "meter", "quick", nullptr);
+    Variable  middleValue(&middle, 0, 1, "g", "meter", "middle", nullptr);
+    Variable  bridgeValue(&bridge, 0, 1, "h", "meter", "bridge", nullptr);
+    Variable  tiedValue(&tied, 0, 1, "i", "meter", "tied", nullptr);
+    Variable  slowestValue(&slowest, 0, 1, "j", "meter", "slowest", nullptr);
+    Variable* chainList[] = {&quickValue, &middleValue, &bridgeValue,
+                             &tiedValue, &slowestValue};
+    VariableArray chainArray(5, chainList);
+    chainArray.begin();
+    chainArray.optimizeSensorOrder();
+    TEST_CHECK_STRING(listedSensor(chainArray, 0), "Slowest");
+    TEST_CHECK_STRING(listedSensor(chainArray, 1), "Bridge");
+    TEST_CHECK_STRING(listedSensor(chainArray, 2), "Quick");
+    TEST_CHECK_STRING(listedSensor(chainArray, 3), "Middle");
+    TEST_CHECK_STRING(listedSensor(chainArray, 4), "Tied");
+}
+
+static void testPowerPinReport() {
+    // reordering forgets the power times of the last update
+    CaptureStream stream;
+    varArray.printPowerPinReport(&stream);
+    TEST_CHECK_STRING(stream.line(0), "Power pin 30 predicted on for 1900 ms, "
+                                      "achieved not cut by the last update");
+    TEST_CHECK_STRING(stream.line(1), "Power pin 31 predicted on for 800 ms, "
+                                      "achieved not cut by the last update");
+
+    timedUpdate();
+    stream.clear();
+    varArray.printPowerPinReport(&stream);
+    printf("%s", stream.text());
+    const int      pins[]      = {30, 31};
+    const uint32_t predicted[] = {1900, 800};
+    for (uint8_t p = 0; p < 2; p++) {
+        int      pin = -1;
+        unsigned predictedOn = 0, achievedOn = 0;
+        TEST_CHECK_EQUAL(sscanf(stream.line(p),
+                                "Power pin %d predicted on for %u ms, "
+                                "achieved %u ms",
+                                &pin, &predictedOn, &achievedOn),
+                         3);
+        TEST_CHECK_EQUAL(pin, pins[p]);
+        TEST_CHECK_EQUAL(predictedOn, predicted[p]);
+        // the shared pin stays on until its slower sensor is done
+        TEST_CHECK(achievedOn >= predicted[p]);
+        TEST_CHECK(achievedOn < predicted[p] + 100);
+    }
+    TEST_CHECK_STRING(stream.line(2), "");
+}
+
+int main() {
+    varArray.begin();
+    TEST_CHECK(varArray.setupSensors());
+    testSimulatedUpdate();
+    testPredictedOrder();
+    testIdleBetweenEvents();
+    testOptimizedOrder();
+    testPowerPinReport();
+    return testResult();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file test_sampling_rules.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks the logging interval the sampling rules pick after each
+ * record.
+ */
+
+#include "TestHelpers.h"
+#include "LoggerBase.h"
+
+static float level = 0;
+static float readLevel() {
+    return level;
+}
+
+Variable  stage(readLevel, 3, "gaugeHeight", "meter", "stage", nullptr);
+Variable* variableList[] = {&stage};
+VariableArray varArray(1, variableList);
+
+// Exposes checking the rules without logging a record
+class TestLogger : public Logger {
+ public:
+    TestLogger() : Logger("native", 15, -1, -1, &varArray) {}
+    using Logger::evaluateSamplingRules;
+};
+TestLogger logger;
+
+static const uint32_t firstRecord = 1735689600;  // 2025-01-01 00:00:00
+
+// Logs a value at a time and returns the interval until the next record
+static int16_t record(float value, uint32_t time) {
+    level = value;
+    stage.getValue(true);
+    Logger::markedLocalUnixTime = time;
+    logger.evaluateSamplingRules();
+    return logger.getActiveLoggingInterval();
+}
+
+static void testAbove() {
+    logger.clearSamplingRules();
+    TEST_CHECK(logger.addSamplingRule(&stage, SamplingTrigger::ABOVE, 1.2f,
+                                      0.1f, 1));
+    TEST_CHECK_EQUAL(record(1.0f, firstRecord), 15);
+    TEST_CHECK_EQUAL(record(1.2f, firstRecord + 900), 15);
+    TEST_CHECK_EQUAL(record(1.3f, firstRecord + 1800), 1);
+    // stays active until it's back below the threshold by the hysteresis
+    TEST_CHECK_EQUAL(record(1.15f, firstRecord + 1860), 1);
+    TEST_CHECK_EQUAL(record(1.05f, firstRecord + 1920), 15);
+    // a missing value keeps the rule's state
+    record(1.5f, firstRecord + 2820);
+    TEST_CHECK_EQUAL(record(MS_INVALID_VALUE, firstRecord + 2880), 1);
+}
+
+static void testBelow() {
+    logger.clearSamplingRules();
+    TEST_CHECK_EQUAL(logger.getActiveLoggingInterval(), 15);
+    // a longer interval while the stream is dry
+    TEST_CHECK(logger.addSamplingRule(&stage, SamplingTrigger::BELOW, 0.2f,
+                                      0.05f, 60));
+    TEST_CHECK_EQUAL(record(0.5f, firstRecord), 15);
+    TEST_CHECK_EQUAL(record(0.1f, firstRecord + 900), 60);
+    TEST_CHECK_EQUAL(record(0.24f, firstRecord + 4500), 60);
+    TEST_CHECK_EQUAL(record(0.3f, firstRecord + 8100), 15);
+}
+
+static void testRiseRate() {
+    logger.clearSamplingRules();
+    TEST_CHECK(logger.addSamplingRule(&stage, SamplingTrigger::RISE_RATE,
+                                      0.05f, 0.02f, 5));
+    // the first record has no previous value to give a rate, however high
+    // it is
+    TEST_CHECK_EQUAL(record(100.0f, firstRecord), 15);
+    TEST_CHECK_EQUAL(record(100.0f, firstRecord + 900), 15);
+    // 0.08 m per hour
+    TEST_CHECK_EQUAL(record(100.02f, firstRecord + 1800), 5);
+    // 0.04 m per hour is within the hysteresis
+    TEST_CHECK_EQUAL(record(100.025f, firstRecord + 2250), 5);
+    // 0.01 m per hour
+    TEST_CHECK_EQUAL(record(100.03f, firstRecord + 4050), 15);
+    // falling doesn't count
+    TEST_CHECK_EQUAL(record(99.0f, firstRecord + 4950), 15);
+
+    // a missing value starts over without a previous value
+    TEST_CHECK_EQUAL(record(MS_INVALID_VALUE, firstRecord + 5850), 15);
+    TEST_CHECK_EQUAL(record(105.0f, firstRecord + 6750), 15);
+    TEST_CHECK_EQUAL(record(106.0f, firstRecord + 7650), 5);
+}
+
+static void testFallRate() {
+    logger.clearSamplingRules();
+    TEST_CHECK(logger.addSamplingRule(&stage, SamplingTrigger::FALL_RATE,
+                                      0.1f, 0.05f, 5));
+    TEST_CHECK_EQUAL(record(-3.0f, firstRecord), 15);
+    // rising doesn't count
+    TEST_CHECK_EQUAL(record(-2.0f, firstRecord + 900), 15);
+    // 0.2 m per hour
+    TEST_CHECK_EQUAL(record(-2.1f, firstRecord + 2700), 5);
+    // 0.08 m per hour is within the hysteresis
+    TEST_CHECK_EQUAL(record(-2.12f, firstRecord + 3600), 5);
+    // 0.04 m per hour
+    TEST_CHECK_EQUAL(record(-2.13f, firstRecord + 4500), 15);
+    // the same time again gives no rate, so the rule keeps its state
+    TEST_CHECK_EQUAL(record(-9.0f, firstRecord + 4500), 15);
+}
+
+static void testShortestInterval() {
+    logger.clearSamplingRules();
+    logger.addSamplingRule(&stage, SamplingTrigger::ABOVE, 1.0f, 0, 10);
+    logger.addSamplingRule(&stage, SamplingTrigger::ABOVE, 2.0f, 0, 1);
+    TEST_CHECK_EQUAL(record(1.5f, firstRecord), 10);
+    TEST_CHECK_EQUAL(record(2.5f, firstRecord + 600), 1);
+    // capped by the minimum interval
+    logger.setMinimumLoggingInterval(2);
+    TEST_CHECK_EQUAL(logger.getActiveLoggingInterval(), 2);
+    logger.setMinimumLoggingInterval(1);
+
+    // no more rules than there is room for
+    for (int i = 2; i < MS_LOGGER_MAX_SAMPLING_RULES; i++) {
+        TEST_CHECK(
+            logger.addSamplingRule(&stage, SamplingTrigger::BELOW, 0, 0, 5));
+    }
+    TEST_CHECK(
+        !logger.addSamplingRule(&stage, SamplingTrigger::BELOW, 0, 0, 5));
+    TEST_CHECK(
+        !logger.addSamplingRule(nullptr, SamplingTrigger::BELOW, 0, 0, 5));
+
+    logger.clearSamplingRules();
+    TEST_CHECK_EQUAL(logger.getActiveLoggingInterval(), 15);
+}
+
+int main() {
+    varArray.begin();
+    testAbove();
+    testBelow();
+    testRiseRate();
+    testFallRate();
+    testShortestInterval();
+    return testResult();
+}
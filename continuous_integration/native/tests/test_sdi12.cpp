@@ -0,0 +1,361 @@
+/**
+ * @file test_sdi12.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Runs concurrent SDI-12 measurements against sensors answered by the
+ * test, including measurements batched across the sensors on a pin, and fuzzes
+ * and times the response parser.
+ */
+
+#include "TestHelpers.h"
+#include "AllocationCounter.h"
+#include "VariableArray.h"
+#include "sensors/SDI12Sensors.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Exposes the response helpers
+class TestSDI12Sensor : public SDI12Sensors {
+ public:
+    TestSDI12Sensor(char address, uint32_t measurementTime_ms,
+                    int8_t dataPin = 5, int8_t powerPin = -1)
+        : SDI12Sensors(address, powerPin, dataPin, 1, "TestSDI12", 1, 0, 0,
+                       measurementTime_ms) {}
+    using SDI12Sensors::checkSDI12CRC;
+    using SDI12Sensors::parseSDI12Values;
+};
+
+TestSDI12Sensor slowSDI('1', 1000);
+TestSDI12Sensor quickSDI('2', 1500);
+
+// A second pin, with a sensor that starts the batch and one batched with it
+TestSDI12Sensor leaderSDI('A', 1000, 7);
+TestSDI12Sensor peerSDI('B', 1000, 7, 30);
+
+Variable  slowValue(&slowSDI, 0, 2, "a", "meter", "slow", nullptr);
+Variable  quickValue(&quickSDI, 0, 2, "b", "meter", "quick", nullptr);
+Variable* variableList[] = {&slowValue, &quickValue};
+VariableArray varArray(2, variableList);
+Variable      peerValue(&peerSDI, 0, 2, "c", "meter", "peer", nullptr);
+Variable*     peerList[] = {&peerValue};
+VariableArray peerArray(1, peerList);
+
+// The wait in seconds each sensor returns from a start measurement command
+static std::map<char, std::string> startReplies = {
+    {'1', "500"}, {'2', "000"}, {'A', "001"}, {'B', "005"}};
+// The time each sensor was last asked for its start and data
+static std::map<char, uint32_t> startedAt;
+static std::map<char, uint32_t> dataRequestedAt;
+
+// The SDI-12 CRC-16, worked out bit by bit
+static std::string withCRC(std::string response) {
+    uint16_t crc = 0;
+    for (char c : response) {
+        crc ^= static_cast<uint8_t>(c);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    response += static_cast<char>(0x40 | (crc >> 12));
+    response += static_cast<char>(0x40 | ((crc >> 6) & 0x3F));
+    response += static_cast<char>(0x40 | (crc & 0x3F));
+    return response;
+}
+
+static std::string reply(const std::string& command) {
+    // The simulated sensors' allocations aren't the library's
+    AllocationPause pause;
+    char        address = command[0];
+    std::string body    = command.substr(1, command.size() - 2);
+    if (body.empty()) { return std::string(1, address) + "\r\n"; }
+    if (body == "I") {
+        return std::string(1, address) + "14VENDOR  MODEL 100SN\r\n";
+    }
+    if (body == "C" || body == "CC") {
+        startedAt[address] = millis();
+        return std::string(1, address) + startReplies[address] + "01\r\n";
+    }
+    if (body == "D0") {
+        dataRequestedAt[address] = millis();
+        return withCRC(std::string(1, address) + "+1.25") + "\r\n";
+    }
+    return "";
+}
+
+static void testLongConcurrentWait() {
+    // a wait of more than 127 seconds used to wrap to a failed start
+    TEST_CHECK(varArray.completeUpdate());
+    TEST_CHECK(slowValue.getValue() == 1.25f);
+    TEST_CHECK(dataRequestedAt['1'] - startedAt['1'] > 500000);
+
+    // a sensor returning no wait still gets its measurement time
+    TEST_CHECK(quickValue.getValue() == 1.25f);
+    TEST_CHECK(dataRequestedAt['2'] - startedAt['2'] > 1500);
+
+    // the longest wait the protocol allows
+    startReplies['1'] = "999";
+    TEST_CHECK(varArray.completeUpdate());
+    TEST_CHECK(slowValue.getValue() == 1.25f);
+    TEST_CHECK(dataRequestedAt['1'] - startedAt['1'] > 999000);
+}
+
+// The number of start measurement commands sent to a sensor
+static int countStarts(char address) {
+    int starts = 0;
+    for (const std::string& command : SDI12::commands) {
+        if (command == std::string(1, address) + "C!" ||
+            command == std::string(1, address) + "CC!") {
+            starts++;
+        }
+    }
+    return starts;
+}
+
+// Starts an update of both sensors on the second pin, as the variable array
+// does, and has the leader start a measurement batched with the peer
+static void startBatch() {
+    leaderSDI.clearMeasurementStatus();
+    leaderSDI.resetMeasurementCounts();
+    peerSDI.clearMeasurementStatus();
+    peerSDI.resetMeasurementCounts();
+    leaderSDI.powerUp();
+    peerSDI.powerUp();
+    leaderSDI.wake();
+    peerSDI.wake();
+    TEST_CHECK(leaderSDI.startSingleMeasurement());
+}
+
+static void testBatchReuse() {
+    SDI12::commands.clear();
+    startBatch();
+    TEST_CHECK_EQUAL(countStarts('A'), 1);
+    TEST_CHECK_EQUAL(countStarts('B'), 1);
+
+    // the peer uses the measurement started with the leader's
+    delay(2000);
+    TEST_CHECK(peerSDI.startSingleMeasurement());
+    TEST_CHECK_EQUAL(countStarts('B'), 1);
+    // and waits out the 5 s it returned from the batch start, not its own
+    // measurement time from now
+    uint32_t toNext = peerSDI.getMillisToNextEvent();
+    TEST_CHECK(toNext > 2900 && toNext <= 3001);
+    TEST_CHECK(!peerSDI.isMeasurementComplete());
+    delay(toNext);
+    TEST_CHECK(peerSDI.isMeasurementComplete());
+    TEST_CHECK(peerSDI.addSingleMeasurementResult());
+    TEST_CHECK(leaderSDI.addSingleMeasurementResult());
+    TEST_CHECK(peerSDI.sensorValues[0] == 1.25f);
+}
+
+static void testPeerWokenAfterBatch() {
+    SDI12::commands.clear();
+    startBatch();
+    // the peer is power cycled after the batch started, so the measurement
+    // the leader started was lost
+    peerSDI.powerDown();
+    delay(100);
+    peerSDI.powerUp();
+    peerSDI.wake();
+    TEST_CHECK(peerSDI.startSingleMeasurement());
+    TEST_CHECK_EQUAL(countStarts('B'), 2);
+    TEST_CHECK(peerSDI.getMillisToNextEvent() > 4900);
+    peerSDI.powerDown();
+}
+
+static void testStaleBatch() {
+    SDI12::commands.clear();
+    // the peer is batched but isn't measured in this update, and stays
+    // powered and awake
+    startBatch();
+    delay(10000);
+    // its next update starts its own measurement
+    TEST_CHECK(peerArray.completeUpdate(false, false, false, false));
+    TEST_CHECK_EQUAL(countStarts('B'), 2);
+    TEST_CHECK(peerValue.getValue() == 1.25f);
+    TEST_CHECK(dataRequestedAt['B'] - startedAt['B'] > 5000);
+}
+
+static void testMeasurementAllocations() {
+    startReplies['1'] = "002";
+    SDI12::commands.clear();
+    SDI12::commands.reserve(100);
+    AllocationCount allocations;
+    TEST_CHECK(varArray.completeUpdate());
+    TEST_CHECK_EQUAL(allocations.count(), 0);
+    TEST_CHECK(slowValue.getValue() == 1.25f);
+    TEST_CHECK(quickValue.getValue() == 1.25f);
+}
+
+// An independent parser: split the values at their signs and read each with
+// strtof(); -1 for a character or value that isn't allowed
+static int referenceParse(const std::string& response,
+                          std::vector<float>& results, size_t maxResults,
+                          std::vector<uint8_t>& digits) {
+    results.clear();
+    digits.clear();
+    if (response.find_first_not_of("+-.0123456789") != std::string::npos) {
+        return -1;
+    }
+    size_t start = 0;
+    while (start < response.size()) {
+        size_t      end   = response.find_first_of("+-", start + 1);
+        std::string value = response.substr(start, end - start);
+        start             = end == std::string::npos ? response.size() : end;
+
+        std::string body = value[0] == '+' || value[0] == '-' ? value.substr(1)
+                                                               : value;
+        size_t nDigits = body.size() -
+            std::count(body.begin(), body.end(), '.');
+        if (nDigits == 0 || nDigits > 9 ||
+            std::count(body.begin(), body.end(), '.') > 1 ||
+            body.find_first_of("+-") != std::string::npos) {
+            return -1;
+        }
+        float result = strtof(value.c_str(), nullptr);
+        if (result == MS_INVALID_VALUE) continue;
+        if (results.size() < maxResults) {
+            results.push_back(result);
+            digits.push_back(static_cast<uint8_t>(nDigits));
+        }
+    }
+    return static_cast<int>(results.size());
+}
+
+// A data response with random values, sometimes damaged
+static std::string randomResponse(std::mt19937& rng) {
+    std::string response;
+    int         nValues = rng() % 13;
+    for (int v = 0; v < nValues; v++) {
+        if (rng() % 10 == 0) {
+            response += "-9999";
+            continue;
+        }
+        if (v > 0 || rng() % 10 != 0) { response += rng() % 2 ? '+' : '-'; }
+        int         nDigits = rng() % 4 == 0 ? 1 + rng() % 9 : 1 + rng() % 7;
+        std::string number;
+        for (int d = 0; d < nDigits; d++) { number += '0' + rng() % 10; }
+        if (rng() % 4 != 0) { number.insert(rng() % (nDigits + 1), "."); }
+        response += number;
+    }
+    static const char damage[] = "+-.0123456789 aZ\r\n\x7f";
+    if (rng() % 5 == 0) {
+        for (int m = 1 + rng() % 3; m > 0; m--) {
+            size_t at = response.empty() ? 0 : rng() % response.size();
+            char   c  = damage[rng() % (sizeof(damage) - 1)];
+            switch (rng() % 3) {
+                case 0: response.insert(at, 1, c); break;
+                case 1:
+                    if (!response.empty()) { response[at] = c; }
+                    break;
+                default:
+                    if (!response.empty()) { response.erase(at, 1); }
+                    break;
+            }
+        }
+    }
+    return response;
+}
+
+static void testParserFuzz() {
+    std::mt19937         rng(18);
+    std::vector<float>   expected;
+    std::vector<uint8_t> digits;
+    long                 mismatches = 0;
+    for (long i = 0; i < 200000; i++) {
+        std::string response   = randomResponse(rng);
+        uint8_t     maxResults = rng() % 13;
+        int         nExpected  = referenceParse(response, expected,
+                                                maxResults, digits);
+
+        // Exactly sized copies, so reading or writing past either end is
+        // caught by AddressSanitizer
+        std::unique_ptr<char[]> values(new char[response.size()]);
+        memcpy(values.get(), response.data(), response.size());
+        std::unique_ptr<float[]> results(new float[maxResults]);
+        int8_t parsed = TestSDI12Sensor::parseSDI12Values(
+            values.get(), response.size(), results.get(), maxResults);
+
+        bool match = parsed == nExpected;
+        for (int r = 0; match && r < parsed; r++) {
+            // Up to 7 digits are exact; 8 or 9 may be off by a rounding
+            match = results[r] == expected[r] ||
+                (digits[r] > 7 &&
+                 (nextafterf(results[r], INFINITY) == expected[r] ||
+                  nextafterf(results[r], -INFINITY) == expected[r]));
+        }
+        if (!match && mismatches++ < 10) {
+            printf("\"%s\" parsed to %d values, expected %d\n",
+                   response.c_str(), parsed, nExpected);
+        }
+    }
+    TEST_CHECK_EQUAL(mismatches, 0);
+}
+
+static void testCRCFuzz() {
+    std::mt19937 rng(16);
+    long         missed = 0;
+    for (long i = 0; i < 100000; i++) {
+        std::string response(1, '0' + rng() % 10);
+        for (int c = rng() % 75; c > 0; c--) { response += ' ' + rng() % 95; }
+        response = withCRC(response);
+        TEST_CHECK(TestSDI12Sensor::checkSDI12CRC(response.data(),
+                                                  response.size()));
+        // any single changed bit is caught
+        response[rng() % response.size()] ^= 1 << (rng() % 7);
+        if (TestSDI12Sensor::checkSDI12CRC(response.data(), response.size())) {
+            missed++;
+        }
+    }
+    TEST_CHECK_EQUAL(missed, 0);
+    TEST_CHECK(!TestSDI12Sensor::checkSDI12CRC("1AB", 3));
+    TEST_CHECK(!TestSDI12Sensor::checkSDI12CRC("", 0));
+}
+
+// Parses and checks a full-length concurrent data response
+static void benchmark() {
+    std::string response = withCRC(
+        "1+12.345+0.123-7.5+1000.2+3.14159+22.2+0.001-45.67+8.9+100.25+6.0");
+    float  results[12];
+    size_t parsed = 0;
+    auto   start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100000; i++) {
+        if (TestSDI12Sensor::checkSDI12CRC(response.data(),
+                                           response.size())) {
+            parsed += TestSDI12Sensor::parseSDI12Values(
+                response.data() + 1, response.size() - 4, results, 12);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    printf("checkSDI12CRC and parseSDI12Values: %.1f ns per %zu character "
+           "response\n",
+           std::chrono::duration<double, std::nano>(end - start).count() /
+               100000,
+           response.size());
+    TEST_CHECK_EQUAL(parsed, 11 * 100000);
+}
+
+int main() {
+    SDI12::responder = reply;
+    varArray.begin();
+    TEST_CHECK(varArray.setupSensors());
+    testLongConcurrentWait();
+    testMeasurementAllocations();
+    peerArray.begin();
+    TEST_CHECK(leaderSDI.setup());
+    TEST_CHECK(peerSDI.setup());
+    testBatchReuse();
+    testPeerWokenAfterBatch();
+    testStaleBatch();
+    testParserFuzz();
+    testCRCFuzz();
+    benchmark();
+    return testResult();
+}
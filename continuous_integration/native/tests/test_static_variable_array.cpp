@@ -0,0 +1,97 @@
+/**
+ * @file test_static_variable_array.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks that a StaticVariableArray keeps its sensor list and
+ * calculation plan in its own storage, sized by its template arguments, and
+ * that neither it nor a plain VariableArray allocates.
+ */
+
+#include "TestHelpers.h"
+#include "AllocationCounter.h"
+#include "VariableArray.h"
+
+ScriptedSensor twoValues("TwoValues", 2);
+ScriptedSensor oneValue("OneValue");
+
+Variable first(&twoValues, 0, 2, "a", "meter", "first", nullptr);
+Variable second(&twoValues, 1, 2, "b", "meter", "second", nullptr);
+Variable third(&oneValue, 0, 2, "c", "meter", "third", nullptr);
+
+static float sum() {
+    return first.getValue() + third.getValue();
+}
+static float doubledSum() {
+    return 2 * sum();
+}
+// listed before the calculation it uses, so it has to be planned after it
+Variable doubled(doubledSum, 2, "d", "meter", "doubled", nullptr);
+Variable total(sum, 2, "e", "meter", "total", nullptr);
+
+Variable* variableList[] = {&first, &second, &third, &doubled, &total};
+
+static_assert(StaticVariableArray<2, 2>::getStorageSize() ==
+                  2 * sizeof(Sensor*) + 2 * sizeof(uint32_t) + 2,
+              "The storage is sized by the template arguments");
+static_assert(sizeof(StaticVariableArray<2, 2>) >=
+                  sizeof(VariableArrayBase) +
+                      StaticVariableArray<2, 2>::getStorageSize(),
+              "The storage is inside the object");
+static_assert(sizeof(StaticVariableArray<2, 2>) < sizeof(VariableArray),
+              "The storage is smaller than a plain array's");
+
+static void testExactStorage() {
+    AllocationCount allocations;
+    {
+        StaticVariableArray<2, 2> varArray(variableList);
+        varArray.begin();
+        TEST_CHECK_EQUAL(varArray.getVariableCount(), 5);
+        TEST_CHECK_EQUAL(varArray.getSensorCount(), 2);
+        TEST_CHECK_EQUAL(varArray.getCalculatedVariableCount(), 2);
+
+        twoValues.reading = 1.0f;
+        oneValue.reading  = 4.0f;
+        TEST_CHECK(varArray.setupSensors());
+        TEST_CHECK(varArray.completeUpdate());
+        TEST_CHECK(total.getValue() == 5.0f);
+        TEST_CHECK(doubled.getValue() == 10.0f);
+    }
+    TEST_CHECK_EQUAL(allocations.count(), 0);
+
+    // a plain array uses its fixed arrays
+    AllocationCount plainAllocations;
+    {
+        VariableArray varArray(5, variableList);
+        varArray.begin();
+        TEST_CHECK_EQUAL(varArray.getSensorCount(), 2);
+        TEST_CHECK(varArray.completeUpdate());
+        TEST_CHECK(doubled.getValue() == 10.0f);
+    }
+    TEST_CHECK_EQUAL(plainAllocations.count(), 0);
+}
+
+static void testTooSmall() {
+    AllocationCount allocations;
+    // room for only one sensor and one calculation, and no room to grow
+    StaticVariableArray<1, 1> varArray(variableList);
+    varArray.begin();
+    TEST_CHECK_EQUAL(varArray.getSensorCount(), 1);
+    TEST_CHECK_EQUAL(allocations.count(), 0);
+
+    // the sensor left out isn't measured, and the calculated variables are
+    // evaluated in array order
+    twoValues.reading = 2.0f;
+    oneValue.reading  = 6.0f;
+    varArray.completeUpdate();
+    TEST_CHECK(first.getValue() == 2.0f);
+    TEST_CHECK(third.getValue() == 4.0f);
+    TEST_CHECK(total.getValue() == 6.0f);
+}
+
+int main() {
+    testExactStorage();
+    testTooSmall();
+    return testResult();
+}
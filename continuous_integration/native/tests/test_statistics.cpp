@@ -0,0 +1,101 @@
+/**
+ * @file test_statistics.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks the running mean and statistics kept while measurements are
+ * averaged against a two-pass calculation, and the variables reporting them.
+ */
+
+#include "TestHelpers.h"
+#include "VariableArray.h"
+
+#include <math.h>
+
+ListSensor              listSensor("List");
+Variable                measured(&listSensor, 0, 3, "a", "meter", "mean",
+                                 nullptr);
+ResultStandardDeviation deviation(&listSensor, 0, 3, "a", "meter", "sd");
+ResultMinimum           minimum(&listSensor, 0, 3, "a", "meter", "min");
+ResultMaximum           maximum(&listSensor, 0, 3, "a", "meter", "max");
+Variable* variableList[] = {&measured, &deviation, &minimum, &maximum};
+VariableArray varArray(4, variableList);
+
+// Averages the readings through the variable array and compares the results
+// to a mean and sample standard deviation calculated in two passes in double
+// precision
+static void checkAgainstTwoPass(const float* readings, uint8_t count,
+                                float tolerance) {
+    listSensor.setReadings(readings, count);
+    TEST_CHECK(varArray.completeUpdate());
+
+    double sum = 0;
+    float  lo  = readings[0];
+    float  hi  = readings[0];
+    for (uint8_t i = 0; i < count; i++) {
+        sum += readings[i];
+        if (readings[i] < lo) lo = readings[i];
+        if (readings[i] > hi) hi = readings[i];
+    }
+    double mean    = sum / count;
+    double squares  = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        squares += (readings[i] - mean) * (readings[i] - mean);
+    }
+    double sd = sqrt(squares / (count - 1));
+
+    TEST_CHECK(fabs(measured.getValue() - mean) <= tolerance * fabs(mean));
+    TEST_CHECK(fabs(deviation.getValue() - sd) <= tolerance * sd);
+    TEST_CHECK(minimum.getValue() == lo);
+    TEST_CHECK(maximum.getValue() == hi);
+}
+
+static void testAgainstTwoPass() {
+    const float small[] = {2.0f, 4.0f, 4.0f, 4.0f, 5.0f, 5.0f, 7.0f, 9.0f};
+    checkAgainstTwoPass(small, 8, 1e-6f);
+    TEST_CHECK(measured.getValue() == 5.0f);
+
+    // a large offset with a small spread, where the spread is near the
+    // precision of a float; the difference from the two-pass result is the
+    // rounding of the readings around the running mean
+    const float offset[] = {100000.1f, 100000.3f, 99999.9f, 100000.2f,
+                            100000.0f, 99999.8f};
+    checkAgainstTwoPass(offset, 6, 1e-2f);
+
+    // a single-precision sum of squares cancels to nothing useful here
+    float sum = 0;
+    float squares = 0;
+    for (float reading : offset) {
+        sum += reading;
+        squares += reading * reading;
+    }
+    float naive = sqrtf(fabsf(squares - sum * sum / 6) / 5);
+    TEST_CHECK(fabsf(naive - 0.18793f) > 10 * fabsf(deviation.getValue() -
+                                                    0.18793f));
+}
+
+static void testTooFewValues() {
+    const float one[] = {3.0f};
+    listSensor.setReadings(one, 1);
+    TEST_CHECK(varArray.completeUpdate());
+    TEST_CHECK(measured.getValue() == 3.0f);
+    TEST_CHECK(deviation.getValue() == MS_INVALID_VALUE);
+    TEST_CHECK(minimum.getValue() == 3.0f);
+    TEST_CHECK(maximum.getValue() == 3.0f);
+
+    const float none[] = {MS_INVALID_VALUE};
+    listSensor.setReadings(none, 1);
+    varArray.completeUpdate();
+    TEST_CHECK(minimum.getValue() == MS_INVALID_VALUE);
+    TEST_CHECK(maximum.getValue() == MS_INVALID_VALUE);
+}
+
+int main() {
+    varArray.begin();
+    TEST_CHECK(varArray.setupSensors());
+    TEST_CHECK_EQUAL(varArray.getCalculatedVariableCount(), 3);
+    testAgainstTwoPass();
+    testTooFewValues();
+    return testResult();
+}
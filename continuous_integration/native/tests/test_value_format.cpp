@@ -0,0 +1,158 @@
+/**
+ * @file test_value_format.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Checks the integer value formatter against an exact reference and
+ * times it against snprintf.
+ */
+
+#include "TestHelpers.h"
+#include "VariableBase.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+
+static float noValue() {
+    return 0;
+}
+
+// The exact decimal value of the float, rounded half away from zero; no
+// decimal places truncates
+static std::string reference(float value, uint8_t decimals) {
+    if (std::isnan(value)) { return "nan"; }
+    std::string text = value < 0 && (decimals > 0 || value <= -1) ? "-" : "";
+    long double magnitude = fabsl(static_cast<long double>(value));
+    if (std::isinf(value)) { return text + "inf"; }
+    if (magnitude >= (decimals == 0 ? 2147483648.0L : 4294967296.0L)) {
+        return "ovf";
+    }
+    // A float has 24 significant bits and 10^9 needs 30, so the scaled value
+    // is exact in a long double's 64 bits
+    uint64_t scale = 1;
+    for (uint8_t i = 0; i < decimals; i++) { scale *= 10; }
+    auto scaled = static_cast<uint64_t>(
+        decimals == 0 ? truncl(magnitude) : roundl(magnitude * scale));
+    text += std::to_string(scaled / scale);
+    if (decimals > 0) {
+        std::string fraction = std::to_string(scaled % scale);
+        text += "." + std::string(decimals - fraction.size(), '0') + fraction;
+    }
+    return text;
+}
+
+static float randomFloat(std::mt19937& rng) {
+    // Every bit pattern is equally likely, so every magnitude is covered
+    uint32_t bits = rng();
+    float    value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void testEquivalence() {
+    std::mt19937 rng(24);
+    long         mismatches = 0;
+    for (uint8_t decimals = 0; decimals <= Variable::MAX_VALUE_DECIMALS;
+         decimals++) {
+        Variable variable(noValue, decimals, "a", "meter", "a");
+        char     buffer[Variable::VALUE_BUFFER_SIZE];
+        for (long i = 0; i < 300000; i++) {
+            float value;
+            switch (i % 3) {
+                case 0: value = randomFloat(rng); break;
+                case 1:
+                    // everyday readings
+                    value = std::uniform_real_distribution<float>(
+                        -1000, 1000)(rng);
+                    break;
+                default:
+                    // exact ties in the last decimal place
+                    value = static_cast<float>(
+                                std::uniform_int_distribution<int>(
+                                    -20000, 20000)(rng)) /
+                        8;
+                    break;
+            }
+            uint8_t     len      = variable.formatValueChars(value, buffer);
+            std::string expected = reference(value, decimals);
+            if (expected != buffer || len != expected.size()) {
+                if (mismatches++ < 10) {
+                    printf("%.9g at %d decimals is \"%s\", expected \"%s\"\n",
+                           value, decimals, buffer, expected.c_str());
+                }
+            }
+        }
+    }
+    TEST_CHECK_EQUAL(mismatches, 0);
+}
+
+static void testSpecialValues() {
+    Variable variable(noValue, 2, "a", "meter", "a");
+    char     buffer[Variable::VALUE_BUFFER_SIZE];
+    variable.formatValueChars(MS_INVALID_VALUE, buffer);
+    TEST_CHECK_STRING(buffer, "-9999.00");
+    variable.formatValueChars(-0.001f, buffer);
+    TEST_CHECK_STRING(buffer, "-0.00");
+    variable.formatValueChars(0.145f, buffer);
+    TEST_CHECK_STRING(buffer, "0.14");
+    variable.formatValueChars(NAN, buffer);
+    TEST_CHECK_STRING(buffer, "nan");
+    variable.formatValueChars(-INFINITY, buffer);
+    TEST_CHECK_STRING(buffer, "-inf");
+    variable.formatValueChars(5e9f, buffer);
+    TEST_CHECK_STRING(buffer, "ovf");
+
+    Variable whole(noValue, 0, "a", "meter", "a");
+    whole.formatValueChars(-0.9f, buffer);
+    TEST_CHECK_STRING(buffer, "0");
+    whole.formatValueChars(-1.9f, buffer);
+    TEST_CHECK_STRING(buffer, "-1");
+
+    Variable fine(noValue, 9, "a", "meter", "a");
+    fine.formatValueChars(5.5e-10f, buffer);
+    TEST_CHECK_STRING(buffer, "0.000000001");
+}
+
+// Formats the same values with formatValueChars() and snprintf
+static void benchmark() {
+    std::mt19937 rng(1);
+    float        values[4096];
+    for (float& value : values) {
+        value = std::uniform_real_distribution<float>(-1000, 1000)(rng);
+    }
+    Variable variable(noValue, 3, "a", "meter", "a");
+    char     buffer[Variable::VALUE_BUFFER_SIZE];
+    size_t   written = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 100; pass++) {
+        for (float value : values) {
+            written += variable.formatValueChars(value, buffer);
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 100; pass++) {
+        for (float value : values) {
+            written += snprintf(buffer, sizeof(buffer), "%.3f", value);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double count = 100.0 * 4096;
+    printf("formatValueChars: %.1f ns per value\n",
+           std::chrono::duration<double, std::nano>(middle - start).count() /
+               count);
+    printf("snprintf:         %.1f ns per value\n",
+           std::chrono::duration<double, std::nano>(end - middle).count() /
+               count);
+    TEST_CHECK(written > 0);
+}
+
+int main() {
+    testEquivalence();
+    testSpecialValues();
+    benchmark();
+    return testResult();
+}
@@ -0,0 +1,184 @@
+/**
+ * @file test_variable_array.cpp
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Runs complete variable array updates against scripted sensors.
+ */
+
+#include "TestHelpers.h"
+#include "VariableArray.h"
+#include "LoggerBase.h"
+
+ScriptedSensor fast("Fast", 2);
+ScriptedSensor slow("Slow", 1, 500, 1200, 22);
+
+Variable fastA(&fast, 0, 2, "a", "meter", "fastA", nullptr);
+Variable fastB(&fast, 1, 2, "b", "meter", "fastB", nullptr);
+Variable slowA(&slow, 0, 1, "c", "meter", "slowA", nullptr);
+
+float doubleFastA() {
+    return fastA.getValue() * 2;
+}
+Variable doubled(doubleFastA, 3, "d", "meter", "doubled");
+
+Variable* variableList[] = {&fastA, &fastB, &doubled, &slowA};
+VariableArray varArray(4, variableList);
+
+// Exposes scheduling the sensors for the marked time
+class TestLogger : public Logger {
+ public:
+    TestLogger() : Logger("native", "feature-uuid", 15, 10, -1, &varArray) {}
+    using Logger::scheduleSensorUpdate;
+};
+TestLogger logger;
+
+static const uint32_t onTheHour = 1735689600;  // 2025-01-01 00:00:00
+
+static void testCompleteUpdate() {
+    varArray.begin();
+    TEST_CHECK_EQUAL(varArray.getVariableCount(), 4);
+    TEST_CHECK_EQUAL(varArray.getSensorCount(), 2);
+
+    fast.reading = 1.5f;
+    slow.reading = 7.25f;
+    TEST_CHECK(varArray.completeUpdate());
+    TEST_CHECK(fastA.getValue() == 1.5f);
+    TEST_CHECK(fastB.getValue() == 2.5f);
+    TEST_CHECK(slowA.getValue() == 7.25f);
+    TEST_CHECK(doubled.getValue() == 3.0f);
+
+    String value = doubled.getValueString();
+    TEST_CHECK_STRING(value.c_str(), "3.000");
+}
+
+static void testFailedSensor() {
+    slow.failing = true;
+    varArray.completeUpdate();
+    TEST_CHECK(fastA.getValue() == 1.5f);
+    TEST_CHECK(slowA.getValue() == MS_INVALID_VALUE);
+    slow.failing = false;
+}
+
+static void testScheduledUpdate() {
+    slow.setLoggingInterval(10);
+
+    // not due at five past; its variables are invalid and it isn't powered
+    int slowAttempts = slow.attempts;
+    varArray.setUpdateTime(onTheHour + 5 * 60);
+    varArray.completeUpdate();
+    TEST_CHECK_EQUAL(slow.attempts, slowAttempts);
+    TEST_CHECK(!slow.getStatusBit(Sensor::POWER_ATTEMPTED));
+    TEST_CHECK(slowA.getValue() == MS_INVALID_VALUE);
+    TEST_CHECK(fastA.getValue() == 1.5f);
+
+    // due at ten past
+    varArray.setUpdateTime(onTheHour + 10 * 60);
+    varArray.completeUpdate();
+    TEST_CHECK(slow.attempts > slowAttempts);
+    TEST_CHECK(slowA.getValue() == 7.25f);
+
+    // powering up directly isn't limited to the sensors that are due
+    varArray.setUpdateTime(onTheHour + 5 * 60);
+    varArray.sensorsPowerUp();
+    TEST_CHECK(slow.getStatusBit(Sensor::POWER_ATTEMPTED));
+    varArray.sensorsPowerDown();
+    varArray.setUpdateTime(0);
+
+    slow.setLoggingInterval(0);
+}
+
+static void testStartupUpdatesEverySensor() {
+    slow.setLoggingInterval(10);
+    logger.setStartupMeasurements(2);
+
+    // every startup record, including the last, updates every sensor
+    for (int minute = 1; minute <= 2; minute++) {
+        int slowAttempts            = slow.attempts;
+        Logger::markedLocalUnixTime = onTheHour + minute * 60;
+        TEST_CHECK(logger.checkMarkedInterval());
+        logger.scheduleSensorUpdate();
+        varArray.completeUpdate();
+        TEST_CHECK(slow.attempts > slowAttempts);
+    }
+    TEST_CHECK_EQUAL(logger.getStartupMeasurements(), 0);
+
+    // after them only the sensors that are due are updated
+    int slowAttempts            = slow.attempts;
+    Logger::markedLocalUnixTime = onTheHour + 15 * 60;
+    TEST_CHECK(logger.checkMarkedInterval());
+    logger.scheduleSensorUpdate();
+    varArray.completeUpdate();
+    TEST_CHECK_EQUAL(slow.attempts, slowAttempts);
+
+    slow.setLoggingInterval(0);
+}
+
+// Runs one logged update, returning whether the slow sensor was measured
+static bool loggedUpdateMeasuredSlow() {
+    int slowAttempts = slow.attempts;
+    varArray.setUpdateTime(onTheHour);
+    varArray.completeUpdate();
+    return slow.attempts > slowAttempts;
+}
+
+static void testFailingSensorBreaker() {
+    SensorBreakerState breaker(&slow);
+    TEST_CHECK(breaker.isCalculated);
+    TEST_CHECK(breaker.getValue(true) == 0);
+    slow.setBreakerThreshold(2);
+    slow.failing = true;
+
+    // updates that aren't logged don't count toward the breaker
+    varArray.completeUpdate();
+    varArray.updateAllSensors();
+    TEST_CHECK_EQUAL(slow.getFailedCycles(), 0);
+
+    // two failed logged updates open it
+    TEST_CHECK(loggedUpdateMeasuredSlow());
+    TEST_CHECK(loggedUpdateMeasuredSlow());
+    TEST_CHECK_EQUAL(slow.getFailedCycles(), 2);
+    TEST_CHECK(slow.isBreakerOpen());
+
+    // an open breaker doesn't stop powering up directly or an update that
+    // isn't logged, and neither uses up a skipped cycle
+    varArray.sensorsPowerUp();
+    TEST_CHECK(slow.getStatusBit(Sensor::POWER_ATTEMPTED));
+    varArray.sensorsPowerDown();
+    int slowAttempts = slow.attempts;
+    varArray.completeUpdate();
+    TEST_CHECK(slow.attempts > slowAttempts);
+    TEST_CHECK_EQUAL(slow.getFailedCycles(), 2);
+    TEST_CHECK(slow.isBreakerOpen());
+
+    // the next logged update skips it, then the failed probe doubles the skip
+    TEST_CHECK(!loggedUpdateMeasuredSlow());
+    TEST_CHECK(slowA.getValue() == MS_INVALID_VALUE);
+    TEST_CHECK(!slow.isBreakerOpen());
+    TEST_CHECK(loggedUpdateMeasuredSlow());
+    TEST_CHECK_EQUAL(slow.getBreakerState(), 2);
+    TEST_CHECK(breaker.getValue(true) == 2);
+    TEST_CHECK_STRING(breaker.getVarCodeChars(), "breakerState");
+    TEST_CHECK(!loggedUpdateMeasuredSlow());
+    TEST_CHECK(!loggedUpdateMeasuredSlow());
+
+    // the first good logged update closes it
+    slow.failing = false;
+    TEST_CHECK(loggedUpdateMeasuredSlow());
+    TEST_CHECK_EQUAL(slow.getFailedCycles(), 0);
+    TEST_CHECK_EQUAL(slow.getBreakerState(), 0);
+    TEST_CHECK(breaker.getValue(true) == 0);
+    TEST_CHECK(slowA.getValue() == 7.25f);
+
+    slow.setBreakerThreshold(0);
+}
+
+int main() {
+    testCompleteUpdate();
+    testFailedSensor();
+    testScheduledUpdate();
+    testStartupUpdatesEverySensor();
+    testFailingSensorBreaker();
+    return testResult();
+}
@@ -184,6 +184,12 @@ epochStart loggerClock::_core_epoch = epochStart::y2k_epoch;
 int32_t loggerClock::_core_tz = 0;
 // Initialize the static timezone
 int8_t loggerClock::_rtcUTCOffset = 0;
+// Initialize the ISO8601 formatting cache
+char    loggerClock::_iso8601Cache[ISO8601_BUFFER_SIZE] = {'\0'};
+int64_t loggerClock::_iso8601CacheTime                  = 0;
+int64_t loggerClock::_iso8601CacheDay                   = 0;
+int8_t  loggerClock::_iso8601CacheOffset                = 0;
+bool    loggerClock::_iso8601CacheValid                 = false;
 
 
 // Configure the epoch used internally by the RTC
@@ -280,45 +286,91 @@ String loggerClock::formatDateTime_ISO8601(time_t     epochSeconds,
 }
 String loggerClock::formatDateTime_ISO8601(epochTime in_time,
                                            int8_t    epochSecondsUTCOffset) {
-    // Use the conversion function to get a temporary variable for the epoch
-    // time in the epoch used by the processor core (i.e., used by gmtime).
-    time_t t = epochTime::convert_epoch(in_time, loggerClock::_core_epoch);
-    MS_DEEP_DBG(F("Input time converted to processor epoch:"), t, '(',
-                epochTime::printEpochName(loggerClock::_core_epoch), ')');
+    char buffer[ISO8601_BUFFER_SIZE];
+    formatDateTime_ISO8601(buffer, in_time, epochSecondsUTCOffset);
+    return String(buffer);
+}
+
+// Writes a number from 0-99 as two digits
+static void writeTwoDigits(char* buffer, uint8_t value) {
+    buffer[0] = '0' + value / 10;
+    buffer[1] = '0' + value % 10;
+}
+
+// This formats the time into the cache, only redoing the parts that changed
+// from the last time formatted, and copies it out
+uint8_t loggerClock::formatDateTime_ISO8601(char* buffer, epochTime in_time,
+                                            int8_t epochSecondsUTCOffset) {
+    // Work in Unix seconds so the calendar math starts from Jan 1, 1970
+    auto t = static_cast<int64_t>(
+        epochTime::convert_epoch(in_time, epochStart::unix_epoch));
+
+    if (!_iso8601CacheValid || t != _iso8601CacheTime ||
+        epochSecondsUTCOffset != _iso8601CacheOffset) {
+        // Only convert to a calendar date on a new day
+        if (!_iso8601CacheValid || t < _iso8601CacheDay ||
+            t >= _iso8601CacheDay + 86400L) {
+            int32_t days = static_cast<int32_t>(t / 86400L);
+            if (t % 86400L < 0) { days--; }
+            _iso8601CacheDay = static_cast<int64_t>(days) * 86400L;
+
+            // Civil date from days since the Unix epoch, counting from
+            // March 1 of year 0 so the leap day is the last day of the year.
+            // See https://howardhinnant.github.io/date_algorithms.html
+            int32_t  z   = days + 719468L;
+            int32_t  era = (z >= 0 ? z : z - 146096L) / 146097L;
+            uint32_t doe = static_cast<uint32_t>(z - era * 146097L);
+            uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) /
+                365;
+            uint32_t doy   = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            uint32_t mp    = (5 * doy + 2) / 153;
+            uint8_t  day   = doy - (153 * mp + 2) / 5 + 1;
+            uint8_t  month = mp < 10 ? mp + 3 : mp - 9;
+            int32_t  year  = static_cast<int32_t>(yoe) + era * 400 +
+                (month <= 2 ? 1 : 0);
+
+            writeTwoDigits(_iso8601Cache, year / 100);
+            writeTwoDigits(_iso8601Cache + 2, year % 100);
+            _iso8601Cache[4] = '-';
+            writeTwoDigits(_iso8601Cache + 5, month);
+            _iso8601Cache[7] = '-';
+            writeTwoDigits(_iso8601Cache + 8, day);
+            _iso8601Cache[10] = 'T';
+            _iso8601Cache[13] = ':';
+            _iso8601Cache[16] = ':';
+        }
 
-    // create a temporary time struct
-    // tm is a struct for time parts, defined in time.h
-    struct tm* tmp = gmtime(&t);
-    MS_DEEP_DBG(F("Time components: "), tmp->tm_year, F(" - "), tmp->tm_mon + 1,
-                F(" - "), tmp->tm_mday, F("    "), tmp->tm_hour, F(" : "),
-                tmp->tm_min, F(" : "), tmp->tm_sec);
+        uint32_t secondOfDay = static_cast<uint32_t>(t - _iso8601CacheDay);
+        writeTwoDigits(_iso8601Cache + 11, secondOfDay / 3600);
+        writeTwoDigits(_iso8601Cache + 14, (secondOfDay / 60) % 60);
+        writeTwoDigits(_iso8601Cache + 17, secondOfDay % 60);
+
+        if (!_iso8601CacheValid ||
+            epochSecondsUTCOffset != _iso8601CacheOffset) {
+            // NOTE: the %z format from strftime formats the timezone as +hhmm,
+            // but we need +hh:mm
+            int8_t quarterHours = epochSecondsUTCOffset * 4;
+            char   plusMinus    = '+';
+            if (quarterHours < 0) {
+                plusMinus = '-';
+                quarterHours *= -1;
+            }
+            uint16_t tz_mins = quarterHours * 15;
+            _iso8601Cache[19] = plusMinus;
+            writeTwoDigits(_iso8601Cache + 20, tz_mins / 60);
+            _iso8601Cache[22] = ':';
+            writeTwoDigits(_iso8601Cache + 23, tz_mins % 60);
+            _iso8601Cache[25] = '\0';
+        }
 
-    // create a temporary buffer to put the timestamp into
-    static char
-        time8601tz[20];  // Max of yyyy-mm-ddThh:mm:ss with \0 terminator
-    // use strftime (from time.h) to format the time
-    strftime(time8601tz, 20, "%Y-%m-%dT%H:%M:%S", tmp);
-    MS_DEEP_DBG(F("Formatted time string:"), time8601tz);
-
-    // Correct the timezone format
-    // NOTE: the %z format from strftime formats the timezone as +hhmm, but we
-    // need +hh:mm
-    char   isotz[8];
-    int8_t quarterHours = epochSecondsUTCOffset * 4;
-    char   plusMinus    = '+';
-    if (quarterHours < 0) {
-        plusMinus = '-';
-        quarterHours *= -1;
+        _iso8601CacheTime   = t;
+        _iso8601CacheOffset = epochSecondsUTCOffset;
+        _iso8601CacheValid  = true;
+        MS_DEEP_DBG(F("Formatted time string:"), _iso8601Cache);
     }
-    uint16_t tz_mins = quarterHours * 15;
-    uint8_t  tzh     = tz_mins / 60;
-    uint8_t  tzm     = tz_mins % 60;
-    MS_DEEP_DBG(F("Time zone: plusMinus:"), plusMinus, F("tzh:"), tzh,
-                F("tzm:"), tzm);
-    snprintf(isotz, sizeof(isotz), "%c%02d:%02d", plusMinus, tzh, tzm);
-    MS_DEEP_DBG(F("Formatted time zone string:"), isotz);
-
-    return String(time8601tz) + String(isotz);
+
+    memcpy(buffer, _iso8601Cache, ISO8601_BUFFER_SIZE);
+    return ISO8601_BUFFER_SIZE - 1;
 }
 
 void loggerClock::formatDateTime(char* buffer, const char* fmt,
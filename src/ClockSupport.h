@@ -432,6 +432,29 @@ class loggerClock {
      */
     static String formatDateTime_ISO8601(epochTime in_time,
                                          int8_t    epochSecondsUTCOffset);
+    /**
+     * @brief The size of a buffer for an ISO8601 formatted time with its time
+     * zone (yyyy-mm-ddThh:mm:ss+hh:mm), including the terminating null.
+     */
+    static const uint8_t ISO8601_BUFFER_SIZE = 26;
+    /**
+     * @brief Convert an epochTime object into a ISO8601 formatted string in
+     * the given buffer.
+     *
+     * The last time formatted is cached, so formatting the same time again -
+     * as the logger and each publisher do with the marked time - is a copy.
+     * A time on the same day as the last one only has its time of day
+     * rewritten, so the timestamps in a publisher's log buffer are formatted
+     * without converting each to a calendar date.
+     *
+     * @param buffer A buffer of at least #ISO8601_BUFFER_SIZE characters.
+     * @param in_time An epochTime object
+     * @param epochSecondsUTCOffset The offset of the input epoch time from
+     * UTC in hours.
+     * @return The number of characters written, not counting the null.
+     */
+    static uint8_t formatDateTime_ISO8601(char* buffer, epochTime in_time,
+                                          int8_t epochSecondsUTCOffset);
 
     /**
      * @brief Convert an epoch time into a character string based on the input
@@ -670,6 +693,19 @@ class loggerClock {
      * @brief The static offset data of the real time clock from UTC in hours
      */
     static int8_t _rtcUTCOffset;
+
+    /**
+     * @name ISO8601 formatting cache
+     * The last time formatted by formatDateTime_ISO8601(char*, epochTime,
+     * int8_t).
+     */
+    /**@{*/
+    static char    _iso8601Cache[ISO8601_BUFFER_SIZE];  ///< The formatted time
+    static int64_t _iso8601CacheTime;  ///< The cached time in Unix seconds
+    static int64_t _iso8601CacheDay;   ///< Unix seconds at the start of its day
+    static int8_t  _iso8601CacheOffset;  ///< The cached UTC offset in hours
+    static bool    _iso8601CacheValid;   ///< True once a time is cached
+    /**@}*/
     /**
      * @brief The start of the epoch for the RTC (or the RTC's library).
      */
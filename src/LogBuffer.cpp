@@ -9,28 +9,89 @@
  * This class buffers logged timestamps and variable values for transmission.
  */
 #include "LogBuffer.h"
+#include "VariableBase.h"
 
 #include <string.h>
 
+// Value codes for variables with a resolution; codes from 2 up hold the
+// zig-zag difference from the variable's last value
+#define LOG_BUFFER_INVALID_CODE 0
+#define LOG_BUFFER_RAW_CODE 1
+#define LOG_BUFFER_DELTA_CODE 2
+
+// A quantized value decodes to the nearest float to it divided by the scale,
+// which is within half a step of the value, and so prints the same, only
+// below 2^23
+#define LOG_BUFFER_QUANTIZE_LIMIT 8388608UL
+
+// zig-zag encoding keeps small negative differences small
+static inline uint32_t zigZagEncode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^
+        static_cast<uint32_t>(value >> 31);
+}
+static inline int32_t zigZagDecode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+// 10^resolution
+static uint32_t resolutionScale(uint8_t resolution) {
+    uint32_t scale = 1;
+    for (uint8_t i = 0; i < resolution; i++) { scale *= 10; }
+    return scale;
+}
+
+
 // Constructor
-LogBuffer::LogBuffer() {}
+LogBuffer::LogBuffer() {
+    setNumVariables(0);
+}
+
+void LogBuffer::setDropOldest(bool dropOldest) {
+    _dropOldest = dropOldest;
+}
+bool LogBuffer::getDropOldest() {
+    return _dropOldest;
+}
 
 void LogBuffer::setNumVariables(uint8_t numVariables_) {
-    // each record is one uint32_t to hold the timestamp, plus N floats to hold
-    // each variable's value
-    recordSize   = sizeof(uint32_t) + sizeof(float) * numVariables_;
-    numVariables = numVariables_;
+    numVariables  = numVariables_;
+    _nextVariable = numVariables_;
+    // the resolution table, then the decoder state of the oldest record and
+    // the encoder state of the newest record come before any records
+    _dataStart = numVariables_ + 2 * getStateSize();
+
+    // variables store raw floats until told their resolution
+    if (_dataStart <= MS_LOG_DATA_BUFFER_SIZE) {
+        memset(dataBuffer, RAW_RESOLUTION, numVariables_);
+    }
 
     // this scrambles all the data in the buffer so clear it out
     clear();
 }
 
+void LogBuffer::setVariableResolution(uint8_t variable, uint8_t resolution) {
+    if (variable >= numVariables || _dataStart > MS_LOG_DATA_BUFFER_SIZE) {
+        return;
+    }
+    if (resolution > MAX_QUANTIZED_RESOLUTION) { resolution = RAW_RESOLUTION; }
+    if (dataBuffer[variable] == resolution) { return; }
+    dataBuffer[variable] = resolution;
+    // any records in the buffer were encoded with the old resolution
+    clear();
+}
+
 void LogBuffer::clear() {
     // clear out the buffer
     numRecords      = 0;
-    dataBufferTail  = 0;
-    dataBufferHead  = 0;
+    dataBufferTail  = _dataStart;
+    dataBufferHead  = _dataStart;
+    _nextVariable   = numVariables;
     _bufferOverflow = false;
+    // the first record is encoded against a zero timestamp and zero values
+    if (_dataStart <= MS_LOG_DATA_BUFFER_SIZE) {
+        memset(&dataBuffer[getTailState()], 0, 2 * getStateSize());
+    }
+    rewindReader(0);
 }
 
 uint8_t LogBuffer::getNumVariables() {
@@ -42,61 +103,298 @@ int LogBuffer::getNumRecords() {
 }
 
 uint8_t LogBuffer::getPercentFull() {
-    uint32_t bytesFull = static_cast<uint32_t>(numRecords) *
-        static_cast<uint32_t>(recordSize);
-    uint32_t percent = (bytesFull * static_cast<uint32_t>(100)) /
-        MS_LOG_DATA_BUFFER_SIZE;
+    // with too many variables for the buffer, it's always full
+    if (getCapacity() == 0) { return 100; }
+    uint32_t bytesFull = getBytesUsed();
+    uint32_t percent   = (bytesFull * static_cast<uint32_t>(100)) /
+        getCapacity();
     // Cap the result at 100% to handle potential buffer overflow scenarios
     return static_cast<uint8_t>(percent > 100 ? 100 : percent);
 }
 
 int LogBuffer::addRecord(uint32_t timestamp) {
-    // check how many records currently exist
-    int record = numRecords;
-    // compute position of the new record's timestamp in the buffer
-    // (the timestamp is the first data in the record)
-    size_t pos = record * recordSize;
-    // verify we have sufficient space for the record and bail if not
-    if (MS_LOG_DATA_BUFFER_SIZE - pos < recordSize) { return -1; }
-
-    // write the timestamp to the record
-    memcpy(static_cast<void*>(&dataBuffer[pos]), static_cast<void*>(&timestamp),
-           sizeof(uint32_t));
-    numRecords += 1;  // just added another record
+    // complete the previous record so the new one starts in the right place
+    finishRecord();
+    // verify there's space for the record at its largest, making room by
+    // dropping the oldest records if allowed, and bail if not
+    if (getCapacity() < getMaxRecordSize()) { return -1; }
+    while (isFull()) {
+        _bufferOverflow = true;
+        if (!_dropOldest) { return -1; }
+        removeRecords(1);
+    }
+
+    // write the difference from the previous timestamp
+    uint32_t lastTimestamp = getStoredWord(getHeadState());
+    putVarint(zigZagEncode(static_cast<int32_t>(timestamp - lastTimestamp)));
+    setStoredWord(getHeadState(), timestamp);
+    _nextVariable = 0;
 
     // return the index of the record number just created
-    return record;
+    return numRecords++;
 }
 
 void LogBuffer::setRecordValue(int record, uint8_t variable, float value) {
-    // compute position of this value in the buffer
-    size_t pos = record * recordSize + sizeof(uint32_t) +
-        variable * sizeof(float);
+    // only the newest record can be written, and only moving forward
+    if (record != numRecords - 1 || variable >= numVariables ||
+        variable < _nextVariable) {
+        return;
+    }
+    while (_nextVariable < variable) { encodeValue(MS_INVALID_VALUE); }
+    encodeValue(value);
+}
 
-    // write the value to the record
-    memcpy(static_cast<void*>(&dataBuffer[pos]), static_cast<void*>(&value),
-           sizeof(float));
+bool LogBuffer::isFull() {
+    return getCapacity() - getBytesUsed() < getMaxRecordSize();
+}
+
+void LogBuffer::removeRecords(int count) {
+    // a partly written record can't be decoded past
+    finishRecord();
+    for (; count > 0 && numRecords > 0; count--) { decodeOldestRecord(nullptr); }
+    // record indices have shifted
+    rewindReader(_readVariable);
+}
+
+bool LogBuffer::popRecord(uint32_t& timestamp, float values[]) {
+    finishRecord();
+    if (numRecords == 0) { return false; }
+    timestamp = decodeOldestRecord(values);
+    rewindReader(_readVariable);
+    return true;
 }
 
 uint32_t LogBuffer::getRecordTimestamp(int record) {
-    // read the timestamp from the record (which is the first data in it)
-    uint32_t timestamp;
-    memcpy(static_cast<void*>(&timestamp),
-           static_cast<void*>(&dataBuffer[record * recordSize]),
-           sizeof(uint32_t));
+    if (record < 0 || record >= numRecords) { return 0; }
+    readRecord(record, _readVariable);
+    return _readTimestamp;
+}
+
+float LogBuffer::getRecordValue(int record, uint8_t variable) {
+    if (record < 0 || record >= numRecords || variable >= numVariables) {
+        return MS_INVALID_VALUE;
+    }
+    readRecord(record, variable);
+    return _readValue;
+}
+
+
+uint16_t LogBuffer::getCapacity() {
+    if (_dataStart >= MS_LOG_DATA_BUFFER_SIZE) { return 0; }
+    return MS_LOG_DATA_BUFFER_SIZE - _dataStart;
+}
+
+uint16_t LogBuffer::getBytesUsed() {
+    if (dataBufferHead > dataBufferTail) {
+        return dataBufferHead - dataBufferTail;
+    } else if (dataBufferHead < dataBufferTail) {
+        return getCapacity() - (dataBufferTail - dataBufferHead);
+    }
+    // the head only meets the tail when the buffer is empty or exactly full
+    return numRecords > 0 ? getCapacity() : 0;
+}
+
+uint16_t LogBuffer::getStateSize() {
+    return sizeof(uint32_t) + sizeof(int32_t) * numVariables;
+}
+
+uint16_t LogBuffer::getMaxRecordSize() {
+    // a varint timestamp difference, then a code and raw float per value
+    return 5 + 5 * static_cast<uint16_t>(numVariables);
+}
+
+uint16_t LogBuffer::getTailState() {
+    return numVariables;
+}
 
+uint16_t LogBuffer::getHeadState() {
+    return numVariables + getStateSize();
+}
+
+uint32_t LogBuffer::decodeOldestRecord(float values[]) {
+    // decode the record into the tail state so the record after it becomes
+    // the oldest without being re-encoded
+    uint16_t state     = getTailState();
+    uint32_t timestamp = getStoredWord(state) +
+        static_cast<uint32_t>(zigZagDecode(getVarint(dataBufferTail)));
+    setStoredWord(state, timestamp);
+    for (uint8_t var = 0; var < numVariables; var++) {
+        uint16_t lastPosition = state + sizeof(uint32_t) +
+            sizeof(int32_t) * var;
+        int32_t last  = static_cast<int32_t>(getStoredWord(lastPosition));
+        float   value = decodeValue(dataBufferTail, var, last);
+        setStoredWord(lastPosition, static_cast<uint32_t>(last));
+        if (values != nullptr) { values[var] = value; }
+    }
+    numRecords--;
     return timestamp;
 }
 
-float LogBuffer::getRecordValue(int record, uint8_t variable) {
-    // compute position of this value in the buffer
-    size_t pos = record * recordSize + sizeof(uint32_t) +
-        variable * sizeof(float);
+void LogBuffer::finishRecord() {
+    while (_nextVariable < numVariables) { encodeValue(MS_INVALID_VALUE); }
+}
+
+void LogBuffer::encodeValue(float value) {
+    uint8_t variable   = _nextVariable++;
+    uint8_t resolution = dataBuffer[variable];
+    if (resolution == RAW_RESOLUTION) {
+        putFloat(value);
+        return;
+    }
+    if (value == MS_INVALID_VALUE) {
+        putVarint(LOG_BUFFER_INVALID_CODE);
+        return;
+    }
+
+    // Round exactly the way the value will be formatted, so the posted value
+    // matches the one printed to the SD card.  NaN fails the comparison and
+    // is kept as a raw float with huge values and with small negative values
+    // that print as "-0.00".
+    uint64_t magnitude = LOG_BUFFER_QUANTIZE_LIMIT;
+    if (fabs(value) < LOG_BUFFER_QUANTIZE_LIMIT) {
+        uint32_t whole;
+        uint32_t fraction;
+        Variable::splitValue(value, resolution, whole, fraction);
+        magnitude = static_cast<uint64_t>(whole) *
+                resolutionScale(resolution) +
+            fraction;
+        if (magnitude == 0 && value < 0 && resolution > 0) {
+            magnitude = LOG_BUFFER_QUANTIZE_LIMIT;
+        }
+    }
+    if (magnitude >= LOG_BUFFER_QUANTIZE_LIMIT) {
+        putVarint(LOG_BUFFER_RAW_CODE);
+        putFloat(value);
+        return;
+    }
+    int32_t quantized = value < 0 ? -static_cast<int32_t>(magnitude)
+                                  : static_cast<int32_t>(magnitude);
+
+    uint16_t lastPosition = getHeadState() + sizeof(uint32_t) +
+        sizeof(int32_t) * variable;
+    int32_t last = static_cast<int32_t>(getStoredWord(lastPosition));
+    putVarint(zigZagEncode(quantized - last) + LOG_BUFFER_DELTA_CODE);
+    setStoredWord(lastPosition, static_cast<uint32_t>(quantized));
+}
+
+float LogBuffer::decodeValue(uint16_t& position, uint8_t variable,
+                             int32_t& quantized) {
+    uint8_t resolution = dataBuffer[variable];
+    if (resolution == RAW_RESOLUTION) { return getFloat(position); }
+
+    uint32_t code = getVarint(position);
+    if (code == LOG_BUFFER_INVALID_CODE) { return MS_INVALID_VALUE; }
+    if (code == LOG_BUFFER_RAW_CODE) { return getFloat(position); }
+    quantized += zigZagDecode(code - LOG_BUFFER_DELTA_CODE);
+    return static_cast<float>(quantized) /
+        static_cast<float>(resolutionScale(resolution));
+}
+
+void LogBuffer::skipValue(uint16_t& position, uint8_t variable) {
+    if (dataBuffer[variable] == RAW_RESOLUTION ||
+        getVarint(position) == LOG_BUFFER_RAW_CODE) {
+        getFloat(position);
+    }
+}
+
+void LogBuffer::rewindReader(uint8_t variable) {
+    _readRecord    = -1;
+    _readPosition  = dataBufferTail;
+    _readVariable  = variable;
+    _readValue     = MS_INVALID_VALUE;
+    _readTimestamp = 0;
+    _readQuantized = 0;
+    if (_dataStart > MS_LOG_DATA_BUFFER_SIZE) { return; }
+    _readTimestamp = getStoredWord(getTailState());
+    if (variable < numVariables) {
+        _readQuantized = static_cast<int32_t>(getStoredWord(
+            getTailState() + sizeof(uint32_t) + sizeof(int32_t) * variable));
+    }
+}
+
+void LogBuffer::readRecord(int record, uint8_t variable) {
+    // a partly written record can't be decoded past
+    finishRecord();
+    // values only decode forward from the oldest record
+    if (variable != _readVariable || record < _readRecord) {
+        rewindReader(variable);
+    }
+    while (_readRecord < record) {
+        _readTimestamp += static_cast<uint32_t>(
+            zigZagDecode(getVarint(_readPosition)));
+        for (uint8_t var = 0; var < numVariables; var++) {
+            if (var == variable) {
+                _readValue = decodeValue(_readPosition, var, _readQuantized);
+            } else {
+                skipValue(_readPosition, var);
+            }
+        }
+        _readRecord++;
+    }
+}
+
 
-    // read the value from the record
+void LogBuffer::putByte(uint8_t value) {
+    dataBuffer[dataBufferHead++] = value;
+    // records wrap around from the end of the buffer to the start of the
+    // record area
+    if (dataBufferHead >= MS_LOG_DATA_BUFFER_SIZE) {
+        dataBufferHead = _dataStart;
+    }
+}
+
+uint8_t LogBuffer::getByte(uint16_t& position) {
+    uint8_t value = dataBuffer[position++];
+    if (position >= MS_LOG_DATA_BUFFER_SIZE) { position = _dataStart; }
+    return value;
+}
+
+void LogBuffer::putVarint(uint32_t value) {
+    // seven bits per byte, low bits first, high bit set on all but the last
+    while (value >= 0x80) {
+        putByte(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    putByte(static_cast<uint8_t>(value));
+}
+
+void LogBuffer::putFloat(float value) {
+    // byte by byte, because a float may straddle the end of the buffer
+    uint8_t bytes[sizeof(float)];
+    memcpy(static_cast<void*>(bytes), static_cast<void*>(&value),
+           sizeof(float));
+    for (uint8_t i = 0; i < sizeof(float); i++) { putByte(bytes[i]); }
+}
+
+uint32_t LogBuffer::getVarint(uint16_t& position) {
+    uint32_t value = 0;
+    uint8_t  shift = 0;
+    uint8_t  byte;
+    do {
+        byte = getByte(position);
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        shift += 7;
+    } while ((byte & 0x80) && shift < 35);
+    return value;
+}
+
+float LogBuffer::getFloat(uint16_t& position) {
+    uint8_t bytes[sizeof(float)];
+    for (uint8_t i = 0; i < sizeof(float); i++) { bytes[i] = getByte(position); }
     float value;
-    memcpy(static_cast<void*>(&value), static_cast<void*>(&dataBuffer[pos]),
+    memcpy(static_cast<void*>(&value), static_cast<void*>(bytes),
            sizeof(float));
+    return value;
+}
 
+uint32_t LogBuffer::getStoredWord(uint16_t position) {
+    uint32_t value;
+    memcpy(static_cast<void*>(&value), static_cast<void*>(&dataBuffer[position]),
+           sizeof(uint32_t));
     return value;
 }
+
+void LogBuffer::setStoredWord(uint16_t position, uint32_t value) {
+    memcpy(static_cast<void*>(&dataBuffer[position]), static_cast<void*>(&value),
+           sizeof(uint32_t));
+}
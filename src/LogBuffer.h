@@ -23,11 +23,49 @@
 /**
  * @brief This class buffers logged timestamps and variable values for
  * transmission. The log is divided into a number of records. Each record
- * stores the timestamp of the record as a uint32_t, then the value of each
- * variable as a float at that time.
+ * stores the timestamp of the record, then the value of each variable at that
+ * time.
+ *
+ * Records are stored in a compact variable-length encoding. The timestamp is
+ * stored as the zig-zag varint difference from the previous record's
+ * timestamp. Each value of a variable with a known decimal resolution is
+ * rounded to that resolution and stored as the zig-zag varint difference from
+ * the last value of the same variable. A single byte marks a value equal to
+ * #MS_INVALID_VALUE, and values that cannot be quantized (NaN or very large
+ * numbers) are stored as a marker byte and the raw float. Values of variables
+ * without a resolution are always stored as raw floats.
+ *
+ * A slowly changing value with a resolution of a few decimal places usually
+ * takes a single byte instead of four, and a timestamp at a fixed logging
+ * interval usually takes two bytes instead of four.
+ *
+ * The front of the buffer is reserved for a table of the resolutions and for
+ * the decoder state of the oldest record and the encoder state of the newest
+ * record, which costs 9 bytes per variable plus 8 bytes. The rest of the
+ * buffer is used as a ring: records wrap from the end of the buffer back to
+ * the start of the record area. When there is no room for a new record,
+ * either the oldest records are dropped to make room or the new record is
+ * refused, depending on setDropOldest(). Removing the oldest records only
+ * decodes them into the reserved decoder state; nothing is re-encoded.
+ *
+ * Because of the delta encoding, values must be added to the newest record in
+ * variable order and records are decoded sequentially from the oldest. Reading
+ * every record of one variable in order, or every timestamp in order, costs
+ * one pass through the buffer.
  */
 class LogBuffer {
  public:
+    /**
+     * @brief The resolution marking a variable whose values are stored as
+     * raw floats rather than quantized.
+     */
+    static const uint8_t RAW_RESOLUTION = 0xFF;
+    /**
+     * @brief The largest decimal resolution that will be quantized; variables
+     * with a higher resolution are stored as raw floats.
+     */
+    static const uint8_t MAX_QUANTIZED_RESOLUTION = 7;
+
     /**
      * @brief Constructs a new empty buffer which stores no variables or values.
      */
@@ -37,9 +75,27 @@ class LogBuffer {
      */
     virtual ~LogBuffer() = default;
 
+    /**
+     * @brief Sets whether the oldest records are dropped to make room for a
+     * new record when the buffer is full.
+     *
+     * @param dropOldest True to drop the oldest records; false to refuse new
+     * records while the buffer is full. The default is set by
+     * #MS_LOG_BUFFER_DROP_OLDEST.
+     */
+    void setDropOldest(bool dropOldest);
+    /**
+     * @brief Gets whether the oldest records are dropped when the buffer is
+     * full.
+     *
+     * @return True if the oldest records are dropped.
+     */
+    bool getDropOldest();
+
     /**
      * @brief Sets the number of variables the buffer will store in each record.
-     * Clears the buffer as a side effect.
+     * Clears the buffer as a side effect and resets the resolution of every
+     * variable to #RAW_RESOLUTION.
      *
      * @param numVariables_  The number of variables to store.
      */
@@ -52,6 +108,20 @@ class LogBuffer {
      */
     uint8_t getNumVariables();
 
+    /**
+     * @brief Sets the decimal resolution values of a variable are quantized to
+     * in the buffer.
+     *
+     * This should match the resolution the value will be formatted with when
+     * it is read back out, ie, Variable::getResolution(). If the resolution
+     * changes while records are in the buffer, the buffer is cleared.
+     *
+     * @param variable  The variable
+     * @param resolution  The number of decimal places to keep, or
+     * #RAW_RESOLUTION to store raw floats.
+     */
+    void setVariableResolution(uint8_t variable, uint8_t resolution);
+
     /**
      * @brief Clears all records from the log.
      */
@@ -71,9 +141,21 @@ class LogBuffer {
      */
     uint8_t getPercentFull();
 
+    /**
+     * @brief Checks whether there is room for another record without
+     * dropping the oldest.
+     *
+     * @return True if the next record would drop the oldest or be refused.
+     */
+    bool isFull();
+
     /**
      * @brief Adds a new record with the given timestamp.
      *
+     * Any values not yet set in the previous record are filled with
+     * #MS_INVALID_VALUE.  Space is only allotted for a record if there is
+     * room for every value at its largest encoding.
+     *
      * @param timestamp  The timestamp
      *
      * @return Index of the new record, or -1 if there was no space.
@@ -81,14 +163,38 @@ class LogBuffer {
     int addRecord(uint32_t timestamp);
 
     /**
-     * @brief Sets the value of a particular variable in a particular record.
+     * @brief Sets the value of a particular variable in the newest record.
      *
-     * @param record    The record
+     * Values must be set in variable order. Skipped variables are filled with
+     * #MS_INVALID_VALUE; attempts to set a value of an older record or to
+     * set a value a second time are ignored.
+     *
+     * @param record    The record; must be the record just added.
      * @param variable  The variable
      * @param value     The value
      */
     void setRecordValue(int record, uint8_t variable, float value);
 
+    /**
+     * @brief Removes the oldest records from the log, ie, the records that
+     * have been acknowledged by a receiver. The remaining records are
+     * renumbered from 0.
+     *
+     * @param count  The number of records to remove. Removing more records
+     * than are in the log empties it.
+     */
+    void removeRecords(int count);
+
+    /**
+     * @brief Reads and removes the oldest record from the log.
+     *
+     * @param timestamp Set to the record's timestamp.
+     * @param values An array of getNumVariables() floats to fill with the
+     * record's values.
+     * @return True if there was a record to remove.
+     */
+    bool popRecord(uint32_t& timestamp, float values[]);
+
     /**
      * @brief Gets the timestamp of a particular record.
      *
@@ -101,6 +207,8 @@ class LogBuffer {
     /**
      * @brief Gets the value of a particular variable in a particular record.
      *
+     * Variables with a resolution return the value rounded to that resolution.
+     *
      * @param record    The record
      * @param variable  The variable
      *
@@ -115,11 +223,11 @@ class LogBuffer {
     uint8_t dataBuffer[MS_LOG_DATA_BUFFER_SIZE];
 
     /**
-     * @brief Index of buffer head.
+     * @brief Index of the first byte of the oldest record.
      */
     uint16_t dataBufferTail;
     /**
-     * @brief Index of buffer tail.
+     * @brief Index of the next byte to be written.
      */
     uint16_t dataBufferHead;
     /**
@@ -127,20 +235,189 @@ class LogBuffer {
      */
     bool _bufferOverflow = false;
 
+    /**
+     * @brief Whether to drop the oldest records to make room for a new one.
+     */
+    bool _dropOldest = MS_LOG_BUFFER_DROP_OLDEST;
+
     /**
      * @brief Number of records currently in the buffer.
      */
     int numRecords;
 
     /**
-     * @brief Size in bytes of each record in the buffer.
+     * @brief Index of the first byte available for records, after the
+     * resolution table and the encoder states.
      */
-    size_t recordSize;
+    uint16_t _dataStart = 0;
 
     /**
      * @brief Number of variables stored in each record in the buffer.
      */
-    uint8_t numVariables;
+    uint8_t numVariables = 0;
+
+    /**
+     * @brief The next variable expected in the newest record; equal to
+     * #numVariables once the record is complete.
+     */
+    uint8_t _nextVariable = 0;
+
+    /**
+     * @name Sequential reader state
+     * The reader remembers the last record decoded so reading records in
+     * order doesn't restart from the oldest record each time.
+     */
+    /**@{*/
+    int      _readRecord    = -1;  ///< The last record decoded
+    uint16_t _readPosition  = 0;   ///< Index of the next record to decode
+    uint8_t  _readVariable  = 0;   ///< The variable being decoded
+    uint32_t _readTimestamp = 0;   ///< Timestamp of the last record decoded
+    int32_t  _readQuantized = 0;   ///< Last quantized value of the variable
+    float    _readValue     = MS_INVALID_VALUE;  ///< Last value decoded
+    /**@}*/
+
+    /**
+     * @brief Gets the number of bytes available for records.
+     *
+     * @return The record area size in bytes.
+     */
+    uint16_t getCapacity();
+    /**
+     * @brief Gets the number of bytes used by records.
+     *
+     * @return The bytes between the tail and the head.
+     */
+    uint16_t getBytesUsed();
+    /**
+     * @brief Gets the size of one encoder state: a timestamp and the last
+     * quantized value of each variable.
+     *
+     * @return The state size in bytes.
+     */
+    uint16_t getStateSize();
+    /**
+     * @brief Gets the largest number of bytes one record can take.
+     *
+     * @return The worst-case record size in bytes.
+     */
+    uint16_t getMaxRecordSize();
+    /**
+     * @brief Gets the index of the decoder state of the oldest record.
+     *
+     * @return The index in the buffer.
+     */
+    uint16_t getTailState();
+    /**
+     * @brief Gets the index of the encoder state of the newest record.
+     *
+     * @return The index in the buffer.
+     */
+    uint16_t getHeadState();
+
+    /**
+     * @brief Decodes the oldest record into the decoder state and removes it.
+     *
+     * @param values An array to fill with the record's values, or nullptr to
+     * discard them.
+     * @return The record's timestamp.
+     */
+    uint32_t decodeOldestRecord(float values[]);
+    /**
+     * @brief Fills any values not yet set in the newest record with
+     * #MS_INVALID_VALUE.
+     */
+    void finishRecord();
+    /**
+     * @brief Encodes a value of the next variable onto the head of the buffer.
+     *
+     * @param value The value to encode.
+     */
+    void encodeValue(float value);
+    /**
+     * @brief Decodes a value of a variable and advances past it.
+     *
+     * @param position  The index of the value; advanced past it.
+     * @param variable  The variable the value belongs to.
+     * @param quantized The last quantized value of the variable; updated
+     * with the decoded value.
+     * @return The decoded value.
+     */
+    float decodeValue(uint16_t& position, uint8_t variable, int32_t& quantized);
+    /**
+     * @brief Advances past a value of a variable without decoding it.
+     *
+     * @param position  The index of the value; advanced past it.
+     * @param variable  The variable the value belongs to.
+     */
+    void skipValue(uint16_t& position, uint8_t variable);
+    /**
+     * @brief Moves the reader back to the oldest record.
+     *
+     * @param variable The variable to decode.
+     */
+    void rewindReader(uint8_t variable);
+    /**
+     * @brief Decodes records until the reader holds the given record.
+     *
+     * @param record The record to read.
+     * @param variable The variable to decode.
+     */
+    void readRecord(int record, uint8_t variable);
+
+    /**
+     * @brief Writes a byte to the head of the buffer, wrapping around the
+     * end.
+     *
+     * @param value The byte to write.
+     */
+    void putByte(uint8_t value);
+    /**
+     * @brief Reads a byte from the buffer, wrapping around the end.
+     *
+     * @param position The index to read from; advanced past the byte.
+     * @return The byte read.
+     */
+    uint8_t getByte(uint16_t& position);
+    /**
+     * @brief Writes a varint to the head of the buffer.
+     *
+     * @param value The value to write.
+     */
+    void putVarint(uint32_t value);
+    /**
+     * @brief Writes a raw float to the head of the buffer.
+     *
+     * @param value The value to write.
+     */
+    void putFloat(float value);
+    /**
+     * @brief Reads a varint from the buffer.
+     *
+     * @param position The index to read from; advanced past the varint.
+     * @return The value read.
+     */
+    uint32_t getVarint(uint16_t& position);
+    /**
+     * @brief Reads a raw float from the buffer.
+     *
+     * @param position The index to read from; advanced past the float.
+     * @return The value read.
+     */
+    float getFloat(uint16_t& position);
+    /**
+     * @brief Reads a 32-bit word from the reserved state area.
+     *
+     * @param position The index of the word.
+     * @return The word.
+     */
+    uint32_t getStoredWord(uint16_t position);
+    /**
+     * @brief Writes a 32-bit word to the reserved state area.
+     *
+     * @param position The index of the word.
+     * @param value The word.
+     */
+    void setStoredWord(uint16_t position, uint32_t value);
 };
 
 #endif  // SRC_LOGBUFFER_H_
@@ -59,7 +59,7 @@ bool Logger::_peripheralShutdown = true;
 // Constructors
 Logger::Logger(const char* loggerID, const char* samplingFeatureUUID,
                int16_t loggingIntervalMinutes, int8_t SDCardSSPin,
-               int8_t mcuWakePin, VariableArray* inputArray)
+               int8_t mcuWakePin, VariableArrayBase* inputArray)
     : _SDCardSSPin(SDCardSSPin),
       _mcuWakePin(mcuWakePin) {
     // Set parameters from constructor
@@ -82,7 +82,8 @@ Logger::Logger(const char* loggerID, const char* samplingFeatureUUID,
     SdFile::dateTimeCallback(fileDateTimeCallback);
 }
 Logger::Logger(const char* loggerID, int16_t loggingIntervalMinutes,
-               int8_t SDCardSSPin, int8_t mcuWakePin, VariableArray* inputArray)
+               int8_t SDCardSSPin, int8_t mcuWakePin,
+               VariableArrayBase* inputArray)
     : _SDCardSSPin(SDCardSSPin),
       _mcuWakePin(mcuWakePin) {
     // Set parameters from constructor
@@ -104,7 +105,7 @@ Logger::Logger(const char* loggerID, int16_t loggingIntervalMinutes,
     SdFile::dateTimeCallback(fileDateTimeCallback);
 }
 Logger::Logger(const char* loggerID, const char* samplingFeatureUUID,
-               int16_t loggingIntervalMinutes, VariableArray* inputArray) {
+               int16_t loggingIntervalMinutes, VariableArrayBase* inputArray) {
     // Set parameters from constructor
     setLoggerID(loggerID);
     setSamplingFeatureUUID(samplingFeatureUUID);
@@ -145,7 +146,7 @@ Logger::Logger(const char* loggerID, const char* samplingFeatureUUID,
     SdFile::dateTimeCallback(fileDateTimeCallback);
 }
 Logger::Logger(const char* loggerID, int16_t loggingIntervalMinutes,
-               VariableArray* inputArray) {
+               VariableArrayBase* inputArray) {
     // Set parameters from constructor
     setLoggerID(loggerID);
     setLoggingInterval(loggingIntervalMinutes);
@@ -195,6 +196,39 @@ void Logger::setLoggingInterval(int16_t loggingIntervalMinutes) {
 }
 
 
+// Adds a rule for changing the logging interval
+bool Logger::addSamplingRule(Variable* variable, SamplingTrigger trigger,
+                             float threshold, float hysteresis,
+                             int16_t loggingIntervalMinutes) {
+    if (variable == nullptr ||
+        _samplingRuleCount >= MS_LOGGER_MAX_SAMPLING_RULES) {
+        MS_DBG(F("Unable to add another sampling rule!"));
+        return false;
+    }
+    SamplingRule& rule = _samplingRules[_samplingRuleCount++];
+    rule.variable      = variable;
+    rule.threshold     = threshold;
+    rule.hysteresis    = hysteresis;
+    rule.lastValue     = MS_INVALID_VALUE;
+    rule.lastTime      = 0;
+    rule.interval      = loggingIntervalMinutes;
+    rule.trigger       = trigger;
+    rule.active        = false;
+    return true;
+}
+void Logger::clearSamplingRules() {
+    _samplingRuleCount   = 0;
+    _ruleIntervalMinutes = 0;
+}
+void Logger::setMinimumLoggingInterval(int16_t minimumIntervalMinutes) {
+    _minimumLoggingIntervalMinutes = minimumIntervalMinutes;
+}
+int16_t Logger::getActiveLoggingInterval() {
+    if (_ruleIntervalMinutes <= 0) return _loggingIntervalMinutes;
+    return max(_ruleIntervalMinutes, _minimumLoggingIntervalMinutes);
+}
+
+
 // Sets the number of startup measurements
 void Logger::setStartupMeasurements(int16_t startupMeasurements) {
     _startupMeasurements = startupMeasurements;
@@ -386,7 +420,7 @@ void Logger::enableTestingISR() {
 // ===================================================================== //
 
 // Assigns the variable array object
-void Logger::setVariableArray(VariableArray* inputArray) {
+void Logger::setVariableArray(VariableArrayBase* inputArray) {
     _internalArray = inputArray;
 }
 
@@ -406,19 +440,33 @@ String Logger::getParentSensorNameAndLocationAtI(uint8_t position_i) {
     return _internalArray->arrayOfVars[position_i]
         ->getParentSensorNameAndLocation();
 }
+// This prints the name of the parent sensor, if applicable
+size_t Logger::printParentSensorNameAtI(uint8_t position_i, Stream* stream) {
+    return _internalArray->arrayOfVars[position_i]->printParentSensorName(
+        stream);
+}
 // This gets the variable's name using http://vocabulary.odm2.org/variablename/
 String Logger::getVarNameAtI(uint8_t position_i) {
     return _internalArray->arrayOfVars[position_i]->getVarName();
 }
+const char* Logger::getVarNameCharsAtI(uint8_t position_i) {
+    return _internalArray->arrayOfVars[position_i]->getVarNameChars();
+}
 // This gets the variable's unit using http://vocabulary.odm2.org/units/
 String Logger::getVarUnitAtI(uint8_t position_i) {
     return _internalArray->arrayOfVars[position_i]->getVarUnit();
 }
+const char* Logger::getVarUnitCharsAtI(uint8_t position_i) {
+    return _internalArray->arrayOfVars[position_i]->getVarUnitChars();
+}
 // This returns a customized code for the variable, if one is given, and a
 // default if not
 String Logger::getVarCodeAtI(uint8_t position_i) {
     return _internalArray->arrayOfVars[position_i]->getVarCode();
 }
+const char* Logger::getVarCodeCharsAtI(uint8_t position_i) {
+    return _internalArray->arrayOfVars[position_i]->getVarCodeChars();
+}
 // This returns the variable UUID, if one has been assigned
 String Logger::getVarUUIDStringAtI(uint8_t position_i) {
     return _internalArray->arrayOfVars[position_i]->getVarUUIDString();
@@ -445,6 +493,15 @@ String Logger::getValueStringAtI(uint8_t position_i) {
 String Logger::formatValueStringAtI(uint8_t position_i, float value) {
     return _internalArray->arrayOfVars[position_i]->formatValueString(value);
 }
+// These write the value of the variable into a buffer instead of a String
+uint8_t Logger::getValueCharsAtI(uint8_t position_i, char buffer[]) {
+    return _internalArray->arrayOfVars[position_i]->getValueChars(buffer);
+}
+uint8_t Logger::formatValueCharsAtI(uint8_t position_i, float value,
+                                    char buffer[]) {
+    return _internalArray->arrayOfVars[position_i]->formatValueChars(value,
+                                                                     buffer);
+}
 
 
 // ===================================================================== //
@@ -639,6 +696,11 @@ String Logger::formatDateTime_ISO8601(time_t epochSeconds) {
     return loggerClock::formatDateTime_ISO8601(
         epochSeconds, Logger::_loggerUTCOffset, Logger::_loggerEpoch);
 }
+uint8_t Logger::formatDateTime_ISO8601(char* buffer, time_t epochSeconds) {
+    return loggerClock::formatDateTime_ISO8601(
+        buffer, epochTime(epochSeconds, Logger::_loggerEpoch),
+        Logger::_loggerUTCOffset);
+}
 void Logger::formatDateTime(char* buffer, const char* fmt,
                             time_t epochSeconds) {
     loggerClock::formatDateTime(buffer, fmt, epochSeconds,
@@ -670,7 +732,7 @@ void Logger::markTime() {
 bool Logger::checkInterval() {
     bool     retval;
     uint32_t checkTime = static_cast<uint32_t>(getNowLocalEpoch());
-    int16_t  interval  = _loggingIntervalMinutes;
+    int16_t  interval  = getActiveLoggingInterval();
     if (_startupMeasurements > 0) {
         // log the first few samples at an interval of 1 minute so that
         // operation can be quickly verified in the field
@@ -702,6 +764,8 @@ bool Logger::checkInterval() {
         MS_DBG(F("Time marked at (unix):"),
                static_cast<uint32_t>(Logger::markedLocalUnixTime));
         MS_DBG(F("Time to log!"));
+        // Note if this is a startup record before counting it down
+        _isStartupRecord = (_startupMeasurements > 0);
 #if MS_LOGGERBASE_BUTTON_BENCH_TEST == 0
         if ((_startupMeasurements > 0) && (!testing)) {
 #else
@@ -722,9 +786,76 @@ bool Logger::checkInterval() {
 }
 
 
+// This checks each sampling rule against the values just logged and picks the
+// logging interval for the next record
+void Logger::evaluateSamplingRules() {
+    if (_samplingRuleCount == 0) return;
+    auto    now      = static_cast<uint32_t>(Logger::markedLocalUnixTime);
+    int16_t interval = 0;
+    for (uint8_t i = 0; i < _samplingRuleCount; i++) {
+        SamplingRule& rule  = _samplingRules[i];
+        float         value = rule.variable->getValue();
+        bool valueValid = (value != MS_INVALID_VALUE && !isnan(value));
+
+        // What's compared to the threshold: the value or its hourly rate
+        float compared   = value;
+        bool  comparable = valueValid;
+        if (rule.trigger == SamplingTrigger::RISE_RATE ||
+            rule.trigger == SamplingTrigger::FALL_RATE) {
+            comparable = valueValid && rule.lastValue != MS_INVALID_VALUE &&
+                now > rule.lastTime;
+            if (comparable) {
+                compared = (value - rule.lastValue) * 3600.0f /
+                    static_cast<float>(now - rule.lastTime);
+                // A falling rate is compared as a positive rate of fall
+                if (rule.trigger == SamplingTrigger::FALL_RATE) {
+                    compared = -compared;
+                }
+            }
+            rule.lastValue = valueValid ? value : MS_INVALID_VALUE;
+            rule.lastTime  = now;
+        }
+
+        // Without a value the rule keeps its state
+        if (comparable) {
+            bool below = (rule.trigger == SamplingTrigger::BELOW);
+            if (!rule.active) {
+                rule.active = below ? compared < rule.threshold
+                                    : compared > rule.threshold;
+            } else {
+                rule.active = below
+                    ? compared <= rule.threshold + rule.hysteresis
+                    : compared >= rule.threshold - rule.hysteresis;
+            }
+        }
+        if (rule.active && (interval == 0 || rule.interval < interval)) {
+            interval = rule.interval;
+        }
+    }
+    if (interval != _ruleIntervalMinutes) {
+        _ruleIntervalMinutes = interval;
+        MS_DBG(F("Sampling rules changed the logging interval to"),
+               getActiveLoggingInterval(), F("minutes"));
+    }
+}
+
+
+// This tells the variable array which sensors are due at the marked time
+void Logger::scheduleSensorUpdate() {
+    // Update every sensor for the quick startup measurements and for button
+    // presses, so everything can be checked in the field
+    if (_isStartupRecord || Logger::startTesting) {
+        _internalArray->setUpdateTime(0);
+    } else {
+        _internalArray->setUpdateTime(
+            static_cast<uint32_t>(Logger::markedLocalUnixTime));
+    }
+}
+
+
 // This checks to see if the MARKED time is an even interval of the logging rate
 bool Logger::checkMarkedInterval() {
-    int16_t interval = _loggingIntervalMinutes;
+    int16_t interval = getActiveLoggingInterval();
     // If we're within the range of our startup measurements, we're logging,
     // then set the interval to 1.
     if (_startupMeasurements > 0) { interval = 1; }
@@ -739,6 +870,8 @@ bool Logger::checkMarkedInterval() {
     if (Logger::markedLocalUnixTime != 0 &&
         (Logger::markedLocalUnixTime % (interval * 60) == 0)) {
         MS_DBG(F("Time to log!"));
+        // Note if this is a startup record before counting it down
+        _isStartupRecord = (_startupMeasurements > 0);
         // Decrement the number of startup measurements after marking
         if (_startupMeasurements > 0) {
             MS_DBG(F("Within startup measurements. There are "),
@@ -1250,14 +1383,16 @@ void Logger::generateAutoFileName() {
  * @brief This is a PRE-PROCESSOR MACRO to speed up generating header rows
  *
  * THIS IS NOT A FUNCTION, it is a pre-processor macro
+ *
+ * The second argument is a statement printing the value for variable `i`.
  */
-#define STREAM_CSV_ROW(firstCol, function)                       \
+#define STREAM_CSV_ROW(firstCol, printValue)                     \
     stream->print("\"");                                         \
     stream->print(firstCol);                                     \
     stream->print("\",");                                        \
     for (uint8_t i = 0; i < getArrayVarCount(); i++) {           \
         stream->print("\"");                                     \
-        stream->print(function);                                 \
+        printValue;                                              \
         stream->print("\"");                                     \
         if (i + 1 != getArrayVarCount()) { stream->print(","); } \
     }                                                            \
@@ -1281,11 +1416,11 @@ void Logger::printFileHeader(Stream* stream) {
     }
 
     // Next line will be the parent sensor names
-    STREAM_CSV_ROW(F("Sensor Name:"), getParentSensorNameAtI(i))
+    STREAM_CSV_ROW(F("Sensor Name:"), printParentSensorNameAtI(i, stream))
     // Next comes the ODM2 variable name
-    STREAM_CSV_ROW(F("Variable Name:"), getVarNameAtI(i))
+    STREAM_CSV_ROW(F("Variable Name:"), stream->print(getVarNameCharsAtI(i)))
     // Next comes the ODM2 unit name
-    STREAM_CSV_ROW(F("Result Unit:"), getVarUnitAtI(i))
+    STREAM_CSV_ROW(F("Result Unit:"), stream->print(getVarUnitCharsAtI(i)))
     // Next comes the variable UUIDs
     /// @todo Currrently the file header will always have a UUID row, but it
     /// will be blank if the user doesn't set any UUIDs.  Versions 0.37.0 and
@@ -1293,30 +1428,33 @@ void Logger::printFileHeader(Stream* stream) {
     /// better to only print the UUID row if at least one variable has a UUID
     /// even if that single variable with a UUID isn't the first one.
     STREAM_CSV_ROW(F("Result UUID:"),
-                   getVarUUIDAtI(i) != nullptr ? getVarUUIDAtI(i) : "")
+                   stream->print(getVarUUIDAtI(i) != nullptr ? getVarUUIDAtI(i)
+                                                              : ""))
 
     // We'll finish up with the custom variable codes
-    String dtRowHeader = F("Date and Time in UTC");
-    if (_loggerUTCOffset > 0) {
-        dtRowHeader += '+' + _loggerUTCOffset;
-    } else if (_loggerUTCOffset < 0) {
-        dtRowHeader += _loggerUTCOffset;
+    char dtRowHeader[25] = "Date and Time in UTC";
+    if (_loggerUTCOffset != 0) {
+        snprintf(dtRowHeader + 20, sizeof(dtRowHeader) - 20, "%+d",
+                 _loggerUTCOffset);
     }
-    STREAM_CSV_ROW(dtRowHeader, getVarCodeAtI(i))
+    STREAM_CSV_ROW(dtRowHeader, stream->print(getVarCodeCharsAtI(i)))
 }
 
 
 // This prints a comma separated list of values of sensor data - including the
 // time -  out over an Arduino stream
 void Logger::printVariableValuesCSV(Stream* stream) {
-    String csvString = "";
-    String iso8601   = formatDateTime_ISO8601(Logger::markedLocalUnixTime);
-    iso8601.replace("T", " ");
-    csvString += iso8601.substring(0, 19);
-    csvString += ',';
-    stream->print(csvString);
+    // The date and time without the time zone, with a space for the T
+    char iso8601[loggerClock::ISO8601_BUFFER_SIZE];
+    formatDateTime_ISO8601(iso8601, Logger::markedLocalUnixTime);
+    iso8601[10] = ' ';
+    iso8601[19] = ',';
+    iso8601[20] = '\0';
+    stream->print(iso8601);
+    char value[Variable::VALUE_BUFFER_SIZE];
     for (uint8_t i = 0; i < getArrayVarCount(); i++) {
-        stream->print(getValueStringAtI(i));
+        getValueCharsAtI(i, value);
+        stream->print(value);
         if (i + 1 != getArrayVarCount()) { stream->print(','); }
     }
     stream->println();
@@ -1647,7 +1785,10 @@ void Logger::benchTestingMode(bool sleepBeforeReturning) {
         extendedWatchDog::resetWatchDog();
         // Update the values from all attached sensors
         // NOTE:  Use completeUpdate with all flags false so sensors stay
-        // powered and awake between iterations in testing mode.
+        // powered and awake between iterations in testing mode.  Bench testing
+        // always updates every sensor and doesn't count toward the failing
+        // sensor breakers.
+        _internalArray->setUpdateTime(0, false);
         _internalArray->completeUpdate(false, false, false, false);
         // Print out the current logger time
         PRINTOUT(F("Current logger time is"),
@@ -1701,12 +1842,12 @@ void Logger::benchTestingMode(bool sleepBeforeReturning) {
 // That is, things that require the actual processor/MCU to do something
 // rather than the compiler to do something.
 void Logger::begin(const char* loggerID, int16_t loggingIntervalMinutes,
-                   VariableArray* inputArray) {
+                   VariableArrayBase* inputArray) {
     setLoggerID(loggerID);
     setLoggingInterval(loggingIntervalMinutes);
     begin(inputArray);
 }
-void Logger::begin(VariableArray* inputArray) {
+void Logger::begin(VariableArrayBase* inputArray) {
     setVariableArray(inputArray);
     begin();
 }
@@ -1869,11 +2010,14 @@ void Logger::logData(bool sleepBeforeReturning) {
         // Do a complete sensor update
         MS_DBG(F("    Running a complete sensor update..."));
         extendedWatchDog::resetWatchDog();
+        scheduleSensorUpdate();
         _internalArray->completeUpdate();
         extendedWatchDog::resetWatchDog();
 
         // Create a csv data record and save it to the log file
         logToSD();
+        // Pick the interval for the next record
+        evaluateSamplingRules();
         // Cut power from the SD card, waiting for housekeeping
         turnOffSDcard(true);
 
@@ -1943,11 +2087,14 @@ void Logger::logDataAndPublish(bool sleepBeforeReturning) {
         // run if the sensor was not previously set up.
         MS_DBG(F("Running a complete sensor update..."));
         extendedWatchDog::resetWatchDog();
+        scheduleSensorUpdate();
         _internalArray->completeUpdate();
         extendedWatchDog::resetWatchDog();
 
         // Create a csv data record and save it to the log file
         logToSD();
+        // Pick the interval for the next record
+        evaluateSamplingRules();
 
 // Print out the sensor data
 #if !defined(MS_SILENT)
@@ -66,6 +66,18 @@
 class dataPublisher;  // Forward declaration
 
 
+/**
+ * @brief The conditions a sampling rule can watch a variable for.
+ *
+ * @see Logger::addSamplingRule()
+ */
+enum class SamplingTrigger : uint8_t {
+    ABOVE     = 0,  ///< The value is above the threshold
+    BELOW     = 1,  ///< The value is below the threshold
+    RISE_RATE = 2,  ///< The value is rising faster than the threshold per hour
+    FALL_RATE = 3   ///< The value is falling faster than the threshold per hour
+};
+
 /**
  * @brief The "Logger" Class handles low power sleep for the main processor,
  * interfacing with the real-time clock and modem, writing to the SD card, and
@@ -107,7 +119,7 @@ class Logger {
      */
     Logger(const char* loggerID, const char* samplingFeatureUUID,
            int16_t loggingIntervalMinutes, int8_t SDCardSSPin,
-           int8_t mcuWakePin, VariableArray* inputArray);
+           int8_t mcuWakePin, VariableArrayBase* inputArray);
     /**
      * @brief Construct a new Logger object.
      *
@@ -126,7 +138,8 @@ class Logger {
      * the variable array class.
      */
     Logger(const char* loggerID, int16_t loggingIntervalMinutes,
-           int8_t SDCardSSPin, int8_t mcuWakePin, VariableArray* inputArray);
+           int8_t SDCardSSPin, int8_t mcuWakePin,
+           VariableArrayBase* inputArray);
     /**
      * @brief Construct a new Logger object.
      *
@@ -141,7 +154,7 @@ class Logger {
      * array class.
      */
     Logger(const char* loggerID, const char* samplingFeatureUUID,
-           int16_t loggingIntervalMinutes, VariableArray* inputArray);
+           int16_t loggingIntervalMinutes, VariableArrayBase* inputArray);
     /**
      * @brief Construct a new Logger object.
      *
@@ -167,7 +180,7 @@ class Logger {
      * array class.
      */
     Logger(const char* loggerID, int16_t loggingIntervalMinutes,
-           VariableArray* inputArray);
+           VariableArrayBase* inputArray);
     /**
      * @brief Construct a new Logger object.
      *
@@ -222,6 +235,73 @@ class Logger {
         return _loggingIntervalMinutes;
     }
 
+    /**
+     * @brief Add a rule that changes the logging interval while a variable
+     * meets a condition.
+     *
+     * The rules are checked after every logged record.  A rule becomes active
+     * when the variable's value (or its rate of change per hour, since the
+     * last record) passes the threshold, and stays active until it falls back
+     * past the threshold by more than the hysteresis.  While any rule is
+     * active, the logger logs at the shortest interval of the active rules;
+     * otherwise it logs at the regular logging interval.  A rule's interval
+     * may be shorter than the regular interval, to log faster during an
+     * event, or longer, to save power while nothing is happening.
+     *
+     * For example, to log every minute while the stage is rising by more than
+     * 5 cm per hour or is above 1.2 m:
+     * @code{.cpp}
+     * dataLogger.setLoggingInterval(15);
+     * dataLogger.addSamplingRule(stage, SamplingTrigger::RISE_RATE, 0.05, 0.02,
+     *                            1);
+     * dataLogger.addSamplingRule(stage, SamplingTrigger::ABOVE, 1.2, 0.1, 1);
+     * @endcode
+     *
+     * @param variable The variable to watch.  Its value must be updated by
+     * the logger's variable array.
+     * @param trigger The condition to watch for.
+     * @param threshold The value or rate of change per hour that activates the
+     * rule.
+     * @param hysteresis How far back past the threshold the value or rate
+     * must go to deactivate the rule.
+     * @param loggingIntervalMinutes The logging interval to use while the rule
+     * is active.  Limited by setMinimumLoggingInterval().
+     * @return True if the rule was added; false if there are already
+     * #MS_LOGGER_MAX_SAMPLING_RULES rules.
+     */
+    bool addSamplingRule(Variable* variable, SamplingTrigger trigger,
+                         float threshold, float hysteresis,
+                         int16_t loggingIntervalMinutes);
+    /**
+     * @brief Remove all sampling rules and return to the regular logging
+     * interval.
+     */
+    void clearSamplingRules();
+    /**
+     * @brief Set the shortest logging interval any sampling rule may use.
+     *
+     * This caps how fast the logger can be made to log, and so how much
+     * battery an event can use.  The default is 1 minute.
+     *
+     * @param minimumIntervalMinutes The shortest interval in minutes.
+     */
+    void setMinimumLoggingInterval(int16_t minimumIntervalMinutes);
+    /**
+     * @brief Get the shortest logging interval any sampling rule may use.
+     *
+     * @return The shortest interval in minutes.
+     */
+    int16_t getMinimumLoggingInterval() {
+        return _minimumLoggingIntervalMinutes;
+    }
+    /**
+     * @brief Get the logging interval currently in use - the regular logging
+     * interval, or the interval of the active sampling rules.
+     *
+     * @return The logging interval in minutes
+     */
+    int16_t getActiveLoggingInterval();
+
     /**
      * @brief Set the number of startup measurements to take at 1-minute
      * intervals before beginning logging on the regular logging interval.
@@ -483,6 +563,42 @@ class Logger {
      * for fast field verification
      */
     int16_t _startupMeasurements = 5;
+    /**
+     * @brief True if the record marked by the last interval check is one of
+     * the startup measurements
+     */
+    bool _isStartupRecord = false;
+
+    /**
+     * @brief A condition on a variable that changes the logging interval.
+     */
+    struct SamplingRule {
+        Variable*       variable;    ///< The variable watched
+        float           threshold;   ///< The value or hourly rate to pass
+        float           hysteresis;  ///< The margin to pass back by
+        float           lastValue;   ///< The value in the last record
+        uint32_t        lastTime;    ///< The time of the last record
+        int16_t         interval;    ///< The interval while active, minutes
+        SamplingTrigger trigger;     ///< The condition watched for
+        bool            active;      ///< Whether the rule is active
+    };
+    /**
+     * @brief The sampling rules added with addSamplingRule().
+     */
+    SamplingRule _samplingRules[MS_LOGGER_MAX_SAMPLING_RULES];
+    /**
+     * @brief The number of rules in #_samplingRules.
+     */
+    uint8_t _samplingRuleCount = 0;
+    /**
+     * @brief The logging interval set by the active sampling rules, or 0 to
+     * use the regular logging interval.
+     */
+    int16_t _ruleIntervalMinutes = 0;
+    /**
+     * @brief The shortest logging interval any sampling rule may use.
+     */
+    int16_t _minimumLoggingIntervalMinutes = 1;
     /**
      * @brief Digital pin number on the mcu controlling the SD card slave
      * select.
@@ -583,7 +699,7 @@ class Logger {
      * @param inputArray A pointer to a variable array object instance.  This is
      * NOT an array of variables, but an object of the variable array class.
      */
-    void setVariableArray(VariableArray* inputArray);
+    void setVariableArray(VariableArrayBase* inputArray);
 
     /**
      * @brief Get the number of variables in the internal variable array object.
@@ -611,6 +727,16 @@ class Logger {
      * sensor of that variable, if applicable.
      */
     String getParentSensorNameAndLocationAtI(uint8_t position_i);
+    /**
+     * @brief Print the name of the parent sensor of the variable at the given
+     * position in the internal variable array object, without building a
+     * String.
+     *
+     * @param position_i The position of the variable in the array.
+     * @param stream The stream to print to.
+     * @return The number of characters printed.
+     */
+    size_t printParentSensorNameAtI(uint8_t position_i, Stream* stream);
     /**
      * @brief Get the name of the variable at the given position in the
      * internal variable array object.
@@ -622,6 +748,14 @@ class Logger {
      * @return The variable name
      */
     String getVarNameAtI(uint8_t position_i);
+    /**
+     * @brief Get the name of the variable at the given position in the
+     * internal variable array object as a C-style string.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return The variable name
+     */
+    const char* getVarNameCharsAtI(uint8_t position_i);
     /**
      * @brief Get the unit of the variable at the given position in the
      * internal variable array object.
@@ -633,6 +767,14 @@ class Logger {
      * @return The variable unit
      */
     String getVarUnitAtI(uint8_t position_i);
+    /**
+     * @brief Get the unit of the variable at the given position in the
+     * internal variable array object as a C-style string.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return The variable unit
+     */
+    const char* getVarUnitCharsAtI(uint8_t position_i);
     /**
      * @brief Get the customized code of the variable at the given position in
      * the internal variable array object.
@@ -641,6 +783,14 @@ class Logger {
      * @return The variable code
      */
     String getVarCodeAtI(uint8_t position_i);
+    /**
+     * @brief Get the customized code of the variable at the given position in
+     * the internal variable array object as a C-style string.
+     *
+     * @param position_i The position of the variable in the array.
+     * @return The variable code
+     */
+    const char* getVarCodeCharsAtI(uint8_t position_i);
     /**
      * @brief Get the UUID of the variable at the given position in the internal
      * variable array object.
@@ -700,12 +850,36 @@ class Logger {
      *  significant figures.
      */
     String formatValueStringAtI(uint8_t position_i, float value);
+    /**
+     * @brief Write the most recent value of the variable at the given position
+     * in the internal variable array object into a buffer, without building a
+     * String.
+     *
+     * @param position_i The position of the variable in the array.
+     * @param buffer A buffer of at least Variable::VALUE_BUFFER_SIZE
+     * characters.
+     * @return The number of characters written, not counting the null.
+     */
+    uint8_t getValueCharsAtI(uint8_t position_i, char buffer[]);
+    /**
+     * @brief Write a particular value of the variable at the given position in
+     * the internal variable array object into a buffer, without building a
+     * String.
+     *
+     * @param position_i The position of the variable in the array.
+     * @param value The value to format.
+     * @param buffer A buffer of at least Variable::VALUE_BUFFER_SIZE
+     * characters.
+     * @return The number of characters written, not counting the null.
+     */
+    uint8_t formatValueCharsAtI(uint8_t position_i, float value,
+                                char buffer[]);
 
  protected:
     /**
      * @brief A pointer to the internal variable array instance
      */
-    VariableArray* _internalArray;
+    VariableArrayBase* _internalArray;
     /**@}*/
 
     // ===================================================================== //
@@ -916,6 +1090,22 @@ class Logger {
      * @return An ISO8601 formatted String.
      */
     static String formatDateTime_ISO8601(time_t epochSeconds);
+    /**
+     * @brief Convert an epoch time into a ISO8601 formatted string in the
+     * given buffer, without building a String.
+     *
+     * This assumes the supplied date/time is in the LOGGER's timezone and the
+     * LOGGER's epoch start.  Formatting the same time again, or another time
+     * on the same day, reuses the last result; see
+     * loggerClock::formatDateTime_ISO8601(char*, epochTime, int8_t).
+     *
+     * @param buffer A buffer of at least loggerClock::ISO8601_BUFFER_SIZE
+     * characters.
+     * @param epochSeconds The number of seconds since the start of the logger's
+     * epoch (#MS_LOGGER_EPOCH).
+     * @return The number of characters written, not counting the null.
+     */
+    static uint8_t formatDateTime_ISO8601(char* buffer, time_t epochSeconds);
 
     /**
      * @brief Convert an epoch time into a character string based on the input
@@ -1006,6 +1196,20 @@ class Logger {
     bool checkMarkedInterval();
 
  protected:
+    /**
+     * @brief Tell the variable array which sensors are due to be updated at
+     * the marked time, based on each sensor's own logging interval.
+     *
+     * Every sensor is updated during the startup measurements and when
+     * logging was started by the testing button.
+     */
+    void scheduleSensorUpdate();
+    /**
+     * @brief Check the sampling rules against the values just logged and set
+     * the logging interval for the next record.
+     */
+    void evaluateSamplingRules();
+
     /**
      * @brief The static timezone data is being logged in.
      *
@@ -1487,7 +1691,7 @@ class Logger {
      * value given in the constructor.
      */
     virtual void begin(const char* loggerID, int16_t loggingIntervalMinutes,
-                       VariableArray* inputArray);
+                       VariableArrayBase* inputArray);
     /**
      * @brief Set all pin levels and does initial communication with the
      * real-time clock and SD card to prepare the logger for full functionality.
@@ -1500,7 +1704,7 @@ class Logger {
      * array class.  Supplying a variableArray object here will override any
      * value given in the constructor.
      */
-    virtual void begin(VariableArray* inputArray);
+    virtual void begin(VariableArrayBase* inputArray);
     /**
      * @brief Set all pin levels and does initial communication with the
      * real-time clock and SD card to prepare the logger for full functionality.
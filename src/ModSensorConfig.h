@@ -131,6 +131,189 @@ static_assert(MAX_NUMBER_VARS > 0 && MAX_NUMBER_VARS <= 21,
 // Static assert to ensure the maximum number of sensors is reasonable
 static_assert(MAX_NUMBER_SENSORS > 0 && MAX_NUMBER_SENSORS <= 50,
               "MAX_NUMBER_SENSORS must be between 1 and 50");
+
+#if !defined(MAX_NUMBER_CALCULATED_VARS) || defined(DOXYGEN)
+/**
+ * @def MAX_NUMBER_CALCULATED_VARS
+ * @brief The largest number of calculated variables in a single variable array
+ * that will be evaluated in dependency order.
+ *
+ * Each variable array keeps a one byte entry per calculated variable for the
+ * order to evaluate them in.  If an array has more calculated variables than
+ * this, they are evaluated in array order, as they are when none declare
+ * their inputs with Variable::setInputs().
+ */
+#define MAX_NUMBER_CALCULATED_VARS 10
+#endif
+// Static assert to ensure the maximum number of calculated variables is
+// reasonable
+static_assert(MAX_NUMBER_CALCULATED_VARS > 0 &&
+                  MAX_NUMBER_CALCULATED_VARS <= 100,
+              "MAX_NUMBER_CALCULATED_VARS must be between 1 and 100");
+//==============================================================
+
+
+//==============================================================
+// Variable array update scheduling
+//==============================================================
+#if !defined(MS_VARIABLEARRAY_IDLE_BETWEEN_EVENTS) || defined(DOXYGEN)
+/**
+ * @def MS_VARIABLEARRAY_IDLE_BETWEEN_EVENTS
+ * @brief Idle the processor between sensor events during a variable array
+ * update.
+ *
+ * When enabled, after each pass through the sensor list the variable array
+ * asks every unfinished sensor how long it is until its next warm-up,
+ * stabilization, or measurement deadline and idles the processor until the
+ * earliest of them instead of immediately polling the sensors again.  Sensors
+ * whose timing isn't known ahead of time are still polled on every pass.
+ *
+ * The processor is put in its lightest sleep mode (IDLE on AVR, WFI without
+ * deep sleep on SAMD) so the millis() timer, serial ports, and pin change
+ * interrupts keep running.  When disabled (default), the sensors are polled
+ * continuously.
+ */
+#define MS_VARIABLEARRAY_IDLE_BETWEEN_EVENTS false
+#endif
+
+#if !defined(MS_VARIABLEARRAY_MAX_IDLE_MS) || defined(DOXYGEN)
+/**
+ * @def MS_VARIABLEARRAY_MAX_IDLE_MS
+ * @brief The longest time in milliseconds the variable array will idle before
+ * checking on the sensors again, when #MS_VARIABLEARRAY_IDLE_BETWEEN_EVENTS is
+ * enabled.
+ */
+#define MS_VARIABLEARRAY_MAX_IDLE_MS 5000
+#endif
+// Static assert to validate the maximum idle time is reasonable
+static_assert(MS_VARIABLEARRAY_MAX_IDLE_MS > 0 &&
+                  MS_VARIABLEARRAY_MAX_IDLE_MS <= 60000,
+              "MS_VARIABLEARRAY_MAX_IDLE_MS must be between 1 and 60000 ms");
+
+#if !defined(MS_VARIABLEARRAY_TRACE_SIZE) || defined(DOXYGEN)
+/**
+ * @def MS_VARIABLEARRAY_TRACE_SIZE
+ * @brief The number of sensor phase events kept in the trace of each variable
+ * array, or 0 to disable tracing.
+ *
+ * When enabled, the variable array stamps each power up, wake, measurement
+ * start, measurement result, sleep, and power down of each sensor, and the
+ * start and end of each complete update, into a ring of this many events.
+ * The trace can be printed as CSV with VariableArray::printPhaseTraceCSV() or
+ * as Chrome trace JSON (for chrome://tracing or Perfetto) with
+ * VariableArray::printPhaseTraceJSON().  Each event takes 8 bytes of RAM.
+ */
+#define MS_VARIABLEARRAY_TRACE_SIZE 0
+#endif
+// Static assert to validate the trace size is reasonable
+static_assert(MS_VARIABLEARRAY_TRACE_SIZE >= 0 &&
+                  MS_VARIABLEARRAY_TRACE_SIZE <= 255,
+              "MS_VARIABLEARRAY_TRACE_SIZE must be between 0 and 255");
+//==============================================================
+
+
+//==============================================================
+// Adaptive sensor timing
+//==============================================================
+#if !defined(MS_ADAPTIVE_TIMING_MIN_PERCENT) || defined(DOXYGEN)
+/**
+ * @def MS_ADAPTIVE_TIMING_MIN_PERCENT
+ * @brief The shortest warm-up or stabilization time adaptive timing will try,
+ * as a percent of the datasheet value.
+ *
+ * @see Sensor::enableAdaptiveTiming()
+ */
+#define MS_ADAPTIVE_TIMING_MIN_PERCENT 25
+#endif
+// Static assert to validate the minimum percent is reasonable
+static_assert(MS_ADAPTIVE_TIMING_MIN_PERCENT >= 0 &&
+                  MS_ADAPTIVE_TIMING_MIN_PERCENT <= 100,
+              "MS_ADAPTIVE_TIMING_MIN_PERCENT must be between 0 and 100");
+
+#if !defined(MS_ADAPTIVE_TIMING_STEP_PERCENT) || defined(DOXYGEN)
+/**
+ * @def MS_ADAPTIVE_TIMING_STEP_PERCENT
+ * @brief How much adaptive timing shortens the warm-up and stabilization times
+ * after each clean update, as a percent of the datasheet value.
+ *
+ * After a failure, the shortest time that will be tried again is this much
+ * longer than the time that failed.
+ */
+#define MS_ADAPTIVE_TIMING_STEP_PERCENT 10
+#endif
+// Static assert to validate the step percent is reasonable
+static_assert(MS_ADAPTIVE_TIMING_STEP_PERCENT >= 1 &&
+                  MS_ADAPTIVE_TIMING_STEP_PERCENT <= 50,
+              "MS_ADAPTIVE_TIMING_STEP_PERCENT must be between 1 and 50");
+
+#if !defined(MS_ADAPTIVE_TIMING_TOLERANCE_PERCENT) || defined(DOXYGEN)
+/**
+ * @def MS_ADAPTIVE_TIMING_TOLERANCE_PERCENT
+ * @brief How far, in percent, the first valid value of an update may be from
+ * the mean of the later values before adaptive timing decides the sensor
+ * wasn't stable yet.
+ */
+#define MS_ADAPTIVE_TIMING_TOLERANCE_PERCENT 5
+#endif
+// Static assert to validate the tolerance is reasonable
+static_assert(MS_ADAPTIVE_TIMING_TOLERANCE_PERCENT >= 0 &&
+                  MS_ADAPTIVE_TIMING_TOLERANCE_PERCENT <= 100,
+              "MS_ADAPTIVE_TIMING_TOLERANCE_PERCENT must be between 0 and 100");
+//==============================================================
+
+
+//==============================================================
+// Failing sensor circuit breaker
+//==============================================================
+#if !defined(MS_SENSOR_BREAKER_THRESHOLD) || defined(DOXYGEN)
+/**
+ * @def MS_SENSOR_BREAKER_THRESHOLD
+ * @brief The default number of update cycles in a row a sensor must fail
+ * before the variable array starts skipping it.
+ *
+ * Set this to 0 (the default) to never skip failing sensors unless
+ * Sensor::setBreakerThreshold() is called for them.
+ */
+#define MS_SENSOR_BREAKER_THRESHOLD 0
+#endif
+// Static assert to validate the threshold fits in a uint8_t
+static_assert(MS_SENSOR_BREAKER_THRESHOLD >= 0 &&
+                  MS_SENSOR_BREAKER_THRESHOLD <= 255,
+              "MS_SENSOR_BREAKER_THRESHOLD must be between 0 and 255");
+
+#if !defined(MS_SENSOR_BREAKER_MAX_SKIPS) || defined(DOXYGEN)
+/**
+ * @def MS_SENSOR_BREAKER_MAX_SKIPS
+ * @brief The most update cycles in a row a failing sensor will be skipped
+ * before it is tried again.
+ *
+ * A failing sensor is first skipped for one cycle, and the number of cycles
+ * doubles each time it fails again, up to this limit.
+ */
+#define MS_SENSOR_BREAKER_MAX_SKIPS 64
+#endif
+// Static assert to validate the maximum skip fits in a uint8_t
+static_assert(MS_SENSOR_BREAKER_MAX_SKIPS >= 1 &&
+                  MS_SENSOR_BREAKER_MAX_SKIPS <= 255,
+              "MS_SENSOR_BREAKER_MAX_SKIPS must be between 1 and 255");
+
+#if !defined(MS_MAX_SAMPLES_TO_AGGREGATE) || defined(DOXYGEN)
+/**
+ * @def MS_MAX_SAMPLES_TO_AGGREGATE
+ * @brief The most valid values a sensor can keep in one update, across all of
+ * its results, for an aggregation method other than the mean.
+ *
+ * Every sensor has a buffer of this many floats.  A sensor returning 2
+ * values with 5 measurements to average needs 10.  Lower this to save 4 bytes
+ * of RAM per sensor for each value if no sensor uses Sensor::
+ * setAggregationMethod().
+ */
+#define MS_MAX_SAMPLES_TO_AGGREGATE 16
+#endif
+// Static assert to validate the buffer size fits in a uint8_t
+static_assert(MS_MAX_SAMPLES_TO_AGGREGATE >= 1 &&
+                  MS_MAX_SAMPLES_TO_AGGREGATE <= 255,
+              "MS_MAX_SAMPLES_TO_AGGREGATE must be between 1 and 255");
 //==============================================================
 
 
@@ -152,6 +335,28 @@ static_assert(MAX_NUMBER_SENSORS > 0 && MAX_NUMBER_SENSORS <= 50,
 //==============================================================
 
 
+//==============================================================
+// Event-triggered sampling
+//==============================================================
+#if !defined(MS_LOGGER_MAX_SAMPLING_RULES) || defined(DOXYGEN)
+/**
+ * @def MS_LOGGER_MAX_SAMPLING_RULES
+ * @brief The largest number of rules a logger can use to change its logging
+ * interval.
+ *
+ * Each rule takes about 24 bytes of RAM.
+ *
+ * @see Logger::addSamplingRule()
+ */
+#define MS_LOGGER_MAX_SAMPLING_RULES 4
+#endif
+// Static assert to validate the number of sampling rules is reasonable
+static_assert(MS_LOGGER_MAX_SAMPLING_RULES > 0 &&
+                  MS_LOGGER_MAX_SAMPLING_RULES <= 16,
+              "MS_LOGGER_MAX_SAMPLING_RULES must be between 1 and 16");
+//==============================================================
+
+
 //==============================================================
 // SPI Configuration, iff needed
 //==============================================================
@@ -373,9 +578,12 @@ static_assert(MAX_NUMBER_SENDERS >= 0 && MAX_NUMBER_SENDERS <= 16,
  * @brief Log Data Buffer
  *
  * This determines how much RAM is reserved to buffer log records before
- * transmission. Each record consumes 4 bytes for the timestamp plus 4 bytes
- * for each logged variable. Increasing this value too far can crash the
- * device! The number of log records buffered is controlled by sendEveryX.
+ * transmission. Records are delta encoded, so a record usually takes about 2
+ * bytes for the timestamp plus 1-3 bytes for each logged variable, and never
+ * more than 5 bytes for the timestamp and each variable. Another 9 bytes per
+ * variable are reserved for the encoder. Increasing this value too far can
+ * crash the device! The number of log records buffered is controlled by
+ * sendEveryX.
  *
  * For supported boards, appropriate defaults are set in KnownProcessors.h:
  * - ATmega1284p (Mayfly): 8192 bytes
@@ -398,6 +606,57 @@ static_assert(MS_LOG_DATA_BUFFER_SIZE >= 64 && MS_LOG_DATA_BUFFER_SIZE <= 16384,
               "MS_LOG_DATA_BUFFER_SIZE must be between 64 and 16384 bytes");
 
 
+#if !defined(MS_LOG_BUFFER_DROP_OLDEST) || defined(DOXYGEN)
+/**
+ * @def MS_LOG_BUFFER_DROP_OLDEST
+ * @brief Drop the oldest buffered records when the log data buffer is full.
+ *
+ * If true, the oldest records in the log data buffer are discarded to make
+ * room for each new record when the buffer is full, so the most recent data
+ * is always kept through an outage. If false, new records are refused until
+ * the buffer has been transmitted. This sets the default for every buffer; it
+ * can be changed at run time with LogBuffer::setDropOldest(bool).
+ */
+#define MS_LOG_BUFFER_DROP_OLDEST true
+#endif
+
+#if !defined(MS_MAX_RECORDS_PER_POST) || defined(DOXYGEN)
+/**
+ * @def MS_MAX_RECORDS_PER_POST
+ * @brief The maximum number of buffered records sent in a single request.
+ *
+ * When more records than this are buffered, they are sent oldest first in
+ * several requests of at most this many records. Each chunk is removed from
+ * the buffer as soon as the server acknowledges it, so a failed request only
+ * leaves the unacknowledged records to be retried.
+ */
+#define MS_MAX_RECORDS_PER_POST 50
+#endif
+// Static assert to validate the chunk size is reasonable
+static_assert(MS_MAX_RECORDS_PER_POST >= 1 && MS_MAX_RECORDS_PER_POST <= 1000,
+              "MS_MAX_RECORDS_PER_POST must be between 1 and 1000");
+
+#if !defined(MS_MMW_USE_CHUNKED_TRANSFER) || defined(DOXYGEN)
+/**
+ * @def MS_MMW_USE_CHUNKED_TRANSFER
+ * @brief Send data to Monitor My Watershed with chunked transfer encoding.
+ *
+ * By default, the Monitor My Watershed publisher formats every buffered value
+ * once to calculate the Content-Length of a request and then again to send
+ * it. With chunked transfer encoding, the JSON body is sent in chunks of
+ * #MS_SEND_BUFFER_SIZE as it is formatted, so each value is only formatted
+ * once and the modem is on for less time. This requires the server to accept
+ * chunked request bodies, as HTTP/1.1 servers should.
+ *
+ * This is off by default because a server or proxy that doesn't accept a
+ * chunked body answers 411 (Length Required), and the records stay buffered
+ * until the buffer overflows.  Turn it on once posts with it have been seen
+ * to succeed on the deployment's network.
+ */
+#define MS_MMW_USE_CHUNKED_TRANSFER false
+#endif
+
+
 #if !defined(MS_SEND_BUFFER_SIZE) || defined(DOXYGEN)
 /**
  * @def MS_SEND_BUFFER_SIZE
@@ -38,6 +38,11 @@ Sensor::Sensor(const char* sensorName, const uint8_t totalReturnedValues,
     }
 }
 
+// Destructor
+Sensor::~Sensor() {
+    delete[] _statistics;
+}
+
 
 // This gets the place the sensor is installed ON THE MAYFLY (i.e., pin number)
 String Sensor::getSensorLocation() {
@@ -53,6 +58,9 @@ String Sensor::getSensorLocation() {
 String Sensor::getSensorName() {
     return _sensorName;
 }
+size_t Sensor::printSensorName(Stream* stream) {
+    return stream->print(_sensorName);
+}
 
 
 // This concatenates and returns the name and location.
@@ -83,6 +91,12 @@ void Sensor::setSecondaryPowerPin(int8_t pin) {
 // Generally these values should be set in the constructor
 void Sensor::setNumberMeasurementsToAverage(uint8_t nReadings) {
     _measurementsToAverage = nReadings;
+    // Re-divide the value buffer for the aggregation method, if it's used
+    if (_sampleCapacity > 0 && !fitSamples()) {
+        MS_DBG(F("Too many values to keep for"), getSensorNameAndLocation(),
+               F("; using the mean."));
+        _aggregation = MeasurementAggregation::MEAN;
+    }
 }
 uint8_t Sensor::getNumberMeasurementsToAverage() {
     return _measurementsToAverage;
@@ -101,14 +115,60 @@ uint8_t Sensor::getMaxRetries() {
 }
 
 
+void Sensor::setLoggingInterval(uint16_t loggingIntervalMinutes) {
+    _loggingInterval_min = loggingIntervalMinutes;
+}
+uint16_t Sensor::getLoggingInterval() {
+    return _loggingInterval_min;
+}
+bool Sensor::isDueAt(uint32_t localEpoch) {
+    if (_loggingInterval_min == 0 || localEpoch == 0) return true;
+    return localEpoch % (static_cast<uint32_t>(_loggingInterval_min) * 60) ==
+        0;
+}
+
+
+void Sensor::setBreakerThreshold(uint8_t failedCycles) {
+    _breakerThreshold = failedCycles;
+    // Turning the breaker off returns a skipped sensor to normal
+    if (failedCycles == 0) {
+        _breakerSkips = 0;
+        _cyclesToSkip = 0;
+    }
+}
+uint8_t Sensor::getBreakerThreshold() {
+    return _breakerThreshold;
+}
+uint8_t Sensor::getFailedCycles() {
+    return _failedCycles;
+}
+uint8_t Sensor::getBreakerState() {
+    return _breakerSkips;
+}
+bool Sensor::isBreakerOpen() {
+    return _cyclesToSkip > 0;
+}
+
+
 void Sensor::setWarmUpTime(uint32_t warmUpTime_ms) {
     _warmUpTime_ms = warmUpTime_ms;
+    // A new datasheet value; start learning again from it
+    if (_adaptiveTiming.enabled) {
+        _adaptiveTiming.warmUpLimit_ms = warmUpTime_ms;
+        _adaptiveTiming.warmUpFloor_ms =
+            warmUpTime_ms * MS_ADAPTIVE_TIMING_MIN_PERCENT / 100;
+    }
 }
 uint32_t Sensor::getWarmUpTime() {
     return _warmUpTime_ms;
 }
 void Sensor::setStabilizationTime(uint32_t stabilizationTime_ms) {
     _stabilizationTime_ms = stabilizationTime_ms;
+    if (_adaptiveTiming.enabled) {
+        _adaptiveTiming.stabilizationLimit_ms = stabilizationTime_ms;
+        _adaptiveTiming.stabilizationFloor_ms =
+            stabilizationTime_ms * MS_ADAPTIVE_TIMING_MIN_PERCENT / 100;
+    }
 }
 uint32_t Sensor::getStabilizationTime() {
     return _stabilizationTime_ms;
@@ -376,8 +436,11 @@ void Sensor::clearValues() {
 void Sensor::resetMeasurementCounts() {
     MS_DBG(F("Resetting measurement counts for"), getSensorNameAndLocation());
     // Reset measurement attempt counters
-    _completedMeasurements = 0;
-    _currentRetries        = 0;
+    _completedMeasurements    = 0;
+    _currentRetries           = 0;
+    _cycleSuccesses           = 0;
+    _adaptiveTiming.successes = 0;
+    _adaptiveTiming.failures  = 0;
 }
 
 // This clears power-related status bits and resets power timing.
@@ -429,15 +492,28 @@ void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
         MS_DBG(F("Putting"), resultValue, F("in result array for variable"),
                resultNumber, F("from"), getSensorNameAndLocation());
         sensorValues[resultNumber] = resultValue;
-        validCount[resultNumber] += 1;
+        validCount[resultNumber]   = 1;
+        _adaptiveTiming.firstValues[resultNumber] = resultValue;
+        if (_statistics != nullptr) {
+            _statistics[resultNumber].m2  = 0;
+            _statistics[resultNumber].min = resultValue;
+            _statistics[resultNumber].max = resultValue;
+        }
     } else if (prevResultGood && newResultGood) {
         // If the new result is good and there were already good results in
-        // place add the new results to the total and add 1 to the good result
-        // total
+        // place, fold the new result into the running mean (Welford's method)
+        // rather than summing, so large values don't lose precision.
         MS_DBG(F("Adding"), resultValue, F("to result array for variable"),
                resultNumber, F("from"), getSensorNameAndLocation());
-        sensorValues[resultNumber] += resultValue;
         validCount[resultNumber] += 1;
+        float delta = resultValue - sensorValues[resultNumber];
+        sensorValues[resultNumber] += delta / validCount[resultNumber];
+        if (_statistics != nullptr) {
+            ResultStatistics& stats = _statistics[resultNumber];
+            stats.m2 += delta * (resultValue - sensorValues[resultNumber]);
+            if (resultValue < stats.min) stats.min = resultValue;
+            if (resultValue > stats.max) stats.max = resultValue;
+        }
     } else if (!prevResultGood && !newResultGood) {
         // If the new result is bad and there were only bad results, only print
         // debugging
@@ -450,6 +526,11 @@ void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
                getSensorNameAndLocation(),
                F("; good results already in array."));
     }
+    // Keep the good value for aggregation methods that need all of them
+    if (newResultGood && validCount[resultNumber] <= _sampleCapacity) {
+        _samples[resultNumber * _sampleCapacity + validCount[resultNumber] -
+                 1] = resultValue;
+    }
 }
 /// @todo Fix measurement value array to handle int16_t and int32_t directly so
 /// no casting is needed and large values will not be truncated or mashed.
@@ -467,12 +548,345 @@ void Sensor::verifyAndAddMeasurementResult(uint8_t resultNumber,
 
 
 void Sensor::averageMeasurements() {
-    MS_DBG(F("Averaging results from"), getSensorNameAndLocation(), F("over"),
+    // NOTE: The values are already running means; nothing to divide.
+    MS_DBG(F("Averaged results from"), getSensorNameAndLocation(), F("over"),
            _measurementsToAverage, F("reading[s]"));
     for (uint8_t i = 0; i < _numReturnedValues; i++) {
-        if (validCount[i] > 0) sensorValues[i] /= validCount[i];
-        MS_DBG(F("    ->Result #"), i, ':', sensorValues[i]);
+        if (_sampleCapacity > 0 &&
+            _aggregation != MeasurementAggregation::MEAN &&
+            validCount[i] > 0) {
+            uint8_t n      = min(validCount[i], _sampleCapacity);
+            float*  values = _samples + i * _sampleCapacity;
+            // Insertion sort; there are only a handful of values
+            for (uint8_t j = 1; j < n; j++) {
+                float   v = values[j];
+                int16_t k = j - 1;
+                while (k >= 0 && values[k] > v) {
+                    values[k + 1] = values[k];
+                    k--;
+                }
+                values[k + 1] = v;
+            }
+            sensorValues[i] = aggregateSorted(values, n, _aggregation);
+        }
+        MS_DBG(F("    ->Result #"), i, ':', sensorValues[i], F("from"),
+               validCount[i], F("valid value[s]"));
+    }
+    adaptTiming(true);
+}
+
+
+bool Sensor::setAggregationMethod(MeasurementAggregation method) {
+    if (method == MeasurementAggregation::MEAN) {
+        // The running mean doesn't need the individual values
+        _sampleCapacity = 0;
+    } else if (!fitSamples()) {
+        MS_DBG(F("Too many values to keep for"), getSensorNameAndLocation(),
+               F("; using the mean."));
+        _aggregation = MeasurementAggregation::MEAN;
+        return false;
+    }
+    _aggregation = method;
+    return true;
+}
+MeasurementAggregation Sensor::getAggregationMethod() {
+    return _aggregation;
+}
+
+
+bool Sensor::fitSamples() {
+    uint8_t capacity = _measurementsToAverage > 0 ? _measurementsToAverage : 1;
+    if (_numReturnedValues * capacity > MS_MAX_SAMPLES_TO_AGGREGATE) {
+        _sampleCapacity = 0;
+        return false;
+    }
+    _sampleCapacity = capacity;
+    return true;
+}
+
+
+float Sensor::aggregateSorted(const float sorted[], uint8_t n,
+                              MeasurementAggregation method) {
+    float median = (n % 2) ? sorted[n / 2]
+                           : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    float   sum  = 0;
+    uint8_t kept = 0;
+    switch (method) {
+        case MeasurementAggregation::MEDIAN: return median;
+        case MeasurementAggregation::TRIMMED_MEAN: {
+            uint8_t trim = n / 4;
+            if (trim == 0 && n >= 3) { trim = 1; }
+            for (uint8_t j = trim; j < n - trim; j++) {
+                sum += sorted[j];
+                kept++;
+            }
+            return sum / kept;
+        }
+        case MeasurementAggregation::MAD_FILTERED_MEAN: {
+            float mad = (n % 2) ? kthDeviation(sorted, n, median, n / 2)
+                                : (kthDeviation(sorted, n, median, n / 2 - 1) +
+                                   kthDeviation(sorted, n, median, n / 2)) /
+                    2;
+            // 1.4826 scales the MAD to a standard deviation for normal data.
+            // The value closest to the median is always within one MAD, so at
+            // least one value is kept.
+            float limit = 3 * 1.4826f * mad;
+            for (uint8_t j = 0; j < n; j++) {
+                if (fabs(sorted[j] - median) <= limit) {
+                    sum += sorted[j];
+                    kept++;
+                }
+            }
+            return sum / kept;
+        }
+        default: {
+            for (uint8_t j = 0; j < n; j++) { sum += sorted[j]; }
+            return sum / n;
+        }
+    }
+}
+
+
+float Sensor::kthDeviation(const float sorted[], uint8_t n, float center,
+                           uint8_t k) {
+    // Deviations grow walking down from the center on the low side and walking
+    // up on the high side; merge the two runs until reaching rank k.
+    int16_t hi = 0;
+    while (hi < n && sorted[hi] < center) { hi++; }
+    int16_t lo        = hi - 1;
+    float   deviation = 0;
+    for (uint8_t rank = 0; rank <= k; rank++) {
+        if (hi >= n || (lo >= 0 && center - sorted[lo] <= sorted[hi] - center)) {
+            deviation = center - sorted[lo--];
+        } else {
+            deviation = sorted[hi++] - center;
+        }
+    }
+    return deviation;
+}
+
+
+// This allocates the per-result statistics the first time it's called
+bool Sensor::enableStatistics() {
+    if (_statistics != nullptr) return true;
+    _statistics = new ResultStatistics[_numReturnedValues];
+    if (_statistics == nullptr) {
+        MS_DBG(F("Unable to allocate statistics for"),
+               getSensorNameAndLocation());
+        return false;
+    }
+    // Seed from the current values; the statistics will be complete from the
+    // next update on.
+    for (uint8_t i = 0; i < _numReturnedValues; i++) {
+        _statistics[i].m2  = 0;
+        _statistics[i].min = sensorValues[i];
+        _statistics[i].max = sensorValues[i];
+    }
+    return true;
+}
+
+
+// This starts learning from the current times the first time it's called
+bool Sensor::enableAdaptiveTiming() {
+    if (_adaptiveTiming.enabled) return true;
+    // The current times are the datasheet values to learn from
+    _adaptiveTiming.warmUpLimit_ms        = _warmUpTime_ms;
+    _adaptiveTiming.stabilizationLimit_ms = _stabilizationTime_ms;
+    _adaptiveTiming.warmUpFloor_ms =
+        _warmUpTime_ms * MS_ADAPTIVE_TIMING_MIN_PERCENT / 100;
+    _adaptiveTiming.stabilizationFloor_ms =
+        _stabilizationTime_ms * MS_ADAPTIVE_TIMING_MIN_PERCENT / 100;
+    _adaptiveTiming.enabled = true;
+    return true;
+}
+
+
+bool Sensor::getLearnedTiming(LearnedTiming& timing) {
+    if (!_adaptiveTiming.enabled) return false;
+    timing.warmUpTime_ms         = _warmUpTime_ms;
+    timing.stabilizationTime_ms  = _stabilizationTime_ms;
+    timing.warmUpFloor_ms        = _adaptiveTiming.warmUpFloor_ms;
+    timing.stabilizationFloor_ms = _adaptiveTiming.stabilizationFloor_ms;
+    return true;
+}
+
+
+// Limits a learned time to between the smallest allowed fraction of the
+// datasheet value and the datasheet value
+static uint32_t boundLearnedTime(uint32_t learned, uint32_t limit) {
+    uint32_t lowest = limit * MS_ADAPTIVE_TIMING_MIN_PERCENT / 100;
+    if (learned < lowest) return lowest;
+    if (learned > limit) return limit;
+    return learned;
+}
+
+
+bool Sensor::setLearnedTiming(const LearnedTiming& timing) {
+    if (!_adaptiveTiming.enabled) return false;
+    AdaptiveTiming& at = _adaptiveTiming;
+    at.warmUpFloor_ms = boundLearnedTime(timing.warmUpFloor_ms,
+                                         at.warmUpLimit_ms);
+    at.stabilizationFloor_ms = boundLearnedTime(timing.stabilizationFloor_ms,
+                                                at.stabilizationLimit_ms);
+    _warmUpTime_ms = max(at.warmUpFloor_ms,
+                         boundLearnedTime(timing.warmUpTime_ms,
+                                          at.warmUpLimit_ms));
+    _stabilizationTime_ms =
+        max(at.stabilizationFloor_ms,
+            boundLearnedTime(timing.stabilizationTime_ms,
+                             at.stabilizationLimit_ms));
+    MS_DBG(F("Restored learned warm-up of"), _warmUpTime_ms,
+           F("ms and stabilization of"), _stabilizationTime_ms, F("ms for"),
+           getSensorNameAndLocation());
+    return true;
+}
+
+
+// The amount a learned time is shortened by after each clean update
+static uint32_t adaptiveTimingStep(uint32_t limit) {
+    uint32_t step = limit * MS_ADAPTIVE_TIMING_STEP_PERCENT / 100;
+    return step > 0 ? step : 1;
+}
+
+
+// This shortens the waits one step after a clean update and puts them back to
+// the datasheet values after anything goes wrong
+void Sensor::adaptTiming(bool wakeSucceeded) {
+    if (!_adaptiveTiming.enabled) return;
+    AdaptiveTiming& at = _adaptiveTiming;
+
+    // A failed wake, or not a single good measurement, means the sensor
+    // wasn't warmed up
+    bool warmUpFailed = !wakeSucceeded || at.successes == 0;
+    // A failed measurement attempt, or a first reading that doesn't match the
+    // ones after it, means the sensor wasn't stable yet
+    bool stabilizationFailed = at.failures > 0;
+    for (uint8_t i = 0; i < _numReturnedValues && !stabilizationFailed; i++) {
+        uint8_t n = validCount[i];
+        if (n < 2) continue;
+        float first = at.firstValues[i];
+        // The mean of the later readings, backed out of the running mean
+        float rest = (sensorValues[i] * n - first) / (n - 1);
+        if (_sampleCapacity > 0 &&
+            _aggregation != MeasurementAggregation::MEAN) {
+            // The result isn't the running mean; use the kept samples
+            uint8_t kept = min(n, _sampleCapacity);
+            if (kept < 2) continue;
+            float   sum  = 0;
+            for (uint8_t j = 0; j < kept; j++) {
+                sum += _samples[i * _sampleCapacity + j];
+            }
+            rest = (sum - first) / (kept - 1);
+        }
+        float scale = max(fabs(first), fabs(rest));
+        if (fabs(first - rest) >
+            scale * MS_ADAPTIVE_TIMING_TOLERANCE_PERCENT / 100) {
+            MS_DBG(F("First value"), first, F("of result"), i, F("from"),
+                   getSensorNameAndLocation(), F("disagrees with later mean"),
+                   rest);
+            stabilizationFailed = true;
+        }
+    }
+
+    if (warmUpFailed || stabilizationFailed) {
+        // Whatever was too short gets a floor one step above itself
+        if (warmUpFailed && _warmUpTime_ms < at.warmUpLimit_ms) {
+            at.warmUpFloor_ms = min(_warmUpTime_ms +
+                                        adaptiveTimingStep(at.warmUpLimit_ms),
+                                    at.warmUpLimit_ms);
+        }
+        if (stabilizationFailed &&
+            _stabilizationTime_ms < at.stabilizationLimit_ms) {
+            at.stabilizationFloor_ms =
+                min(_stabilizationTime_ms +
+                        adaptiveTimingStep(at.stabilizationLimit_ms),
+                    at.stabilizationLimit_ms);
+        }
+        // Fall back to the datasheet values until the next clean update
+        _warmUpTime_ms        = at.warmUpLimit_ms;
+        _stabilizationTime_ms = at.stabilizationLimit_ms;
+        MS_DBG(F("Restored datasheet warm-up and stabilization times for"),
+               getSensorNameAndLocation());
+        return;
+    }
+
+    // Take one step toward the floors
+    uint32_t warmUpStep        = adaptiveTimingStep(at.warmUpLimit_ms);
+    uint32_t stabilizationStep = adaptiveTimingStep(at.stabilizationLimit_ms);
+    _warmUpTime_ms = _warmUpTime_ms > at.warmUpFloor_ms + warmUpStep
+        ? _warmUpTime_ms - warmUpStep
+        : at.warmUpFloor_ms;
+    _stabilizationTime_ms =
+        _stabilizationTime_ms > at.stabilizationFloor_ms + stabilizationStep
+        ? _stabilizationTime_ms - stabilizationStep
+        : at.stabilizationFloor_ms;
+    MS_DBG(F("Learned warm-up of"), _warmUpTime_ms,
+           F("ms and stabilization of"), _stabilizationTime_ms, F("ms for"),
+           getSensorNameAndLocation());
+}
+
+
+// This closes the breaker after any good cycle, opens it once the threshold
+// of failed cycles is reached, and doubles the back-off after each failed probe
+void Sensor::updateBreaker(bool cycleSucceeded) {
+    if (cycleSucceeded) {
+        if (_breakerSkips > 0) {
+            MS_DBG(getSensorNameAndLocation(),
+                   F("is working again; no longer skipping it"));
+        }
+        _failedCycles = 0;
+        _breakerSkips = 0;
+        _cyclesToSkip = 0;
+        return;
+    }
+    if (_failedCycles < UINT8_MAX) { _failedCycles++; }
+    if (_breakerThreshold == 0) return;
+
+    if (_breakerSkips > 0) {
+        // The probe after a back-off failed; back off for longer
+        _breakerSkips = _breakerSkips >= MS_SENSOR_BREAKER_MAX_SKIPS / 2
+            ? MS_SENSOR_BREAKER_MAX_SKIPS
+            : _breakerSkips * 2;
+    } else if (_failedCycles >= _breakerThreshold) {
+        _breakerSkips = 1;
+    } else {
+        return;
+    }
+    _cyclesToSkip = _breakerSkips;
+    MS_DBG(getSensorNameAndLocation(), F("has failed"), _failedCycles,
+           F("cycles in a row; skipping it for"), _cyclesToSkip, F("cycles"));
+}
+
+
+void Sensor::skipBrokenCycle() {
+    if (_cyclesToSkip > 0) { _cyclesToSkip--; }
+}
+
+
+float Sensor::getStandardDeviation(uint8_t resultNumber) {
+    if (_statistics == nullptr || resultNumber >= _numReturnedValues ||
+        validCount[resultNumber] < 2) {
+        return MS_INVALID_VALUE;
+    }
+    return sqrt(_statistics[resultNumber].m2 / (validCount[resultNumber] - 1));
+}
+
+
+float Sensor::getMinimum(uint8_t resultNumber) {
+    if (_statistics == nullptr || resultNumber >= _numReturnedValues ||
+        validCount[resultNumber] == 0) {
+        return MS_INVALID_VALUE;
+    }
+    return _statistics[resultNumber].min;
+}
+
+
+float Sensor::getMaximum(uint8_t resultNumber) {
+    if (_statistics == nullptr || resultNumber >= _numReturnedValues ||
+        validCount[resultNumber] == 0) {
+        return MS_INVALID_VALUE;
     }
+    return _statistics[resultNumber].max;
 }
 
 
@@ -492,14 +906,14 @@ void Sensor::printData(Stream* stream, bool printStatusBits) {
         }
         stream->print(F(" reports "));
         if (variables[i] != nullptr) {
-            stream->print(variables[i]->getVarName());
+            stream->print(variables[i]->getVarNameChars());
             stream->print(F(" ("));
-            stream->print(variables[i]->getVarCode());
+            stream->print(variables[i]->getVarCodeChars());
             stream->print(F(")"));
             stream->print(F(" is "));
             stream->print(variables[i]->getValueString());
             stream->print(F(" "));
-            stream->print(variables[i]->getVarUnit());
+            stream->print(variables[i]->getVarUnitChars());
         } else {
             stream->print(F("variable #"));
             stream->print(i);
@@ -540,7 +954,10 @@ bool Sensor::update() {
         ret_val &= wake();
     }
     // bail if the wake failed
-    if (!ret_val) return ret_val;
+    if (!ret_val) {
+        adaptTiming(false);
+        return ret_val;
+    }
 
     // Clear measurement related status bits and timing values before starting
     // measurements
@@ -759,6 +1176,37 @@ void Sensor::waitForMeasurementCompletion() {
 }
 
 
+// This returns the time remaining until the next timing check would pass
+uint32_t Sensor::getMillisToNextEvent() {
+    uint32_t startTime;
+    uint32_t waitTime;
+    // NOTE: The order of these checks matches the order in which the variable
+    // array steps through the sensor status bits.
+    if (!getStatusBit(POWER_SUCCESSFUL)) {
+        return 0;
+    } else if (!getStatusBit(WAKE_ATTEMPTED)) {
+        startTime = _millisPowerOn;
+        waitTime  = _warmUpTime_ms;
+    } else if (!getStatusBit(WAKE_SUCCESSFUL)) {
+        return 0;
+    } else if (!getStatusBit(MEASUREMENT_ATTEMPTED)) {
+        if (_currentRetries != 0) { return 0; }
+        startTime = _millisSensorActivated;
+        waitTime  = _stabilizationTime_ms;
+    } else if (getStatusBit(MEASUREMENT_SUCCESSFUL)) {
+        startTime = _millisMeasurementRequested;
+        waitTime  = _measurementTime_ms;
+    } else {
+        return 0;
+    }
+
+    // The timing checks require strictly more than the wait time to pass
+    uint32_t elapsed = millis() - startTime;
+    if (elapsed > waitTime) { return 0; }
+    return waitTime - elapsed + 1;
+}
+
+
 bool Sensor::finalizeMeasurementAttempt(bool wasSuccessful) {
     // Record the time that the measurement was completed
     _millisMeasurementCompleted = millis();
@@ -766,6 +1214,13 @@ bool Sensor::finalizeMeasurementAttempt(bool wasSuccessful) {
     _millisMeasurementRequested = 0;
     // Unset the status bits for a measurement request (bits 5 & 6)
     clearStatusBits(MEASUREMENT_ATTEMPTED, MEASUREMENT_SUCCESSFUL);
+    if (wasSuccessful && _cycleSuccesses < UINT8_MAX) { _cycleSuccesses++; }
+    // Tally the outcome for adaptive timing
+    if (wasSuccessful) {
+        if (_adaptiveTiming.successes < UINT8_MAX) _adaptiveTiming.successes++;
+    } else {
+        if (_adaptiveTiming.failures < UINT8_MAX) _adaptiveTiming.failures++;
+    }
 
     if (wasSuccessful || _currentRetries >= _maxRetries) {
         // Bump the number of completed measurement attempts - we've succeeded
@@ -46,6 +46,21 @@
 class Variable;       // Forward declaration
 class VariableArray;  // Forward declaration
 
+/**
+ * @brief How the valid values from multiple measurements of a sensor are
+ * combined into the final result.
+ *
+ * @see Sensor::setAggregationMethod()
+ */
+enum class MeasurementAggregation : uint8_t {
+    MEAN         = 0,  ///< The arithmetic mean of all valid values
+    MEDIAN       = 1,  ///< The median of all valid values
+    TRIMMED_MEAN = 2,  ///< The mean after dropping the lowest and highest
+                       ///< quarter (at least one each from three values)
+    MAD_FILTERED_MEAN = 3  ///< The mean of the values within three scaled
+                           ///< median absolute deviations of the median
+};
+
 /**
  * @brief The "Sensor" class is used for all sensor-level operations - waking,
  * sleeping, and taking measurements.
@@ -64,7 +79,7 @@ class VariableArray;  // Forward declaration
 class Sensor {
  public:
     friend class Variable;
-    friend class VariableArray;
+    friend class VariableArrayBase;
     /**
      * @brief Construct a new Sensor object.
      *
@@ -116,9 +131,10 @@ class Sensor {
      */
     Sensor& operator=(const Sensor& copy_from_me) = delete;
     /**
-     * @brief Destroy the Sensor object - no action taken.
+     * @brief Destroy the Sensor object - frees the result statistics, if they
+     * were enabled.
      */
-    virtual ~Sensor() = default;
+    virtual ~Sensor();
 
     // These functions are dependent on the constructor and return the
     // constructor values.
@@ -137,6 +153,15 @@ class Sensor {
      * @return The sensor name as given in the constructor.
      */
     virtual String getSensorName();
+    /**
+     * @brief Print the name of the sensor without building a String.
+     *
+     * Sensors that override getSensorName() must override this to match.
+     *
+     * @param stream The stream to print to.
+     * @return The number of characters printed.
+     */
+    virtual size_t printSensorName(Stream* stream);
     /**
      * @brief Concatenate and returns the name and location of the sensor.
      *
@@ -235,6 +260,92 @@ class Sensor {
      */
     void setMaxRetries(uint8_t maxRetries);
 
+    /**
+     * @brief Set how often the sensor is updated when it is part of a logger's
+     * variable array.
+     *
+     * By default a sensor is updated every time the logger logs.  A sensor
+     * with its own logging interval is only powered, woken, and measured when
+     * the logged time is an even multiple of its interval; in the other
+     * records its variables are #MS_INVALID_VALUE.  This lets a fast sensor,
+     * like a rain gauge, log every minute in the same logger as a slow,
+     * power-hungry sensor, like a sonde, that only needs to wake every
+     * fifteen minutes.
+     *
+     * The interval should be a multiple of the logger's logging interval.
+     *
+     * @param loggingIntervalMinutes The interval in minutes, or 0 to update
+     * the sensor every time the logger logs.
+     */
+    void setLoggingInterval(uint16_t loggingIntervalMinutes);
+    /**
+     * @brief Get the sensor's own logging interval.
+     *
+     * @return The interval in minutes, or 0 if the sensor is updated every
+     * time the logger logs.
+     */
+    uint16_t getLoggingInterval();
+    /**
+     * @brief Check if the sensor is due to be updated at a logged time.
+     *
+     * @param localEpoch The logged time in seconds since the epoch, or 0 for
+     * an unscheduled update.
+     * @return True if the sensor has no logging interval of its own, the
+     * update is unscheduled, or the time is an even multiple of the sensor's
+     * logging interval.
+     */
+    bool isDueAt(uint32_t localEpoch);
+
+    /**
+     * @brief Set how many update cycles in a row the sensor must fail before
+     * the variable array starts skipping it.
+     *
+     * Only the update cycles the logger logs count; the cycles of bench
+     * testing, Sensor::update(), and VariableArray::completeUpdate() called
+     * without VariableArray::setUpdateTime() don't.  A cycle fails when no
+     * measurement attempt in it succeeds, including when the sensor can't be
+     * woken.  Once the threshold is reached the variable array skips the
+     * sensor - no power, wake, or measurement - for one logged cycle and then
+     * tries it again.  Every time that probe fails, the number of cycles
+     * skipped doubles, up to #MS_SENSOR_BREAKER_MAX_SKIPS.  The first
+     * successful cycle returns the sensor to normal.  The variables of a
+     * skipped sensor are #MS_INVALID_VALUE.
+     *
+     * To log the breaker state, add a SensorBreakerState variable for the
+     * sensor to the variable array.
+     *
+     * @param failedCycles The number of failed cycles in a row, or 0 to never
+     * skip the sensor.  Defaults to #MS_SENSOR_BREAKER_THRESHOLD.
+     */
+    void setBreakerThreshold(uint8_t failedCycles);
+    /**
+     * @brief Get the number of failed update cycles in a row that start
+     * skipping the sensor.
+     *
+     * @return The threshold, or 0 if the sensor is never skipped.
+     */
+    uint8_t getBreakerThreshold();
+    /**
+     * @brief Get the number of update cycles in a row the sensor has failed.
+     *
+     * @return The number of failed cycles since the last success.
+     */
+    uint8_t getFailedCycles();
+    /**
+     * @brief Get the state of the failing sensor breaker.
+     *
+     * @return The number of cycles the sensor is being skipped for after each
+     * failed probe, or 0 if the sensor is working normally.
+     */
+    uint8_t getBreakerState();
+    /**
+     * @brief Check if the variable array will skip the sensor in the current
+     * update cycle because it keeps failing.
+     *
+     * @return True if the sensor is being skipped.
+     */
+    bool isBreakerOpen();
+
     // _warmUpTime_ms _stabilizationTime_ms _measurementTime_ms
 
     /**
@@ -277,6 +388,138 @@ class Sensor {
      */
     uint32_t getMeasurementTime();
 
+    /**
+     * @brief Start keeping the variance, minimum, and maximum of the valid
+     * values measured for each result in addition to the running mean.
+     *
+     * The statistics take 12 bytes per result returned by the sensor, which
+     * are allocated the first time this is called and kept for the life of
+     * the sensor.  They are reset with the values at the start of each update
+     * and are complete once all of the measurements to average have been taken.
+     *
+     * To log or publish the statistics, create a ResultStandardDeviation,
+     * ResultMinimum, or ResultMaximum variable for the result; creating one
+     * enables the statistics.
+     *
+     * @return True if the statistics are enabled; false if there was not
+     * enough memory to allocate them.
+     */
+    bool enableStatistics();
+    /**
+     * @brief Get the sample standard deviation of the valid values for a
+     * result from the last update.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return The standard deviation, or #MS_INVALID_VALUE if statistics aren't
+     * enabled or there were fewer than two valid values.
+     */
+    float getStandardDeviation(uint8_t resultNumber);
+    /**
+     * @brief Get the smallest valid value for a result from the last update.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return The minimum, or #MS_INVALID_VALUE if statistics aren't enabled or
+     * there were no valid values.
+     */
+    float getMinimum(uint8_t resultNumber);
+    /**
+     * @brief Get the largest valid value for a result from the last update.
+     *
+     * @param resultNumber The position of the result within the result array.
+     * @return The maximum, or #MS_INVALID_VALUE if statistics aren't enabled or
+     * there were no valid values.
+     */
+    float getMaximum(uint8_t resultNumber);
+
+    /**
+     * @brief Set how the valid values from the measurements to average are
+     * combined into each result.
+     *
+     * Any method other than MeasurementAggregation::MEAN needs to keep every
+     * valid value until the update finishes, which takes
+     * (number of returned values) x (number of measurements to average) of the
+     * sensor's #MS_MAX_SAMPLES_TO_AGGREGATE value slots.  If the number of
+     * measurements to average is later raised past what fits, the sensor goes
+     * back to the mean.
+     *
+     * The outlier-resistant methods let spiky sensors (turbidity, sonar,
+     * optical backscatter) give a stable value from fewer measurements.
+     *
+     * @note The statistics from enableStatistics() always describe all valid
+     * values, including any rejected as outliers.
+     *
+     * @param method The aggregation method to use.
+     * @return True if the method was set; false if the values don't fit in
+     * #MS_MAX_SAMPLES_TO_AGGREGATE, in which case the mean is used.
+     */
+    bool setAggregationMethod(MeasurementAggregation method);
+    /**
+     * @brief Get the method used to combine the valid values from the
+     * measurements to average.
+     *
+     * @return The aggregation method.
+     */
+    MeasurementAggregation getAggregationMethod();
+
+    /**
+     * @brief The warm-up and stabilization times learned by adaptive timing
+     * and the lower bounds they may not be shortened past.
+     *
+     * This is a plain structure so a sketch can save it to EEPROM or the SD
+     * card and restore it with setLearnedTiming() after a restart.
+     */
+    struct LearnedTiming {
+        uint32_t warmUpTime_ms;            ///< The learned warm-up time
+        uint32_t stabilizationTime_ms;     ///< The learned stabilization time
+        uint32_t warmUpFloor_ms;           ///< The shortest warm-up to try
+        uint32_t stabilizationFloor_ms;    ///< The shortest stabilization
+    };
+    /**
+     * @brief Start learning how much of the datasheet warm-up and
+     * stabilization time this sensor actually needs.
+     *
+     * After each update, if every measurement succeeded and the first valid
+     * value of each result agreed with the mean of the later ones (within
+     * #MS_ADAPTIVE_TIMING_TOLERANCE_PERCENT), the warm-up and stabilization
+     * times are shortened by #MS_ADAPTIVE_TIMING_STEP_PERCENT of the datasheet
+     * values, down to #MS_ADAPTIVE_TIMING_MIN_PERCENT of them.  After any
+     * failed wake or measurement, or any disagreement, both times go straight
+     * back to the datasheet values and the shortest time that will be tried
+     * again is raised above the one that failed.
+     *
+     * The agreement check needs at least two measurements to average; with
+     * only one, the times are shortened as long as nothing fails.
+     *
+     * The datasheet values are the warm-up and stabilization times when this
+     * is called, or as later set by setWarmUpTime() and
+     * setStabilizationTime().  The learned times replace them in
+     * getWarmUpTime() and getStabilizationTime().  The learning state, about
+     * 20 bytes plus 4 bytes for each of #MAX_NUMBER_VARS results, is kept in
+     * the sensor whether or not adaptive timing is enabled.
+     *
+     * @return True; adaptive timing is enabled.
+     */
+    bool enableAdaptiveTiming();
+    /**
+     * @brief Get the learned warm-up and stabilization times, to save them.
+     *
+     * @param timing The structure to fill.
+     * @return True if adaptive timing is enabled and the timing was filled.
+     */
+    bool getLearnedTiming(LearnedTiming& timing);
+    /**
+     * @brief Restore learned warm-up and stabilization times saved by
+     * getLearnedTiming().
+     *
+     * Every time is limited to between #MS_ADAPTIVE_TIMING_MIN_PERCENT of the
+     * datasheet value and the datasheet value itself, so timing saved for a
+     * different sensor or configuration can't shorten the waits unsafely.
+     *
+     * @param timing The saved timing.
+     * @return True if adaptive timing is enabled and the timing was restored.
+     */
+    bool setLearnedTiming(const LearnedTiming& timing);
+
     /// @brief The significance of the various status bits
     typedef enum {
         SETUP_SUCCESSFUL       = 0,  ///< Whether setup was successful
@@ -530,7 +773,7 @@ class Sensor {
     /**
      * @brief The array of result values for each sensor.
      *
-     * New valid values are summed with the current values by
+     * New valid values are folded into a running mean of the current values by
      * verifyAndAddMeasurementResult(). Values are set to the default invalid
      * value by clearValues().
      *
@@ -538,13 +781,121 @@ class Sensor {
      * casting is needed. This could be done using a template or a union similar
      * to the SensorModbusMaster library's leFrame union.
      *
-     * @note The values in this array will not be usable until after the sensor
+     * @note The values in this array will not be final until after the sensor
      * completes all requested measurements! Prior to that, the values in this
-     * array will be the **sum** of all good values measured so far (or
+     * array will be the **mean** of all good values measured so far (or
      * #MS_INVALID_VALUE if no good values have been measured yet).
      */
     float sensorValues[MAX_NUMBER_VARS];
 
+    /**
+     * @brief Running dispersion statistics for a single result.
+     *
+     * These are updated with Welford's algorithm alongside the running mean in
+     * #sensorValues.
+     */
+    struct ResultStatistics {
+        float m2;   ///< Sum of squared differences from the running mean
+        float min;  ///< Smallest valid value
+        float max;  ///< Largest valid value
+    };
+    /**
+     * @brief Per-result statistics, one for each returned value, or a null
+     * pointer if enableStatistics() hasn't been called.
+     */
+    ResultStatistics* _statistics = nullptr;
+
+    /**
+     * @brief The method used to combine the valid values of each result.
+     */
+    MeasurementAggregation _aggregation = MeasurementAggregation::MEAN;
+    /**
+     * @brief Buffer of the valid values of each result in the current update,
+     * used by any aggregation method other than the mean.
+     *
+     * The values for result `i` start at `_samples[i * _sampleCapacity]`; the
+     * number stored is validCount[i], up to #_sampleCapacity.
+     */
+    float _samples[MS_MAX_SAMPLES_TO_AGGREGATE];
+    /**
+     * @brief The number of values that can be kept for each result in
+     * #_samples, or 0 if the values aren't kept.
+     */
+    uint8_t _sampleCapacity = 0;
+    /**
+     * @brief Divide #_samples among the results for the current number of
+     * measurements to average.
+     *
+     * @return True if every valid value fits; false if not, in which case no
+     * values are kept.
+     */
+    bool fitSamples();
+
+    /**
+     * @brief The datasheet timing, the lower bounds, and the outcome of the
+     * current update, for adaptive timing.
+     */
+    struct AdaptiveTiming {
+        uint32_t warmUpLimit_ms;         ///< The datasheet warm-up time
+        uint32_t stabilizationLimit_ms;  ///< The datasheet stabilization time
+        uint32_t warmUpFloor_ms;         ///< The shortest warm-up to try
+        uint32_t stabilizationFloor_ms;  ///< The shortest stabilization to try
+        uint8_t  successes;  ///< Successful measurements in this update
+        uint8_t  failures;   ///< Failed measurement attempts in this update
+        bool     enabled;    ///< Whether enableAdaptiveTiming() was called
+        /// The first valid value of each result in the current update, used
+        /// to check that early readings agree with later ones
+        float firstValues[MAX_NUMBER_VARS];
+    };
+    /**
+     * @brief The adaptive timing state; unused until enableAdaptiveTiming() is
+     * called.
+     */
+    AdaptiveTiming _adaptiveTiming = {};
+    /**
+     * @brief Shorten or restore the warm-up and stabilization times based on
+     * the outcome of the update just finished.
+     *
+     * @param wakeSucceeded False if the update ended because the sensor
+     * couldn't be woken.
+     */
+    void adaptTiming(bool wakeSucceeded);
+    /**
+     * @brief Count the outcome of the update cycle just finished toward the
+     * failing sensor breaker.
+     *
+     * @param cycleSucceeded True if at least one measurement attempt in the
+     * cycle succeeded.
+     */
+    void updateBreaker(bool cycleSucceeded);
+    /**
+     * @brief Count down one update cycle in which the sensor was skipped by
+     * the failing sensor breaker.
+     */
+    void skipBrokenCycle();
+    /**
+     * @brief Combine sorted values with an outlier-resistant method.
+     *
+     * @param sorted The values, sorted in ascending order.
+     * @param n The number of values
+     * @param method The aggregation method
+     * @return The aggregated value
+     */
+    static float aggregateSorted(const float sorted[], uint8_t n,
+                                 MeasurementAggregation method);
+    /**
+     * @brief Get the k-th smallest absolute deviation of sorted values from a
+     * center value, without a scratch buffer.
+     *
+     * @param sorted The values, sorted in ascending order.
+     * @param n The number of values
+     * @param center The value to take the deviations from
+     * @param k The zero-based rank of the deviation to return
+     * @return The k-th smallest absolute deviation
+     */
+    static float kthDeviation(const float sorted[], uint8_t n, float center,
+                              uint8_t k);
+
     /**
      * @brief Clear the values array and the count of values to average.
      *
@@ -597,8 +948,12 @@ class Sensor {
      * _millisMeasurementCompleted timing variables to 0. This is useful when
      * you need to clear only the measurement-related status without affecting
      * power or wake status.
+     *
+     * The variable array calls this for every sensor at the start of each
+     * update, so a sensor can override it to drop any other state left from
+     * the last update.
      */
-    void clearMeasurementStatus();
+    virtual void clearMeasurementStatus();
     /**
      * @brief Verify that a measurement is OK (i.e., not #MS_INVALID_VALUE)
      * before adding it to the result array
@@ -610,18 +965,14 @@ class Sensor {
     /// @copydoc verifyAndAddMeasurementResult(uint8_t, float)
     void verifyAndAddMeasurementResult(uint8_t resultNumber,
                                        int16_t resultValue);
-    /**
-     * @brief Average the results of all measurements by dividing the sum of
-     * all measurements by the number of measurements taken.
-     *
-     * @param resultNumber The position of the result within the result array.
-     * @param resultValue The value of the result.
-     */
+    /// @copydoc verifyAndAddMeasurementResult(uint8_t, float)
     void verifyAndAddMeasurementResult(uint8_t resultNumber,
                                        int32_t resultValue);
     /**
-     * @brief Average the results of all measurements by dividing the sum of
-     * all measurements by the number of measurements taken.
+     * @brief Finalize the results of all measurements.
+     *
+     * The values are averaged as they are added, so this only reports the
+     * results.
      */
     void averageMeasurements();
 
@@ -725,6 +1076,27 @@ class Sensor {
      */
     void waitForMeasurementCompletion();
 
+    /**
+     * @brief Get the number of milliseconds until the next timed step for
+     * this sensor - warm-up finishing, stabilization finishing, or a
+     * measurement completing - based on the status bits and the sensor timing
+     * values.
+     *
+     * This is used by the variable array to idle the processor between sensor
+     * events rather than repeatedly polling every sensor.
+     *
+     * @return The number of milliseconds until isWarmedUp(), isStable() or
+     * isMeasurementComplete() is expected to change.  A value of 0 means that
+     * the step is due now or that the sensor's timing is not known ahead of
+     * time and it must be polled.
+     *
+     * @note Sensors that override isWarmedUp(), isStable() or
+     * isMeasurementComplete() to query their hardware must also override this
+     * to return 0 unless the overridden checks can never return true before
+     * the default times.
+     */
+    virtual uint32_t getMillisToNextEvent();
+
 
  protected:
     /**
@@ -810,9 +1182,37 @@ class Sensor {
      * fails, it will not be retried at all.
      */
     uint8_t _maxRetries = 1;
+    /**
+     * @brief The sensor's own logging interval in minutes, or 0 to update the
+     * sensor every time the logger logs.
+     */
+    uint16_t _loggingInterval_min = 0;
+    /**
+     * @brief The number of failed update cycles in a row that start skipping
+     * the sensor, or 0 to never skip it.
+     */
+    uint8_t _breakerThreshold = MS_SENSOR_BREAKER_THRESHOLD;
+    /**
+     * @brief The number of update cycles in a row the sensor has failed.
+     */
+    uint8_t _failedCycles = 0;
+    /**
+     * @brief The number of successful measurement attempts in the current
+     * update cycle (reset by resetMeasurementCounts()).
+     */
+    uint8_t _cycleSuccesses = 0;
+    /**
+     * @brief The number of cycles the sensor is skipped for after each failed
+     * probe; 0 when the sensor is working normally.
+     */
+    uint8_t _breakerSkips = 0;
+    /**
+     * @brief The number of cycles left to skip before the next probe.
+     */
+    uint8_t _cyclesToSkip = 0;
     /**
      * @brief Array with the number of valid measurement values per variable
-     * that have been summed into the sensorValues array.
+     * that have been averaged into the sensorValues array.
      *
      * This is bumped by verifyAndAddMeasurementResult and reset by
      * clearValues().
@@ -10,19 +10,41 @@
 
 #include "VariableArray.h"
 
+// For idling the processor between sensor events
+#if defined(ARDUINO_ARCH_AVR)
+#include <avr/sleep.h>
+#endif
+
 
 // Constructors
 // Primary constructor with all parameters - ensures proper initialization order
-VariableArray::VariableArray(uint8_t variableCount, Variable* variableList[],
-                             const char* uuids[])
+VariableArrayBase::VariableArrayBase(uint8_t variableCount,
+                                     Variable* variableList[],
+                                     const char* uuids[], Sensor** sensorList,
+                                     uint32_t* powerCutAfter_ms,
+                                     uint8_t maxSensors,
+                                     uint8_t* calculationPlan,
+                                     uint8_t maxCalculated)
     : arrayOfVars(variableList),
-      _variableCount(variableCount) {
+      _variableCount(variableCount),
+      _sensorCount(0),
+      _sensorList(sensorList),
+      _powerCutAfter_ms(powerCutAfter_ms),
+      _maxSensors(maxSensors),
+      _calculationPlan(calculationPlan),
+      _maxCalculated(maxCalculated) {
     // Match UUIDs first, before populating sensor list
     if (uuids && arrayOfVars != nullptr && _variableCount > 0)
         matchUUIDs(uuids);
     populateSensorList();
 }
 
+// Constructor with UUIDs - uses the fixed arrays for the sensor list
+VariableArray::VariableArray(uint8_t variableCount, Variable* variableList[],
+                             const char* uuids[])
+    : VariableArrayBase(variableCount, variableList, uuids, _storedSensors,
+                        _storedPowerCutAfter_ms, MAX_NUMBER_SENSORS,
+                        _storedCalculationPlan, MAX_NUMBER_CALCULATED_VARS) {}
 // Delegating constructor - delegates to primary constructor with null UUIDs
 VariableArray::VariableArray(uint8_t variableCount, Variable* variableList[])
     : VariableArray(variableCount, variableList, nullptr) {}
@@ -31,8 +53,8 @@ VariableArray::VariableArray(uint8_t variableCount, Variable* variableList[])
 VariableArray::VariableArray() : VariableArray(0, nullptr) {}
 
 
-void VariableArray::begin(uint8_t variableCount, Variable* variableList[],
-                          const char* uuids[]) {
+void VariableArrayBase::begin(uint8_t variableCount, Variable* variableList[],
+                              const char* uuids[]) {
     _variableCount = variableCount;
     arrayOfVars    = variableList;
     if (_variableCount == 0 || arrayOfVars == nullptr) {
@@ -41,30 +63,32 @@ void VariableArray::begin(uint8_t variableCount, Variable* variableList[],
     }
     matchUUIDs(uuids);
     if (!populateSensorList()) {
-        MS_DBG(F("Warning: Sensor list may be truncated - exceeded "
-                 "MAX_NUMBER_SENSORS limit."));
+        MS_DBG(F("Warning: Sensor list truncated to"), _maxSensors,
+               F("sensors!"));
     }
     checkVariableUUIDs();
+    planCalculations();
 }
-void VariableArray::begin(uint8_t variableCount, Variable* variableList[]) {
+void VariableArrayBase::begin(uint8_t variableCount, Variable* variableList[]) {
     _variableCount = variableCount;
     arrayOfVars    = variableList;
     begin();
 }
-void VariableArray::begin() {
+void VariableArrayBase::begin() {
     if (_variableCount == 0 || arrayOfVars == nullptr) {
         MS_DBG(F("No variable array in the VariableArray object!"));
         return;
     }
     if (!populateSensorList()) {
-        MS_DBG(F("Warning: Sensor list may be truncated - exceeded "
-                 "MAX_NUMBER_SENSORS limit."));
+        MS_DBG(F("Warning: Sensor list truncated to"), _maxSensors,
+               F("sensors!"));
     }
     checkVariableUUIDs();
+    planCalculations();
 }
 
 // This counts and returns the number of calculated variables
-uint8_t VariableArray::getCalculatedVariableCount() {
+uint8_t VariableArrayBase::getCalculatedVariableCount() {
     uint8_t numCalc = 0;
     // Check for unique sensors
     for (uint8_t i = 0; i < _variableCount; i++) {
@@ -76,12 +100,12 @@ uint8_t VariableArray::getCalculatedVariableCount() {
 
 
 // This returns the number of sensors
-uint8_t VariableArray::getSensorCount() {
+uint8_t VariableArrayBase::getSensorCount() {
     return _sensorCount;
 }
 
 // This matches UUIDs from an array of pointers to the variable array
-void VariableArray::matchUUIDs(const char* uuids[]) {
+void VariableArrayBase::matchUUIDs(const char* uuids[]) {
     if (uuids == nullptr) return;
     for (uint8_t i = 0; i < _variableCount; i++) {
         arrayOfVars[i]->setVarUUID(uuids[i]);
@@ -89,18 +113,19 @@ void VariableArray::matchUUIDs(const char* uuids[]) {
 }
 
 // This populates the internal sensor list from the variable array
-bool VariableArray::populateSensorList() {
+bool VariableArrayBase::populateSensorList() {
     uint8_t addedSensors = 0;
-
-    // Clear the sensor list first
-    for (uint8_t i = 0; i < MAX_NUMBER_SENSORS; i++) {
-        _sensorList[i] = nullptr;
-    }
+    _sensorCount         = 0;
+    // Traced sensors are by list position
+    clearPhaseTrace();
 
     // Early exit if no valid variable array
-    if (arrayOfVars == nullptr) {
-        _sensorCount = 0;
-        return true;
+    if (arrayOfVars == nullptr) { return true; }
+
+    bool fits = true;
+    for (uint8_t i = 0; i < _maxSensors; i++) {
+        _sensorList[i]       = nullptr;
+        _powerCutAfter_ms[i] = UINT32_MAX;
     }
 
     for (uint8_t i = 0; i < _variableCount; i++) {
@@ -123,10 +148,11 @@ bool VariableArray::populateSensorList() {
 
         // If not already in list, add it
         if (!alreadyInList) {
-            if (addedSensors >= MAX_NUMBER_SENSORS) {
+            if (addedSensors >= _maxSensors) {
                 // Unfortunately silent so this can be run in the constructor
                 // before the serial port is set up.
-                return false;
+                fits = false;
+                break;
             }
             _sensorList[addedSensors++] = currentSensor;
         }
@@ -135,11 +161,73 @@ bool VariableArray::populateSensorList() {
     // Update the sensor count to match what we actually found
     _sensorCount = addedSensors;
 
-    return true;
+    return fits;
+}
+
+// This orders the calculated variables so their calculated inputs come first
+void VariableArrayBase::planCalculations() {
+    _calculationPlanCount = 0;
+    uint8_t numCalc       = getCalculatedVariableCount();
+    if (numCalc == 0) return;
+    if (numCalc > _maxCalculated) {
+        MS_DBG(F("Warning: No room to plan"), numCalc,
+               F("calculated variables; evaluating them in array order."));
+        return;
+    }
+
+    // Repeatedly sweep the array, adding each calculated variable whose
+    // calculated inputs from this array are already in the plan.  Variables
+    // with no inputs are added on the first sweep, in array order.
+    bool added = true;
+    while (added && _calculationPlanCount < numCalc) {
+        added = false;
+        for (uint8_t i = 0; i < _variableCount; i++) {
+            if (!arrayOfVars[i]->isCalculated || isPlanned(i)) continue;
+            bool ready = true;
+            for (uint8_t k = 0; k < arrayOfVars[i]->getInputCount() && ready;
+                 k++) {
+                Variable* input = arrayOfVars[i]->getInput(k);
+                if (input == nullptr || !input->isCalculated) continue;
+                for (uint8_t j = 0; j < _variableCount; j++) {
+                    if (arrayOfVars[j] == input && !isPlanned(j)) {
+                        ready = false;
+                        break;
+                    }
+                }
+            }
+            if (ready) {
+                _calculationPlan[_calculationPlanCount++] = i;
+                added                                     = true;
+            }
+        }
+    }
+
+    // Anything left depends on itself through its inputs
+    if (_calculationPlanCount < numCalc) {
+        for (uint8_t i = 0; i < _variableCount; i++) {
+            if (!arrayOfVars[i]->isCalculated || isPlanned(i)) continue;
+            MS_DBG(F("Warning:"), arrayOfVars[i]->getVarCode(),
+                   F("is in a loop of calculated inputs!"));
+            _calculationPlan[_calculationPlanCount++] = i;
+        }
+    }
+    MS_DEEP_DBG(F("Calculated variables will be evaluated in the order:"));
+    for (uint8_t i = 0; i < _calculationPlanCount; i++) {
+        MS_DEEP_DBG(F("  "), arrayOfVars[_calculationPlan[i]]->getVarCode());
+    }
+}
+
+// Helper function to check if a variable is already in the calculation plan
+bool VariableArrayBase::isPlanned(uint8_t arrayIndex) {
+    for (uint8_t i = 0; i < _calculationPlanCount; i++) {
+        if (_calculationPlan[i] == arrayIndex) return true;
+    }
+    return false;
 }
 
 // Helper function to check if sensor wake failed or is not ready
-inline bool VariableArray::isSensorWakeFailure(uint8_t sensorIndex, bool wake) {
+inline bool VariableArrayBase::isSensorWakeFailure(uint8_t sensorIndex,
+                                                   bool    wake) {
     bool wakeAttempted =
         _sensorList[sensorIndex]->getStatusBit(Sensor::WAKE_ATTEMPTED) == 1;
     bool wakeSuccessful =
@@ -150,14 +238,15 @@ inline bool VariableArray::isSensorWakeFailure(uint8_t sensorIndex, bool wake) {
 }
 
 // Helper function to check if sensor should be woken up
-inline bool VariableArray::shouldWakeSensor(uint8_t sensorIndex, bool wake) {
+inline bool VariableArrayBase::shouldWakeSensor(uint8_t sensorIndex,
+                                                bool    wake) {
     bool wakeAttempted =
         _sensorList[sensorIndex]->getStatusBit(Sensor::WAKE_ATTEMPTED) == 1;
     return wake && !wakeAttempted && _sensorList[sensorIndex]->isWarmedUp();
 }
 
 // Helper function to check if sensor is ready to start measurements
-inline bool VariableArray::isSensorReadyToMeasure(uint8_t sensorIndex) {
+inline bool VariableArrayBase::isSensorReadyToMeasure(uint8_t sensorIndex) {
     bool wakeSuccessful =
         _sensorList[sensorIndex]->getStatusBit(Sensor::WAKE_SUCCESSFUL) == 1;
     bool measurementAttempted = _sensorList[sensorIndex]->getStatusBit(
@@ -168,19 +257,26 @@ inline bool VariableArray::isSensorReadyToMeasure(uint8_t sensorIndex) {
 }
 
 // Helper function to check if measurements have been attempted
-inline bool VariableArray::isMeasurementAttempted(uint8_t sensorIndex) {
+inline bool VariableArrayBase::isMeasurementAttempted(uint8_t sensorIndex) {
     return _sensorList[sensorIndex]->getStatusBit(
                Sensor::MEASUREMENT_ATTEMPTED) == 1;
 }
 
+// Helper function to check if a sensor is due in this update and, in a logged
+// update, isn't being skipped because it keeps failing
+inline bool VariableArrayBase::isSensorDue(uint8_t sensorIndex) {
+    return _sensorList[sensorIndex]->isDueAt(_updateTime) &&
+        !(_loggedUpdate && _sensorList[sensorIndex]->isBreakerOpen());
+}
+
 // Helper function to check if all measurements are complete
-inline bool VariableArray::areMeasurementsComplete(uint8_t sensorIndex) {
+inline bool VariableArrayBase::areMeasurementsComplete(uint8_t sensorIndex) {
     return _sensorList[sensorIndex]->getCompletedMeasurements() >=
         _sensorList[sensorIndex]->getNumberMeasurementsToAverage();
 }
 
 // Helper function to check if two sensors share any power pins
-inline bool VariableArray::sharesPowerPin(Sensor* a, Sensor* b) {
+inline bool VariableArrayBase::sharesPowerPin(Sensor* a, Sensor* b) {
     // Check if sensor a's primary pin matches either of sensor b's pins
     if (a->getPowerPin() >= 0 &&
         (a->getPowerPin() == b->getPowerPin() ||
@@ -198,7 +294,7 @@ inline bool VariableArray::sharesPowerPin(Sensor* a, Sensor* b) {
 
 // Helper function to check if sensor can be powered down safely with debug
 // output
-bool VariableArray::canPowerDownSensor(uint8_t sensorIndex) {
+bool VariableArrayBase::canPowerDownSensor(uint8_t sensorIndex) {
     // NOTE: We are NOT checking if the sleep command succeeded!
     // Check if it's safe to cut power to this sensor and all that share the pin
     bool canPowerDown =
@@ -256,7 +352,7 @@ bool VariableArray::canPowerDownSensor(uint8_t sensorIndex) {
 // NOTE:  Calculated variables will always be skipped in this process because
 // a calculated variable will never be marked as the last variable from a
 // sensor.
-bool VariableArray::setupSensors() {
+bool VariableArrayBase::setupSensors() {
     bool success = true;
 
     MS_DBG(F("Beginning setup for sensors and variables..."));
@@ -309,12 +405,13 @@ bool VariableArray::setupSensors() {
 // NOTE:  Calculated variables will always be skipped in this process because
 // a calculated variable will never be marked as the last variable from a
 // sensor.
-void VariableArray::sensorsPowerUp() {
+void VariableArrayBase::sensorsPowerUp() {
     MS_DBG(F("Powering up sensors..."));
     for (uint8_t i = 0; i < _sensorCount; i++) {
         MS_DBG(F("    Powering up"),
                _sensorList[i]->getSensorNameAndLocation());
         _sensorList[i]->powerUp();
+        tracePhase(i, TRACE_POWER_UP);
     }
 }
 
@@ -324,7 +421,7 @@ void VariableArray::sensorsPowerUp() {
 // NOTE:  Calculated variables will always be skipped in this process because
 // a calculated variable will never be marked as the last variable from a
 // sensor.
-bool VariableArray::sensorsWake() {
+bool VariableArrayBase::sensorsWake() {
     MS_DBG(F("Waking sensors..."));
     bool    success       = true;
     uint8_t nSensorsAwake = 0;
@@ -355,6 +452,7 @@ bool VariableArray::sensorsWake() {
                 // warmed up
                 bool sensorSuccess = _sensorList[i]->wake();
                 success &= sensorSuccess;
+                tracePhase(i, TRACE_WAKE, sensorSuccess);
                 // We increment up the number of sensors awake/active,
                 // even if the wake up command failed!
                 nSensorsAwake++;
@@ -377,7 +475,7 @@ bool VariableArray::sensorsWake() {
 // NOTE:  Calculated variables will always be skipped in this process because
 // a calculated variable will never be marked as the last variable from a
 // sensor.
-bool VariableArray::sensorsSleep() {
+bool VariableArrayBase::sensorsSleep() {
     MS_DBG(F("Putting sensors to sleep..."));
     bool success = true;
     for (uint8_t i = 0; i < _sensorCount; i++) {
@@ -385,6 +483,7 @@ bool VariableArray::sensorsSleep() {
 
         bool sensorSuccess = _sensorList[i]->sleep();
         success &= sensorSuccess;
+        tracePhase(i, TRACE_SLEEP, sensorSuccess);
 
         if (sensorSuccess) {
             MS_DBG(F("        ... successfully put to sleep."));
@@ -401,12 +500,13 @@ bool VariableArray::sensorsSleep() {
 // NOTE:  Calculated variables will always be skipped in this process because
 // a calculated variable will never be marked as the last variable from a
 // sensor.
-void VariableArray::sensorsPowerDown() {
+void VariableArrayBase::sensorsPowerDown() {
     MS_DBG(F("Powering down sensors..."));
     for (uint8_t i = 0; i < _sensorCount; i++) {
         MS_DBG(F("    Powering down"),
                _sensorList[i]->getSensorNameAndLocation());
         _sensorList[i]->powerDown();
+        tracePhase(i, TRACE_POWER_DOWN);
     }
 }
 
@@ -415,15 +515,19 @@ void VariableArray::sensorsPowerDown() {
 // Please note that this does NOT run the update functions, it instead uses
 // the startSingleMeasurement and addSingleMeasurementResult functions to
 // take advantage of the ability of sensors to be measuring concurrently.
-bool VariableArray::updateAllSensors() {
+bool VariableArrayBase::updateAllSensors() {
     return completeUpdate(false, false, false, false);
 }
 
-bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
-                                   bool powerDown) {
+bool VariableArrayBase::completeUpdate(bool powerUp, bool wake, bool sleep,
+                                       bool powerDown) {
     bool    success           = true;
     uint8_t nSensorsCompleted = 0;
     MS_DBG(F("Using internal sensor list for measurements..."));
+#if MS_VARIABLEARRAY_TRACE_SIZE > 0
+    _phaseTraceCycle++;
+#endif
+    tracePhase(TRACE_NO_SENSOR, TRACE_CYCLE_START);
 
 #if defined(MS_VARIABLEARRAY_DEBUG) || defined(MS_VARIABLEARRAY_DEBUG_DEEP)
     for (uint8_t i = 0; i < _sensorCount; i++) {
@@ -444,9 +548,15 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
         }
         MS_DEEP_DBG(F("   ... Complete. <<-----"));
 
-        // power up all of the sensors together
-        MS_DBG(F("----->> Powering up all sensors together. ..."));
-        sensorsPowerUp();
+        // power up all of the sensors due in this update together
+        MS_DBG(F("----->> Powering up all due sensors together. ..."));
+        for (uint8_t i = 0; i < _sensorCount; i++) {
+            if (!isSensorDue(i)) continue;
+            MS_DBG(F("    Powering up"),
+                   _sensorList[i]->getSensorNameAndLocation());
+            _sensorList[i]->powerUp();
+            tracePhase(i, TRACE_POWER_UP);
+        }
         MS_DBG(F("   ... Complete. <<-----"));
     } else {
         // If this function isn't powering the sensors, check whether or not the
@@ -487,9 +597,24 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
              "measurements. ..."));
     for (uint8_t i = 0; i < _sensorCount; i++) {
         _sensorList[i]->resetMeasurementCounts();
+        _powerCutAfter_ms[i] = UINT32_MAX;
     }
     MS_DBG(F("   ... Complete. <<-----"));
 
+    // Sensors that aren't due this time are done before they start; their
+    // variables get invalid values for this update.
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (isSensorDue(i)) continue;
+        MS_DBG(F("--->>"), _sensorList[i]->getSensorNameAndLocation(),
+               _sensorList[i]->isDueAt(_updateTime)
+                   ? F("keeps failing and will be skipped. <<---")
+                   : F("isn't due at this time and will be skipped. <<---"));
+        _sensorList[i]->clearValues();
+        _sensorList[i]->_completedMeasurements =
+            _sensorList[i]->_measurementsToAverage;
+        nSensorsCompleted++;
+    }
+
     while (nSensorsCompleted < _sensorCount) {
         for (uint8_t i = 0; i < _sensorCount; i++) {
             uint8_t nReq = _sensorList[i]->getNumberMeasurementsToAverage();
@@ -529,6 +654,7 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
                 // warmed up
                 bool sensorSuccess_wake = _sensorList[i]->wake();
                 success &= sensorSuccess_wake;
+                tracePhase(i, TRACE_WAKE, sensorSuccess_wake);
 
                 if (sensorSuccess_wake) {
                     MS_DBG(F("   ... wake up succeeded. <<---"), i);
@@ -548,6 +674,7 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
                     bool sensorSuccess_start =
                         _sensorList[i]->startSingleMeasurement();
                     success &= sensorSuccess_start;
+                    tracePhase(i, TRACE_MEASUREMENT_START, sensorSuccess_start);
 
                     if (sensorSuccess_start) {
                         MS_DBG(F("   ... start reading succeeded. <<---"),
@@ -575,6 +702,8 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
                     bool sensorSuccess_result =
                         _sensorList[i]->addSingleMeasurementResult();
                     success &= sensorSuccess_result;
+                    tracePhase(i, TRACE_MEASUREMENT_RESULT,
+                               sensorSuccess_result);
 
                     if (sensorSuccess_result) {
                         MS_DBG(F("   ... got measurement result. <<---"),
@@ -596,6 +725,7 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
                     // Put the completed sensor to sleep
                     bool sensorSuccess_sleep = _sensorList[i]->sleep();
                     success &= sensorSuccess_sleep;
+                    tracePhase(i, TRACE_SLEEP, sensorSuccess_sleep);
 
                     if (sensorSuccess_sleep) {
                         MS_DBG(F("   ... succeeded in putting sensor to sleep. "
@@ -616,7 +746,13 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
                                _sensorList[i]->getPowerPin(), F("or pin"),
                                _sensorList[i]->getSecondaryPowerPin(),
                                F("..."));
+                        if (_sensorList[i]->getPowerPin() >= 0 ||
+                            _sensorList[i]->getSecondaryPowerPin() >= 0) {
+                            _powerCutAfter_ms[i] = millis() -
+                                _sensorList[i]->_millisPowerOn;
+                        }
                         _sensorList[i]->powerDown();
+                        tracePhase(i, TRACE_POWER_DOWN);
                     }
                 }
                 nSensorsCompleted++;  // mark the whole sensor as done
@@ -630,14 +766,27 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
         }
         MS_DEEP_DBG(F("xxxxx---"), _sensorCount - nSensorsCompleted,
                     F("sensors remaining ---xxxxx"));
+#if MS_VARIABLEARRAY_IDLE_BETWEEN_EVENTS
+        if (nSensorsCompleted < _sensorCount) { idleUntilNextEvent(); }
+#endif
     }
 
     // Average measurements and notify variables of the updates
     MS_DBG(F("----->> Averaging results and notifying all variables. ..."));
     for (uint8_t i = 0; i < _sensorCount; i++) {
-        MS_DBG(F("--- Averaging results from"),
-               _sensorList[i]->getSensorNameAndLocation(), F("---"));
-        _sensorList[i]->averageMeasurements();
+        if (isSensorDue(i)) {
+            MS_DBG(F("--- Averaging results from"),
+                   _sensorList[i]->getSensorNameAndLocation(), F("---"));
+            _sensorList[i]->averageMeasurements();
+            // Only logged updates count toward the failing sensor breaker
+            if (_loggedUpdate) {
+                _sensorList[i]->updateBreaker(
+                    _sensorList[i]->_cycleSuccesses > 0);
+            }
+        } else if (_loggedUpdate && _sensorList[i]->isDueAt(_updateTime)) {
+            // Due, but skipped by the failing sensor breaker
+            _sensorList[i]->skipBrokenCycle();
+        }
         MS_DBG(F("--- Notifying variables from"),
                _sensorList[i]->getSensorNameAndLocation(), F("---"));
         _sensorList[i]->notifyVariables();
@@ -645,22 +794,496 @@ bool VariableArray::completeUpdate(bool powerUp, bool wake, bool sleep,
     MS_DBG(F("... Complete. <<-----"));
 
     MS_DBG(F("Updating calculated variables. ..."));
-    for (uint8_t i = 0; i < _variableCount; i++) {
-        if (arrayOfVars[i]->isCalculated) { arrayOfVars[i]->getValue(true); }
+    if (_calculationPlanCount > 0) {
+        for (uint8_t i = 0; i < _calculationPlanCount; i++) {
+            arrayOfVars[_calculationPlan[i]]->getValue(true);
+        }
+    } else {
+        for (uint8_t i = 0; i < _variableCount; i++) {
+            if (arrayOfVars[i]->isCalculated) {
+                arrayOfVars[i]->getValue(true);
+            }
+        }
     }
 
+    // The update time only applies to one update
+    _updateTime   = 0;
+    _loggedUpdate = false;
+
+    tracePhase(TRACE_NO_SENSOR, TRACE_CYCLE_END, success);
     return success;
 }
 
+
+void VariableArrayBase::setUpdateTime(uint32_t localEpoch, bool logged) {
+    _updateTime   = localEpoch;
+    _loggedUpdate = logged;
+}
+
+
+// Idle the processor until the earliest upcoming event of any unfinished sensor
+void VariableArrayBase::idleUntilNextEvent() {
+    uint32_t idleTime = MS_VARIABLEARRAY_MAX_IDLE_MS;
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (areMeasurementsComplete(i)) continue;
+        uint32_t toNext = _sensorList[i]->getMillisToNextEvent();
+        if (toNext < idleTime) { idleTime = toNext; }
+        if (idleTime == 0) return;  // something needs polling now
+    }
+
+    MS_DEEP_DBG(F("Idling"), idleTime, F("ms until the next sensor event"));
+    uint32_t idleStart = millis();
+    while (millis() - idleStart < idleTime) {
+        // Each of these returns on the next interrupt, at the latest on the
+        // next tick of the millis() timer.
+#if defined(ARDUINO_ARCH_AVR)
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        sleep_mode();
+#elif defined(ARDUINO_ARCH_SAMD)
+        // The logger's deep sleep may have left standby configured; the
+        // millis() timer doesn't run in standby.
+#if defined(__SAMD51__)
+        PM->SLEEPCFG.bit.SLEEPMODE = PM_SLEEPCFG_SLEEPMODE_IDLE2_Val;
+        while (PM->SLEEPCFG.bit.SLEEPMODE != PM_SLEEPCFG_SLEEPMODE_IDLE2_Val);
+#else
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+        PM->SLEEP.reg = PM_SLEEP_IDLE_CPU;
+#endif
+        __DSB();
+        __WFI();
+#else
+        yield();
+#endif
+    }
+}
+
+
+// Replay the completeUpdate() loop in virtual time, jumping straight to the
+// next sensor deadline instead of polling.
+uint32_t VariableArrayBase::runUpdateSimulation(uint32_t finishedAt[],
+                                                uint32_t powerCutAt[]) {
+    enum : uint8_t { SIM_WARMING, SIM_STABILIZING, SIM_MEASURING, SIM_DONE };
+
+    uint8_t  phase[MAX_NUMBER_SENSORS];
+    uint8_t  nMeasured[MAX_NUMBER_SENSORS];
+    uint32_t deadline[MAX_NUMBER_SENSORS];
+
+    uint8_t  nSensorsCompleted = 0;
+    uint32_t now               = 0;
+
+    // Everything is powered together at time zero
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        phase[i]      = SIM_WARMING;
+        nMeasured[i]  = 0;
+        deadline[i]   = _sensorList[i]->getWarmUpTime();
+        finishedAt[i] = 0;
+        powerCutAt[i] = UINT32_MAX;
+        if (_sensorList[i]->getNumberMeasurementsToAverage() == 0) {
+            phase[i] = SIM_DONE;
+            nSensorsCompleted++;
+        }
+    }
+
+    while (nSensorsCompleted < _sensorCount) {
+        // Advance the virtual clock to the earliest pending deadline
+        uint32_t next = UINT32_MAX;
+        for (uint8_t i = 0; i < _sensorCount; i++) {
+            if (phase[i] != SIM_DONE && deadline[i] < next) {
+                next = deadline[i];
+            }
+        }
+        now = next;
+
+        // Step every sensor that is due, in list order like completeUpdate()
+        for (uint8_t i = 0; i < _sensorCount; i++) {
+            while (phase[i] != SIM_DONE && deadline[i] <= now) {
+                switch (phase[i]) {
+                    case SIM_WARMING:
+                        phase[i] = SIM_STABILIZING;
+                        deadline[i] += _sensorList[i]->getStabilizationTime();
+                        break;
+                    case SIM_STABILIZING:
+                        phase[i] = SIM_MEASURING;
+                        deadline[i] += _sensorList[i]->getMeasurementTime();
+                        break;
+                    default: {
+                        nMeasured[i]++;
+                        if (nMeasured[i] <
+                            _sensorList[i]->getNumberMeasurementsToAverage()) {
+                            deadline[i] += _sensorList[i]->getMeasurementTime();
+                            break;
+                        }
+                        phase[i]      = SIM_DONE;
+                        finishedAt[i] = now;
+                        nSensorsCompleted++;
+                        // Same rule as canPowerDownSensor()
+                        bool canPowerDown = true;
+                        for (uint8_t k = 0; k < _sensorCount; k++) {
+                            if (k != i && phase[k] != SIM_DONE &&
+                                sharesPowerPin(_sensorList[i],
+                                               _sensorList[k])) {
+                                canPowerDown = false;
+                                break;
+                            }
+                        }
+                        if (canPowerDown) { powerCutAt[i] = now; }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return now;
+}
+
+
+// Collect each distinct power pin used by any sensor in the list
+uint8_t VariableArrayBase::getPowerPins(int8_t pins[]) {
+    uint8_t nPins = 0;
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        int8_t sensorPins[2] = {_sensorList[i]->getPowerPin(),
+                                _sensorList[i]->getSecondaryPowerPin()};
+        for (int8_t pin : sensorPins) {
+            if (pin < 0) continue;
+            bool seen = false;
+            for (uint8_t j = 0; j < nPins; j++) {
+                if (pins[j] == pin) {
+                    seen = true;
+                    break;
+                }
+            }
+            if (!seen) { pins[nPins++] = pin; }
+        }
+    }
+    return nPins;
+}
+
+
+// A pin goes low the first time any sensor using it calls powerDown()
+uint32_t VariableArrayBase::getPinCutTime(int8_t         pin,
+                                          const uint32_t cutTimes[]) {
+    uint32_t cutTime = UINT32_MAX;
+    if (pin < 0) return cutTime;
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        if ((_sensorList[i]->getPowerPin() == pin ||
+             _sensorList[i]->getSecondaryPowerPin() == pin) &&
+            cutTimes[i] < cutTime) {
+            cutTime = cutTimes[i];
+        }
+    }
+    return cutTime;
+}
+
+
+uint32_t VariableArrayBase::simulateCompleteUpdate(Stream* stream) {
+    uint32_t finishedAt[MAX_NUMBER_SENSORS];
+    uint32_t powerCutAt[MAX_NUMBER_SENSORS];
+    uint32_t awakeTime = runUpdateSimulation(finishedAt, powerCutAt);
+
+    if (stream == nullptr) { return awakeTime; }
+
+    stream->print(F("Simulated update of "));
+    stream->print(_sensorCount);
+    stream->println(F(" sensors:"));
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        Sensor* s = _sensorList[i];
+        stream->print(F("  "));
+        stream->print(i);
+        stream->print(F(" "));
+        stream->print(s->getSensorNameAndLocation());
+        stream->print(F(" finished at "));
+        stream->print(finishedAt[i]);
+        stream->print(F(" ms"));
+        if (s->getPowerPin() < 0 && s->getSecondaryPowerPin() < 0) {
+            stream->println(F(", always powered"));
+            continue;
+        }
+        // A sensor loses power as soon as either of its pins is cut
+        uint32_t poweredUntil = min(getPinCutTime(s->getPowerPin(), powerCutAt),
+                                    getPinCutTime(s->getSecondaryPowerPin(),
+                                                  powerCutAt));
+        stream->print(F(", powered "));
+        if (poweredUntil == UINT32_MAX) {
+            stream->print(awakeTime);
+            stream->println(F(" ms and left on"));
+            continue;
+        }
+        stream->print(poweredUntil);
+        stream->print(F(" ms, idle "));
+        stream->print(poweredUntil - finishedAt[i]);
+        stream->println(F(" ms"));
+    }
+
+    int8_t  pins[2 * MAX_NUMBER_SENSORS];
+    uint8_t nPins = getPowerPins(pins);
+    for (uint8_t p = 0; p < nPins; p++) {
+        uint32_t pinOn = getPinCutTime(pins[p], powerCutAt);
+        stream->print(F("  Power pin "));
+        stream->print(pins[p]);
+        stream->print(F(" on for "));
+        stream->print(pinOn == UINT32_MAX ? awakeTime : pinOn);
+        stream->println(pinOn == UINT32_MAX ? F(" ms and left on") : F(" ms"));
+    }
+
+    stream->print(F("Total predicted awake time: "));
+    stream->print(awakeTime);
+    stream->println(F(" ms"));
+
+    return awakeTime;
+}
+
+
+// Order the sensors so that sensors sharing power are adjacent, the groups
+// with the longest latency come first, and within a group the slowest sensor
+// comes first.
+void VariableArrayBase::optimizeSensorOrder() {
+    uint8_t  group[MAX_NUMBER_SENSORS];
+    uint32_t latency[MAX_NUMBER_SENSORS];
+    uint32_t groupLatency[MAX_NUMBER_SENSORS];
+
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        latency[i] = _sensorList[i]->getWarmUpTime() +
+            _sensorList[i]->getStabilizationTime() +
+            _sensorList[i]->getMeasurementTime() *
+                _sensorList[i]->getNumberMeasurementsToAverage();
+        group[i] = i;
+    }
+    // Merge sensors connected through any chain of shared power pins into the
+    // group with the lowest index
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (uint8_t i = 0; i < _sensorCount; i++) {
+            for (uint8_t k = i + 1; k < _sensorCount; k++) {
+                if (group[i] != group[k] &&
+                    sharesPowerPin(_sensorList[i], _sensorList[k])) {
+                    uint8_t g = min(group[i], group[k]);
+                    group[i] = group[k] = g;
+                    merged               = true;
+                }
+            }
+        }
+    }
+    for (uint8_t i = 0; i < _sensorCount; i++) { groupLatency[i] = 0; }
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        groupLatency[group[i]] = max(groupLatency[group[i]], latency[i]);
+    }
+
+    // Insertion sort; the list is short and this keeps ties in their original
+    // order
+    for (uint8_t i = 1; i < _sensorCount; i++) {
+        Sensor*  sensor = _sensorList[i];
+        uint8_t  g      = group[i];
+        uint32_t l      = latency[i];
+        int8_t   j      = i - 1;
+        while (j >= 0) {
+            bool moveUp = groupLatency[g] > groupLatency[group[j]] ||
+                (g != group[j] && groupLatency[g] == groupLatency[group[j]] &&
+                 g < group[j]) ||
+                (g == group[j] && l > latency[j]);
+            if (!moveUp) break;
+            _sensorList[j + 1] = _sensorList[j];
+            group[j + 1]       = group[j];
+            latency[j + 1]     = latency[j];
+            j--;
+        }
+        _sensorList[j + 1] = sensor;
+        group[j + 1]       = g;
+        latency[j + 1]     = l;
+    }
+
+    // Recorded power times and traced sensors are by list position
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        _powerCutAfter_ms[i] = UINT32_MAX;
+    }
+    clearPhaseTrace();
+
+#if defined(MS_VARIABLEARRAY_DEBUG) || defined(MS_VARIABLEARRAY_DEBUG_DEEP)
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        MS_DBG(F("   Sensor"), i, F("is"),
+               _sensorList[i]->getSensorNameAndLocation(), F("in power group"),
+               group[i], F("with an expected latency of"), latency[i],
+               F("ms"));
+    }
+#endif
+}
+
+
+void VariableArrayBase::printPowerPinReport(Stream* stream) {
+    uint32_t finishedAt[MAX_NUMBER_SENSORS];
+    uint32_t powerCutAt[MAX_NUMBER_SENSORS];
+    uint32_t awakeTime = runUpdateSimulation(finishedAt, powerCutAt);
+
+    int8_t  pins[2 * MAX_NUMBER_SENSORS];
+    uint8_t nPins = getPowerPins(pins);
+    for (uint8_t p = 0; p < nPins; p++) {
+        uint32_t predicted = getPinCutTime(pins[p], powerCutAt);
+        uint32_t achieved  = getPinCutTime(pins[p], _powerCutAfter_ms);
+        stream->print(F("Power pin "));
+        stream->print(pins[p]);
+        stream->print(F(" predicted on for "));
+        stream->print(predicted == UINT32_MAX ? awakeTime : predicted);
+        stream->print(predicted == UINT32_MAX ? F(" ms (left on)") : F(" ms"));
+        stream->print(F(", achieved "));
+        if (achieved == UINT32_MAX) {
+            stream->println(F("not cut by the last update"));
+        } else {
+            stream->print(achieved);
+            stream->println(F(" ms"));
+        }
+    }
+}
+
+
+void VariableArrayBase::tracePhase(uint8_t sensor, trace_phase phase,
+                                   bool success) {
+#if MS_VARIABLEARRAY_TRACE_SIZE > 0
+    phaseTraceEvent& event = _phaseTrace[_phaseTraceHead];
+    event.time             = millis();
+    event.cycle            = _phaseTraceCycle;
+    event.sensor           = sensor;
+    event.phase            = phase | (success ? 0 : 0x80);
+    _phaseTraceHead        = (_phaseTraceHead + 1) %
+        MS_VARIABLEARRAY_TRACE_SIZE;
+    if (_phaseTraceCount < MS_VARIABLEARRAY_TRACE_SIZE) { _phaseTraceCount++; }
+#else
+    (void)sensor;
+    (void)phase;
+    (void)success;
+#endif
+}
+
+
+const __FlashStringHelper*
+VariableArrayBase::getTracePhaseName(trace_phase phase) {
+    switch (phase) {
+        case TRACE_CYCLE_START: return F("update start");
+        case TRACE_CYCLE_END: return F("update end");
+        case TRACE_POWER_UP: return F("power up");
+        case TRACE_WAKE: return F("wake");
+        case TRACE_MEASUREMENT_START: return F("measurement start");
+        case TRACE_MEASUREMENT_RESULT: return F("measurement result");
+        case TRACE_SLEEP: return F("sleep");
+        case TRACE_POWER_DOWN: return F("power down");
+        default: return F("unknown");
+    }
+}
+
+
+void VariableArrayBase::clearPhaseTrace() {
+#if MS_VARIABLEARRAY_TRACE_SIZE > 0
+    _phaseTraceHead  = 0;
+    _phaseTraceCount = 0;
+#endif
+}
+
+
+void VariableArrayBase::printPhaseTraceCSV(Stream* stream) {
+#if MS_VARIABLEARRAY_TRACE_SIZE > 0
+    stream->println(F("Cycle,Time (ms),Sensor,Phase,Success"));
+    // the oldest event is just past the newest when the ring is full
+    uint8_t first = (_phaseTraceHead + MS_VARIABLEARRAY_TRACE_SIZE -
+                     _phaseTraceCount) %
+        MS_VARIABLEARRAY_TRACE_SIZE;
+    for (uint8_t n = 0; n < _phaseTraceCount; n++) {
+        const phaseTraceEvent& event =
+            _phaseTrace[(first + n) % MS_VARIABLEARRAY_TRACE_SIZE];
+        stream->print(event.cycle);
+        stream->print(',');
+        stream->print(event.time);
+        stream->print(',');
+        if (event.sensor < _sensorCount) {
+            stream->print(_sensorList[event.sensor]->getSensorNameAndLocation());
+        }
+        stream->print(',');
+        stream->print(
+            getTracePhaseName(static_cast<trace_phase>(event.phase & 0x7F)));
+        stream->print(',');
+        stream->println((event.phase & 0x80) ? 0 : 1);
+    }
+#else
+    (void)stream;
+#endif
+}
+
+
+void VariableArrayBase::printPhaseTraceJSON(Stream* stream) {
+#if MS_VARIABLEARRAY_TRACE_SIZE > 0
+    // Each sensor is a thread, numbered from 1 after the update itself
+    stream->print(F("{\"traceEvents\":[\n"));
+    stream->print(F("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                    "\"tid\":0,\"args\":{\"name\":\"update\"}}"));
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        stream->print(F(",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+                        "\"pid\":1,\"tid\":"));
+        stream->print(i + 1);
+        stream->print(F(",\"args\":{\"name\":\""));
+        stream->print(_sensorList[i]->getSensorNameAndLocation());
+        stream->print(F("\"}}"));
+    }
+
+    uint8_t first = (_phaseTraceHead + MS_VARIABLEARRAY_TRACE_SIZE -
+                     _phaseTraceCount) %
+        MS_VARIABLEARRAY_TRACE_SIZE;
+    for (uint8_t n = 0; n < _phaseTraceCount; n++) {
+        const phaseTraceEvent& event =
+            _phaseTrace[(first + n) % MS_VARIABLEARRAY_TRACE_SIZE];
+        trace_phase phase = static_cast<trace_phase>(event.phase & 0x7F);
+        // Each phase begins or ends a span: powered from power up to power
+        // down, awake from wake to sleep, and measuring from the start of a
+        // measurement to its result
+        const __FlashStringHelper* span  = F("update");
+        bool                       begin = true;
+        switch (phase) {
+            case TRACE_CYCLE_END: begin = false; break;
+            case TRACE_POWER_UP: span = F("powered"); break;
+            case TRACE_POWER_DOWN:
+                span  = F("powered");
+                begin = false;
+                break;
+            case TRACE_WAKE: span = F("awake"); break;
+            case TRACE_SLEEP:
+                span  = F("awake");
+                begin = false;
+                break;
+            case TRACE_MEASUREMENT_START: span = F("measuring"); break;
+            case TRACE_MEASUREMENT_RESULT:
+                span  = F("measuring");
+                begin = false;
+                break;
+            default: break;
+        }
+        stream->print(F(",\n{\"name\":\""));
+        stream->print(span);
+        stream->print(F("\",\"ph\":\""));
+        stream->print(begin ? 'B' : 'E');
+        // Trace times are in microseconds
+        stream->print(F("\",\"ts\":"));
+        stream->print(event.time);
+        stream->print(F("000,\"pid\":1,\"tid\":"));
+        stream->print(event.sensor < _sensorCount ? event.sensor + 1 : 0);
+        stream->print(F(",\"args\":{\"cycle\":"));
+        stream->print(event.cycle);
+        stream->print(F(",\"success\":"));
+        stream->print((event.phase & 0x80) ? F("false") : F("true"));
+        stream->print(F("}}"));
+    }
+    stream->println(F("\n]}"));
+#else
+    (void)stream;
+#endif
+}
+
+
 // Backward compatibility wrapper
-void VariableArray::printSensorData(Stream* stream) {
+void VariableArrayBase::printSensorData(Stream* stream) {
     printVariableData(stream);
 }
 
 
 // This function prints out the results for any connected sensors to a stream
 //  Calculated Variable results will be included
-void VariableArray::printVariableData(Stream* stream) {
+void VariableArrayBase::printVariableData(Stream* stream) {
     for (uint8_t i = 0; i < _variableCount; i++) {
         if (i > 0) {
             // Check if we need to add a line break between different sensors
@@ -680,26 +1303,26 @@ void VariableArray::printVariableData(Stream* stream) {
             if (differentSensors) { stream->println(); }
         }
         if (arrayOfVars[i]->isCalculated) {
-            stream->print(arrayOfVars[i]->getVarName());
+            stream->print(arrayOfVars[i]->getVarNameChars());
             stream->print(F(" ("));
-            stream->print(arrayOfVars[i]->getVarCode());
+            stream->print(arrayOfVars[i]->getVarCodeChars());
             stream->print(F(")"));
             stream->print(F(" is calculated to be "));
             stream->print(arrayOfVars[i]->getValueString());
             stream->print(F(" "));
-            stream->print(arrayOfVars[i]->getVarUnit());
+            stream->print(arrayOfVars[i]->getVarUnitChars());
             stream->println();
         } else {
             stream->print(arrayOfVars[i]->getParentSensorNameAndLocation());
             stream->print(F(" reports "));
-            stream->print(arrayOfVars[i]->getVarName());
+            stream->print(arrayOfVars[i]->getVarNameChars());
             stream->print(F(" ("));
-            stream->print(arrayOfVars[i]->getVarCode());
+            stream->print(arrayOfVars[i]->getVarCodeChars());
             stream->print(F(")"));
             stream->print(F(" is "));
             stream->print(arrayOfVars[i]->getValueString());
             stream->print(F(" "));
-            stream->print(arrayOfVars[i]->getVarUnit());
+            stream->print(arrayOfVars[i]->getVarUnitChars());
             stream->println();
         }
     }
@@ -707,7 +1330,7 @@ void VariableArray::printVariableData(Stream* stream) {
 
 
 // Check for unique sensors
-bool VariableArray::isLastVarFromSensor(int arrayIndex) {
+bool VariableArrayBase::isLastVarFromSensor(int arrayIndex) {
     // Calculated Variables are never the last variable from a sensor, simply
     // because the don't come from a sensor at all.
     if (arrayOfVars[arrayIndex]->isCalculated) {
@@ -726,15 +1349,15 @@ bool VariableArray::isLastVarFromSensor(int arrayIndex) {
 }
 
 
-bool VariableArray::getSensorStatusBit(int                        arrayIndex,
-                                       Sensor::sensor_status_bits bitToGet) {
+bool VariableArrayBase::getSensorStatusBit(
+    int arrayIndex, Sensor::sensor_status_bits bitToGet) {
     if (arrayIndex < 0 || arrayIndex >= _variableCount) { return false; }
     return arrayOfVars[arrayIndex]->parentSensor->getStatusBit(bitToGet);
 }
 
 
 // Check that all variable have valid UUIDs, if they are assigned
-bool VariableArray::checkVariableUUIDs() {
+bool VariableArrayBase::checkVariableUUIDs() {
     bool success = true;
     for (uint8_t i = 0; i < _variableCount; i++) {
         if (!arrayOfVars[i]->checkUUIDFormat()) {
@@ -750,9 +1373,9 @@ bool VariableArray::checkVariableUUIDs() {
         if (arrayOfVars[i]->getVarUUID() != nullptr &&
             strlen(arrayOfVars[i]->getVarUUID()) > 0) {
             for (uint8_t j = i + 1; j < _variableCount; j++) {
-                if (strcmp(arrayOfVars[i]->getVarUUID(),
-                           arrayOfVars[j]->getVarUUID()) == 0 &&
-                    strlen(arrayOfVars[j]->getVarUUID()) > 0) {
+                if (arrayOfVars[j]->getVarUUID() != nullptr &&
+                    strcmp(arrayOfVars[i]->getVarUUID(),
+                           arrayOfVars[j]->getVarUUID()) == 0) {
                     PRINTOUT(arrayOfVars[i]->getVarCode(),
                              F("has a non-unique UUID!"));
                     success = false;
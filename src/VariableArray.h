@@ -5,9 +5,10 @@
  * This library is published under the BSD-3 license.
  * @author Sara Geleskie Damiano <sdamiano@stroudcenter.org>
  *
- * @brief Contains the VariableArray class.
+ * @brief Contains the VariableArrayBase class and the VariableArray and
+ * StaticVariableArray classes that keep its storage.
  *
- * @copydetails VariableArray
+ * @copydetails VariableArrayBase
  */
 
 // Header Guards
@@ -71,42 +72,28 @@
  * When creating a logger, the order of variables in the array determines the
  * order the values will be written to the data file.
  *
+ * The logic lives in VariableArrayBase, which reaches its sensor list and
+ * calculation plan through pointers to storage kept by the derived class.  A
+ * plain VariableArray keeps fixed arrays with room for #MAX_NUMBER_SENSORS
+ * sensors and #MAX_NUMBER_CALCULATED_VARS calculated variables; a
+ * StaticVariableArray keeps arrays sized exactly by its template arguments.
+ * Both can be given to a logger.
+ *
  * @ingroup base_classes
  *
  */
-class VariableArray {
+class VariableArrayBase {
  public:
-    // Constructors
     /**
-     * @brief Construct a new Variable Array object
-     *
-     * @param variableCount The number of variables in the array
-     * @param variableList An array of pointers to variable objects.  The
-     * pointers may be to calculated or measured variable objects.
-     * @param uuids An array of UUIDs.  These are linked 1-to-1 with the
-     * variables by array position.
+     * @brief A variable array keeps pointers to storage in the derived object,
+     * so it can't be copied.
      */
-    VariableArray(uint8_t variableCount, Variable* variableList[],
-                  const char* uuids[]);
+    VariableArrayBase(const VariableArrayBase&) = delete;
     /**
-     * @brief Construct a new Variable Array object
-     *
-     * @param variableCount The number of variables in the array
-     * @param variableList An array of pointers to variable objects.  The
-     * pointers may be to calculated or measured variable objects.
-     */
-    VariableArray(uint8_t variableCount, Variable* variableList[]);
-    /**
-     * @brief Construct a new Variable Array object without initialization.
-     *
-     * Use this constructor when the variable list is not yet available.
-     * Call begin() to initialize the array before use.
+     * @brief A variable array keeps pointers to storage in the derived object,
+     * so it can't be copied.
      */
-    VariableArray();
-    /**
-     * @brief Destroy the Variable Array object - no action taken.
-     */
-    ~VariableArray() = default;
+    VariableArrayBase& operator=(const VariableArrayBase&) = delete;
 
     // "Begins" the VariableArray - attaches the number and array of variables
     // Not doing this in the constructor because we expect the VariableArray to
@@ -143,6 +130,10 @@ class VariableArray {
     /**
      * @brief Begins the VariableArray.  Checks the validity of all UUIDs and
      * outputs the results.
+     *
+     * This also plans the order calculated variables are evaluated in, from
+     * the inputs declared with Variable::setInputs().  Call begin() again if
+     * the inputs of any variable in the array change.
      */
     void begin();
 
@@ -260,6 +251,10 @@ class VariableArray {
      * values.  Repeatedly checks each sensor's readiness state to optimize
      * timing.
      *
+     * Once all sensors are finished, the calculated variables are updated in
+     * the order planned by begin(), so any calculated variable is updated
+     * after the calculated variables it takes as inputs.
+     *
      * @param powerUp If true, powers up all sensors before updating.
      * @param wake If true, wakes all sensors before updating.
      * @param sleep If true, puts all sensors to sleep after updating.
@@ -269,6 +264,133 @@ class VariableArray {
      */
     bool completeUpdate(bool powerUp = true, bool wake = true,
                         bool sleep = true, bool powerDown = true);
+    /**
+     * @brief Set the logged time of the next completeUpdate(), so only the
+     * sensors due at that time are updated.
+     *
+     * Sensors whose own logging interval (see Sensor::setLoggingInterval())
+     * doesn't divide the time are not powered, woken, or measured in the next
+     * completeUpdate() and their variables are set to #MS_INVALID_VALUE.  The
+     * time only applies to the next completeUpdate(); later updates include
+     * every sensor unless this is called again.  sensorsPowerUp(),
+     * sensorsWake(), sensorsSleep(), and sensorsPowerDown() always act on
+     * every sensor.
+     *
+     * Only a logged update counts toward each sensor's failing sensor breaker
+     * (see Sensor::setBreakerThreshold()) and skips the sensors it has opened
+     * for.
+     *
+     * @param localEpoch The logged time in seconds since the epoch, or 0 to
+     * update every sensor.
+     * @param logged True if the values of the next update will be logged.
+     */
+    void setUpdateTime(uint32_t localEpoch, bool logged = true);
+
+    /**
+     * @brief Replay a full completeUpdate() cycle in virtual time without
+     * touching any sensor hardware.
+     *
+     * Instead of polling the sensors against millis(), the virtual clock jumps
+     * directly to the next deadline in the array as derived from each sensor's
+     * warm-up, stabilization, and measurement times and its number of
+     * measurements to average.  Power pins are cut following the same rules as
+     * completeUpdate(), so sensors that share a power pin stay powered until
+     * the last of them finishes.
+     *
+     * The simulation assumes every sensor powers, wakes, and measures
+     * successfully on the first attempt and that each phase starts the moment
+     * the previous one ends, as it does for sensors that actively wake and
+     * start measurements.  Sensors that rely on the passive Sensor::wake() or
+     * Sensor::startSingleMeasurement() and sensors that poll their own
+     * hardware for readiness will usually finish sooner than predicted.
+     *
+     * If a stream is given, the per-sensor completion time, powered time and
+     * idle time (powered after finishing, waiting for a shared pin) and the
+     * on-time of each power pin are printed to it.
+     *
+     * @param stream An Arduino Stream instance to print the timing report to;
+     * optional.
+     * @return The predicted time in milliseconds from power up until the last
+     * sensor finishes measuring.
+     */
+    uint32_t simulateCompleteUpdate(Stream* stream = nullptr);
+
+    /**
+     * @brief Reorder the internal sensor list to shorten the time each power
+     * rail is on.
+     *
+     * Sensors connected through shared primary or secondary power pins are
+     * grouped together.  Groups are ordered by the expected latency (warm-up +
+     * stabilization + all measurements) of their slowest sensor, and within a
+     * group the slowest sensor comes first.  Because completeUpdate() wakes
+     * and starts sensors in list order on every pass, this means the sensors
+     * that hold each rail on the longest have their (often blocking) wake and
+     * start commands sent before the faster sensors.
+     *
+     * This only changes the order that sensors are serviced in; it does not
+     * change the order of the variables or the data columns.
+     *
+     * @note This is opt-in and must be called after begin(), which rebuilds
+     * the sensor list in variable order.
+     */
+    void optimizeSensorOrder();
+
+    /**
+     * @brief Print the predicted and achieved on-time of each power pin.
+     *
+     * The predicted time comes from simulateCompleteUpdate().  The achieved
+     * time is how long after power up the pin was cut during the last
+     * completeUpdate().
+     *
+     * @param stream An Arduino Stream instance
+     */
+    void printPowerPinReport(Stream* stream = &Serial);
+
+    /**
+     * @brief The sensor phases recorded in the phase trace.
+     */
+    enum trace_phase : uint8_t {
+        TRACE_CYCLE_START = 0,    ///< completeUpdate() started
+        TRACE_CYCLE_END,          ///< completeUpdate() finished
+        TRACE_POWER_UP,           ///< Sensor::powerUp() returned
+        TRACE_WAKE,               ///< Sensor::wake() returned
+        TRACE_MEASUREMENT_START,  ///< Sensor::startSingleMeasurement() returned
+        TRACE_MEASUREMENT_RESULT,  ///< Sensor::addSingleMeasurementResult()
+                                   ///< returned
+        TRACE_SLEEP,       ///< Sensor::sleep() returned
+        TRACE_POWER_DOWN,  ///< Sensor::powerDown() returned
+    };
+
+    /**
+     * @brief Print the sensor phase trace as CSV.
+     *
+     * Each line has the update cycle number, the millis() time the event was
+     * recorded, the sensor name and location (blank for the start and end of
+     * an update), the phase, and whether the call succeeded.  The oldest event
+     * comes first.  Nothing is printed unless #MS_VARIABLEARRAY_TRACE_SIZE is
+     * set.
+     *
+     * To save the trace to the SD card, pass an open SdFat file.
+     *
+     * @param stream An Arduino Stream instance
+     */
+    void printPhaseTraceCSV(Stream* stream = &Serial);
+    /**
+     * @brief Print the sensor phase trace as a Chrome trace event JSON object.
+     *
+     * Each sensor is shown as a thread with nested "powered", "awake", and
+     * "measuring" spans, and each update as a "complete update" span.  The
+     * output can be loaded into chrome://tracing or https://ui.perfetto.dev.
+     * Spans whose start has already been overwritten in the ring are left
+     * unmatched.
+     *
+     * @param stream An Arduino Stream instance
+     */
+    void printPhaseTraceJSON(Stream* stream = &Serial);
+    /**
+     * @brief Discard all events in the sensor phase trace.
+     */
+    void clearPhaseTrace();
 
     /**
      * @brief Print out the results for all variables in the variable array to a
@@ -306,6 +428,32 @@ class VariableArray {
      */
     uint8_t _sensorCount;
 
+    /**
+     * @brief Construct a new Variable Array object that keeps its sensor list
+     * and calculation plan in storage supplied by the derived class.
+     *
+     * The storage must already be constructed, so the derived class inherits
+     * it from a VariableArrayStorage listed before this class.
+     *
+     * @param variableCount The number of variables in the array
+     * @param variableList An array of pointers to variable objects.
+     * @param uuids An array of UUIDs, or nullptr.
+     * @param sensorList Storage for the unique sensors.
+     * @param powerCutAfter_ms Storage for the power cut time of each sensor.
+     * @param maxSensors The number of sensors both arrays can hold.
+     * @param calculationPlan Storage for the calculated variable order.
+     * @param maxCalculated The number of calculated variables the plan can
+     * hold.
+     */
+    VariableArrayBase(uint8_t variableCount, Variable* variableList[],
+                      const char* uuids[], Sensor** sensorList,
+                      uint32_t* powerCutAfter_ms, uint8_t maxSensors,
+                      uint8_t* calculationPlan, uint8_t maxCalculated);
+    /**
+     * @brief Destroy the Variable Array object - no action taken.
+     */
+    ~VariableArrayBase() = default;
+
  private:
     /**
      * @brief Check if the current variable is the last variable that the sensor
@@ -363,6 +511,16 @@ class VariableArray {
      */
     bool isMeasurementAttempted(uint8_t sensorIndex);
 
+    /**
+     * @brief Check if a sensor is due to be updated at the time set by
+     * setUpdateTime() and, in a logged update, isn't being skipped because it
+     * keeps failing.
+     *
+     * @param sensorIndex The index of the sensor in the sensor list.
+     * @return True if the sensor should be updated.
+     */
+    bool isSensorDue(uint8_t sensorIndex);
+
     /**
      * @brief Check if all required measurements are complete for a sensor.
      *
@@ -398,6 +556,64 @@ class VariableArray {
      */
     bool canPowerDownSensor(uint8_t sensorIndex);
 
+    /**
+     * @brief Idle the processor until the next expected event of any sensor
+     * that still needs measurements.
+     *
+     * The idle time is the smallest Sensor::getMillisToNextEvent() of the
+     * unfinished sensors, capped at #MS_VARIABLEARRAY_MAX_IDLE_MS.  Returns
+     * immediately if any sensor needs to be polled now.  Only used when
+     * #MS_VARIABLEARRAY_IDLE_BETWEEN_EVENTS is enabled.
+     */
+    void idleUntilNextEvent();
+
+    /**
+     * @brief Run the virtual-time replay of completeUpdate() used by
+     * simulateCompleteUpdate() and printPowerPinReport().
+     *
+     * @param finishedAt Filled with the time each sensor finished measuring.
+     * @param powerCutAt Filled with the time each sensor cut its power pins, or
+     * UINT32_MAX if it didn't.
+     * @return The predicted time until the last sensor finishes measuring.
+     */
+    uint32_t runUpdateSimulation(uint32_t finishedAt[], uint32_t powerCutAt[]);
+
+    /**
+     * @brief Get the distinct power pins used by the sensors in the array.
+     *
+     * @param pins An array of at least 2 * #MAX_NUMBER_SENSORS to fill
+     * @return The number of distinct pins
+     */
+    uint8_t getPowerPins(int8_t pins[]);
+
+    /**
+     * @brief Get the time a power pin was cut - the earliest cut time of any
+     * sensor using the pin.
+     *
+     * @param pin The power pin
+     * @param cutTimes The time each sensor in the list cut its power
+     * @return The time the pin was cut, or UINT32_MAX if it never was.
+     */
+    uint32_t getPinCutTime(int8_t pin, const uint32_t cutTimes[]);
+
+    /**
+     * @brief Record a sensor phase in the phase trace.  Does nothing unless
+     * #MS_VARIABLEARRAY_TRACE_SIZE is set.
+     *
+     * @param sensor The index of the sensor in #_sensorList, or
+     * #TRACE_NO_SENSOR for the start and end of an update.
+     * @param phase The phase
+     * @param success Whether the sensor call succeeded
+     */
+    void tracePhase(uint8_t sensor, trace_phase phase, bool success = true);
+    /**
+     * @brief Get the name of a phase in the phase trace.
+     *
+     * @param phase The phase
+     * @return The phase name
+     */
+    static const __FlashStringHelper* getTracePhaseName(trace_phase phase);
+
     /**
      * @brief Get a specific status bit from the sensor tied to a variable in
      * the array.
@@ -418,11 +634,97 @@ class VariableArray {
      * @return True if the sensor list was populated successfully
      */
     bool populateSensorList();
+    /**
+     * @brief Plan the order the calculated variables are evaluated in so each
+     * comes after any calculated variables in the array it takes as inputs.
+     *
+     * Calculated variables without declared inputs keep their array order.
+     * Any caught in a dependency loop are evaluated last, in array order.
+     */
+    void planCalculations();
+    /**
+     * @brief Check if a variable is already in #_calculationPlan.
+     *
+     * @param arrayIndex The position of the variable in the variable array.
+     * @return True if the variable has been planned.
+     */
+    bool isPlanned(uint8_t arrayIndex);
 
     /**
      * @brief Array of pointers to unique sensors derived from variables
      */
-    Sensor* _sensorList[MAX_NUMBER_SENSORS] = {};
+    Sensor** _sensorList;
+
+    /**
+     * @brief The time in milliseconds after power up that each sensor in
+     * #_sensorList cut its power during the last completeUpdate(), or
+     * UINT32_MAX if it did not.
+     */
+    uint32_t* _powerCutAfter_ms;
+    /**
+     * @brief The number of sensors #_sensorList and #_powerCutAfter_ms can
+     * hold.
+     */
+    uint8_t _maxSensors;
+    /**
+     * @brief The logged time of the next completeUpdate(), or 0 to update
+     * every sensor.
+     */
+    uint32_t _updateTime = 0;
+    /**
+     * @brief True if the next completeUpdate() is logged and counts toward the
+     * failing sensor breakers.
+     */
+    bool _loggedUpdate = false;
+
+    /**
+     * @brief The positions in the variable array of the calculated variables,
+     * in the order they are evaluated.
+     */
+    uint8_t* _calculationPlan;
+    /**
+     * @brief The number of calculated variables #_calculationPlan can hold.
+     */
+    uint8_t _maxCalculated;
+    /**
+     * @brief The number of variables in #_calculationPlan, or 0 if the
+     * calculated variables are evaluated in array order.
+     */
+    uint8_t _calculationPlanCount = 0;
+
+    /**
+     * @brief The sensor index recorded for events that aren't tied to a
+     * sensor.
+     */
+    static const uint8_t TRACE_NO_SENSOR = 0xFF;
+
+#if MS_VARIABLEARRAY_TRACE_SIZE > 0
+    /**
+     * @brief One event in the sensor phase trace.
+     */
+    struct phaseTraceEvent {
+        uint32_t time;    ///< The millis() time the event was recorded
+        uint16_t cycle;   ///< The update cycle number
+        uint8_t  sensor;  ///< The index of the sensor in #_sensorList
+        uint8_t  phase;   ///< The phase, with the high bit set on failure
+    };
+    /**
+     * @brief The ring of trace events.
+     */
+    phaseTraceEvent _phaseTrace[MS_VARIABLEARRAY_TRACE_SIZE];
+    /**
+     * @brief The index in #_phaseTrace the next event will be written to.
+     */
+    uint8_t _phaseTraceHead = 0;
+    /**
+     * @brief The number of events in #_phaseTrace.
+     */
+    uint8_t _phaseTraceCount = 0;
+    /**
+     * @brief The number of the current update cycle.
+     */
+    uint16_t _phaseTraceCycle = 0;
+#endif
 
 #ifdef MS_VARIABLEARRAY_DEBUG_DEEP
     /**
@@ -450,4 +752,166 @@ class VariableArray {
 #endif  // MS_VARIABLEARRAY_DEBUG_DEEP
 };
 
+
+/**
+ * @brief The sensor list and calculation plan of a variable array.
+ *
+ * A variable array inherits this ahead of VariableArrayBase so the arrays are
+ * constructed before the VariableArrayBase constructor fills them in.
+ *
+ * @tparam SensorCount The number of unique sensors the list can hold.
+ * @tparam CalculatedCount The number of calculated variables the plan can
+ * hold.
+ */
+template <uint8_t SensorCount, uint8_t CalculatedCount>
+class VariableArrayStorage {
+ protected:
+    /**
+     * @brief Storage for the unique sensors tied to the variables.
+     */
+    Sensor* _storedSensors[SensorCount];
+    /**
+     * @brief Storage for the power cut time of each sensor.
+     */
+    uint32_t _storedPowerCutAfter_ms[SensorCount];
+    /**
+     * @brief Storage for the calculated variable order.
+     */
+    uint8_t _storedCalculationPlan[CalculatedCount > 0 ? CalculatedCount : 1];
+};
+
+
+/**
+ * @brief A variable array with room for #MAX_NUMBER_SENSORS sensors and
+ * #MAX_NUMBER_CALCULATED_VARS calculated variables.
+ *
+ * @copydetails VariableArrayBase
+ *
+ * @ingroup base_classes
+ */
+class VariableArray
+    : private VariableArrayStorage<MAX_NUMBER_SENSORS,
+                                   MAX_NUMBER_CALCULATED_VARS>,
+      public VariableArrayBase {
+ public:
+    // Constructors
+    /**
+     * @brief Construct a new Variable Array object
+     *
+     * @param variableCount The number of variables in the array
+     * @param variableList An array of pointers to variable objects.  The
+     * pointers may be to calculated or measured variable objects.
+     * @param uuids An array of UUIDs.  These are linked 1-to-1 with the
+     * variables by array position.
+     */
+    VariableArray(uint8_t variableCount, Variable* variableList[],
+                  const char* uuids[]);
+    /**
+     * @brief Construct a new Variable Array object
+     *
+     * @param variableCount The number of variables in the array
+     * @param variableList An array of pointers to variable objects.  The
+     * pointers may be to calculated or measured variable objects.
+     */
+    VariableArray(uint8_t variableCount, Variable* variableList[]);
+    /**
+     * @brief Construct a new Variable Array object without initialization.
+     *
+     * Use this constructor when the variable list is not yet available.
+     * Call begin() to initialize the array before use.
+     */
+    VariableArray();
+    /**
+     * @brief Destroy the Variable Array object - no action taken.
+     */
+    ~VariableArray() = default;
+};
+
+
+/**
+ * @brief A variable array with its sensor list sized at compile time.
+ *
+ * A plain VariableArray has room for #MAX_NUMBER_SENSORS sensors and
+ * #MAX_NUMBER_CALCULATED_VARS calculated variables.  This keeps arrays sized
+ * exactly to the sensors and calculated variables given as template
+ * parameters instead, and getStorageSize() is a constant.  It can be given to
+ * a logger like a VariableArray.
+ *
+ * The variable count is taken from the size of the variable list:
+ *
+ * @code{.cpp}
+ * Variable* variableList[] = {...};
+ * // 3 sensors and 1 calculated variable
+ * StaticVariableArray<3, 1> varArray(variableList, UUIDs);
+ * @endcode
+ *
+ * The sensor count is given by hand because the variables only find their
+ * sensors at run time; the sensors are still found and deduplicated when the
+ * list is populated.  If the variables are tied to more sensors than
+ * @p SensorCount, the extra sensors are dropped and begin() prints a warning.
+ * If there are more calculated variables than @p CalculatedCount they are
+ * evaluated in array order instead of by their declared inputs.
+ *
+ * @tparam SensorCount The number of unique sensors tied to the variables; at
+ * most #MAX_NUMBER_SENSORS.
+ * @tparam CalculatedCount The number of calculated variables to plan the
+ * order of.
+ *
+ * @ingroup base_classes
+ */
+template <uint8_t SensorCount, uint8_t CalculatedCount = 0>
+class StaticVariableArray
+    : private VariableArrayStorage<SensorCount, CalculatedCount>,
+      public VariableArrayBase {
+    static_assert(SensorCount > 0 && SensorCount <= MAX_NUMBER_SENSORS,
+                  "SensorCount must be between 1 and MAX_NUMBER_SENSORS");
+    /// The storage, constructed before VariableArrayBase
+    typedef VariableArrayStorage<SensorCount, CalculatedCount> Storage;
+
+ public:
+    /**
+     * @brief Construct a new Static Variable Array object
+     *
+     * @tparam VariableCount The number of variables, from the size of the
+     * list.
+     * @param variableList An array of pointers to variable objects.  The
+     * pointers may be to calculated or measured variable objects.
+     * @param uuids An array of UUIDs.  These are linked 1-to-1 with the
+     * variables by array position.
+     */
+    template <size_t VariableCount>
+    explicit StaticVariableArray(Variable* (&variableList)[VariableCount],
+                                 const char* uuids[] = nullptr)
+        : VariableArrayBase(VariableCount, variableList, uuids,
+                            Storage::_storedSensors,
+                            Storage::_storedPowerCutAfter_ms, SensorCount,
+                            Storage::_storedCalculationPlan,
+                            CalculatedCount) {
+        static_assert(VariableCount > 0 && VariableCount <= UINT8_MAX,
+                      "A variable array holds between 1 and 255 variables");
+    }
+    /**
+     * @brief Construct a new Static Variable Array object without
+     * initialization.
+     *
+     * Call begin() to initialize the array before use.
+     */
+    StaticVariableArray()
+        : VariableArrayBase(0, nullptr, nullptr, Storage::_storedSensors,
+                            Storage::_storedPowerCutAfter_ms, SensorCount,
+                            Storage::_storedCalculationPlan,
+                            CalculatedCount) {}
+
+    /**
+     * @brief Get the number of bytes the array keeps for its sensor list and
+     * calculation plan.
+     *
+     * @return The size of the storage in bytes.
+     */
+    static constexpr size_t getStorageSize() {
+        return sizeof(Sensor*[SensorCount]) + sizeof(uint32_t[SensorCount]) +
+            sizeof(uint8_t[CalculatedCount > 0 ? CalculatedCount : 1]);
+    }
+};
+
 #endif  // SRC_VARIABLEARRAY_H_
@@ -52,6 +52,22 @@ Variable::Variable(float (*calcFxn)(), uint8_t decimalResolution,
     if (calcFxn) setCalculation(calcFxn);
 }
 
+// The constructor for a calculated variable whose value is calculated by a
+// derived class
+Variable::Variable(uint8_t decimalResolution, const char* varName,
+                   const char* varUnit, const char* varCode, const char* uuid)
+    : parentSensor(nullptr),
+      isCalculated(true),
+      _currentValue(MS_INVALID_VALUE),
+      _calcFxn(nullptr),
+      _sensorVarNum(0) {
+    if (uuid) setVarUUID(uuid);
+    if (varCode) setVarCode(varCode);
+    if (varUnit) setVarUnit(varUnit);
+    if (varName) setVarName(varName);
+    setResolution(decimalResolution);
+}
+
 
 // This notifies the parent sensor that it has an observing variable
 // This function should never be called for a calculated variable
@@ -67,7 +83,7 @@ void Variable::attachSensor(Sensor* parentSense) {
 // This function should never be called for a calculated variable
 void Variable::onSensorUpdate(Sensor* parentSense) {
     if (!isCalculated) {
-        _currentValue = parentSense->sensorValues[_sensorVarNum];
+        setCurrentValue(parentSense->sensorValues[_sensorVarNum]);
         MS_DBG(F("... received"), _currentValue);
     }
 }
@@ -99,12 +115,39 @@ String Variable::getParentSensorNameAndLocation() {
         return parentSensor->getSensorNameAndLocation();
     }
 }
+// This prints the name of the parent sensor without copying it into a String
+size_t Variable::printParentSensorName(Stream* stream) {
+    if (isCalculated) {
+        return stream->print(F("Calculated"));
+    } else if (parentSensor == nullptr) {
+        MS_DBG(F("ERROR! This variable is missing a parent sensor!"));
+        return 0;
+    } else {
+        return parentSensor->printSensorName(stream);
+    }
+}
 
 
 // This ties a calculated variable to its calculation function
 void Variable::setCalculation(float (*calcFxn)()) {
-    _calcFxn     = calcFxn;
-    isCalculated = (calcFxn != nullptr);
+    _calcFxn              = calcFxn;
+    isCalculated          = (calcFxn != nullptr);
+    _calculatedFromInputs = false;
+}
+
+
+// This sets the variables a calculated variable depends on
+void Variable::setInputs(Variable* inputList[], uint8_t inputCount) {
+    _inputs               = inputList;
+    _inputCount           = inputList == nullptr ? 0 : inputCount;
+    _calculatedFromInputs = false;
+}
+uint8_t Variable::getInputCount() {
+    return _inputCount;
+}
+Variable* Variable::getInput(uint8_t inputNumber) {
+    if (inputNumber >= _inputCount) return nullptr;
+    return _inputs[inputNumber];
 }
 
 
@@ -121,6 +164,9 @@ void Variable::setResolution(uint8_t decimalResolution) {
 String Variable::getVarName() {
     return _varName;
 }
+const char* Variable::getVarNameChars() {
+    return _varName != nullptr ? _varName : "";
+}
 void Variable::setVarName(const char* varName) {
     _varName = varName;
 }
@@ -129,6 +175,9 @@ void Variable::setVarName(const char* varName) {
 String Variable::getVarUnit() {
     return _varUnit;
 }
+const char* Variable::getVarUnitChars() {
+    return _varUnit != nullptr ? _varUnit : "";
+}
 void Variable::setVarUnit(const char* varUnit) {
     _varUnit = varUnit;
 }
@@ -137,6 +186,9 @@ void Variable::setVarUnit(const char* varUnit) {
 String Variable::getVarCode() {
     return _varCode;
 }
+const char* Variable::getVarCodeChars() {
+    return _varCode != nullptr ? _varCode : "";
+}
 // This sets the variable code to a new custom value
 void Variable::setVarCode(const char* varCode) {
     _varCode = varCode;
@@ -200,14 +252,7 @@ float Variable::getValue(bool updateValue) {
         // different values each time - i.e., the data on the CSV and each
         // publisher will report a different value. That is **NOT** the desired
         // behavior.  Thus, we stash the value.
-        if (updateValue && _calcFxn != nullptr) {
-            _currentValue = _calcFxn();
-        } else if (updateValue && _calcFxn == nullptr) {
-            // If no calculation function is set, return error value
-            _currentValue = MS_INVALID_VALUE;
-            MS_DBG(F("ERROR! Calculated variable"), getVarCode(),
-                   F("has no calculation function!"));
-        }
+        if (updateValue) { runCalculation(); }
         return _currentValue;
     } else {
         if (updateValue && parentSensor != nullptr) {
@@ -223,6 +268,56 @@ float Variable::getValue(bool updateValue) {
 }
 
 
+// This stores a new value and counts it if it changed
+void Variable::setCurrentValue(float value) {
+    if (value != _currentValue) { _valueChanges++; }
+    _currentValue = value;
+}
+
+
+// This runs the calculation function unless the declared inputs show it would
+// give the same result or can't give a valid one
+void Variable::runCalculation() {
+    if (_inputCount > 0) {
+        uint8_t changeStamp = 0;
+        bool    inputsValid = true;
+        for (uint8_t i = 0; i < _inputCount; i++) {
+            if (_inputs[i] == nullptr) continue;
+            changeStamp += _inputs[i]->_valueChanges;
+            float inputValue = _inputs[i]->_currentValue;
+            if (inputValue == MS_INVALID_VALUE || isnan(inputValue)) {
+                inputsValid = false;
+            }
+        }
+        if (_calculatedFromInputs && changeStamp == _inputChangeStamp) {
+            MS_DBG(F("Inputs to"), getVarCode(),
+                   F("are unchanged; keeping"), _currentValue);
+            return;
+        }
+        _inputChangeStamp     = changeStamp;
+        _calculatedFromInputs = true;
+        if (!inputsValid) {
+            MS_DBG(F("Skipping calculation of"), getVarCode(),
+                   F("because an input is invalid"));
+            setCurrentValue(MS_INVALID_VALUE);
+            return;
+        }
+    }
+    setCurrentValue(calculateValue());
+}
+
+// This runs the calculation function
+float Variable::calculateValue() {
+    if (_calcFxn == nullptr) {
+        // If no calculation function is set, return error value
+        MS_DBG(F("ERROR! Calculated variable"), getVarCode(),
+               F("has no calculation function!"));
+        return MS_INVALID_VALUE;
+    }
+    return _calcFxn();
+}
+
+
 // This returns the current value of the variable as a string
 // with the correct number of significant figures
 String Variable::getValueString(bool updateValue) {
@@ -233,11 +328,181 @@ String Variable::getValueString(bool updateValue) {
 // This returns a particular value of the variable as a string
 // with the correct number of significant figures
 String Variable::formatValueString(float value) {
-    // Need this because otherwise get extra spaces in strings from int
-    if (_decimalResolution == 0) {
-        auto val = static_cast<int32_t>(value);
-        return String(val);
-    } else {
-        return String(value, _decimalResolution);
+    char buffer[VALUE_BUFFER_SIZE];
+    formatValueChars(value, buffer);
+    return String(buffer);
+}
+
+
+// This writes the current value of the variable into a buffer
+uint8_t Variable::getValueChars(char buffer[], bool updateValue) {
+    return formatValueChars(getValue(updateValue), buffer);
+}
+
+
+// Powers of ten for the fraction digits
+static const uint32_t valuePowersOf10[Variable::MAX_VALUE_DECIMALS + 1] = {
+    1,      10,      100,      1000,      10000,
+    100000, 1000000, 10000000, 100000000, 1000000000};
+
+// This splits a value into its whole part and its rounded fraction
+void Variable::splitValue(float value, uint8_t decimals, uint32_t& whole,
+                          uint32_t& fraction) {
+    // Splitting off the whole part is exact, and so is the fraction as a
+    // 24-bit mantissa times a power of two, so the fraction can be scaled and
+    // rounded with integer arithmetic alone
+    float    magnitude = fabs(value);
+    uint32_t scale     = valuePowersOf10[decimals];
+    whole              = static_cast<uint32_t>(magnitude);
+    fraction           = 0;
+    if (decimals > 0) {
+        float    part = magnitude - whole;
+        uint32_t bits;
+        memcpy(&bits, &part, sizeof(bits));
+        uint8_t  exponent = (bits >> 23) & 0xFF;
+        uint32_t mantissa = bits & 0x7FFFFFUL;
+        if (exponent > 0) {
+            mantissa |= 0x800000UL;
+        } else {
+            exponent = 1;  // subnormal
+        }
+        // The fraction is mantissa / 2^shift; being less than one, the shift
+        // is at least 24.  Beyond 63 the scaled fraction is less than a half.
+        uint8_t shift = 150 - exponent;
+        if (mantissa != 0 && shift < 64) {
+            uint64_t scaled = static_cast<uint64_t>(mantissa) * scale;
+            fraction        = static_cast<uint32_t>(
+                (scaled + (static_cast<uint64_t>(1) << (shift - 1))) >> shift);
+        }
+        if (fraction >= scale) {
+            whole++;
+            fraction -= scale;
+        }
+    }
+}
+
+// This writes a value into a buffer with the variable's resolution using
+// integer arithmetic for everything but splitting off the fraction
+uint8_t Variable::formatValueChars(float value, char buffer[]) {
+    uint8_t len = 0;
+    if (isnan(value)) {
+        strcpy(buffer, "nan");
+        return 3;
+    }
+    if (value < 0 && (_decimalResolution > 0 || value <= -1)) {
+        buffer[len++] = '-';
     }
+    float magnitude = fabs(value);
+    if (isinf(value)) {
+        strcpy(buffer + len, "inf");
+        return len + 3;
+    }
+    // A resolution of 0 truncates, like the cast to int32_t this replaced
+    if (magnitude > (_decimalResolution == 0 ? 2147483520.0f : 4294967040.0f)) {
+        strcpy(buffer, "ovf");
+        return 3;
+    }
+
+    uint8_t  decimals = _decimalResolution < MAX_VALUE_DECIMALS
+         ? _decimalResolution
+         : MAX_VALUE_DECIMALS;
+    uint32_t whole;
+    uint32_t fraction;
+    splitValue(magnitude, decimals, whole, fraction);
+
+    // Write the whole part, then reverse it into place
+    uint8_t start = len;
+    do {
+        buffer[len++] = '0' + whole % 10;
+        whole /= 10;
+    } while (whole > 0);
+    for (uint8_t i = start, j = len - 1; i < j; i++, j--) {
+        char c    = buffer[i];
+        buffer[i] = buffer[j];
+        buffer[j] = c;
+    }
+
+    // Write the fraction, padded with leading zeros
+    if (decimals > 0) {
+        buffer[len++] = '.';
+        for (uint8_t i = decimals; i > 0; i--) {
+            buffer[len + i - 1] = '0' + fraction % 10;
+            fraction /= 10;
+        }
+        len += decimals;
+    }
+    buffer[len] = '\0';
+    return len;
+}
+
+
+// ============================================================================
+//  The variable for the state of a sensor's failing sensor breaker
+// ============================================================================
+
+SensorBreakerState::SensorBreakerState(Sensor* sensor, const char* uuid,
+                                       const char* varCode)
+    : Variable(SENSOR_BREAKER_STATE_RESOLUTION, SENSOR_BREAKER_STATE_VAR_NAME,
+               SENSOR_BREAKER_STATE_UNIT_NAME, varCode, uuid),
+      _sensor(sensor) {}
+
+// This reports the breaker state left by the last update
+float SensorBreakerState::calculateValue() {
+    if (_sensor == nullptr) { return MS_INVALID_VALUE; }
+    return _sensor->getBreakerState();
+}
+
+
+// ============================================================================
+//  The variables for the statistics of a sensor's result
+// ============================================================================
+
+// The statistics are kept by the sensor, so they're enabled here
+ResultStatistic::ResultStatistic(Sensor* parentSense, uint8_t sensorVarNum,
+                                 uint8_t decimalResolution, const char* varName,
+                                 const char* varUnit, const char* varCode,
+                                 const char* uuid)
+    : Variable(decimalResolution, varName, varUnit, varCode, uuid),
+      _sensor(parentSense),
+      _resultNumber(sensorVarNum) {
+    if (_sensor != nullptr) { _sensor->enableStatistics(); }
+}
+
+
+ResultStandardDeviation::ResultStandardDeviation(
+    Sensor* parentSense, uint8_t sensorVarNum, uint8_t decimalResolution,
+    const char* varName, const char* varUnit, const char* varCode,
+    const char* uuid)
+    : ResultStatistic(parentSense, sensorVarNum, decimalResolution, varName,
+                      varUnit, varCode, uuid) {}
+
+float ResultStandardDeviation::calculateValue() {
+    if (_sensor == nullptr) { return MS_INVALID_VALUE; }
+    return _sensor->getStandardDeviation(_resultNumber);
+}
+
+
+ResultMinimum::ResultMinimum(Sensor* parentSense, uint8_t sensorVarNum,
+                             uint8_t decimalResolution, const char* varName,
+                             const char* varUnit, const char* varCode,
+                             const char* uuid)
+    : ResultStatistic(parentSense, sensorVarNum, decimalResolution, varName,
+                      varUnit, varCode, uuid) {}
+
+float ResultMinimum::calculateValue() {
+    if (_sensor == nullptr) { return MS_INVALID_VALUE; }
+    return _sensor->getMinimum(_resultNumber);
+}
+
+
+ResultMaximum::ResultMaximum(Sensor* parentSense, uint8_t sensorVarNum,
+                             uint8_t decimalResolution, const char* varName,
+                             const char* varUnit, const char* varCode,
+                             const char* uuid)
+    : ResultStatistic(parentSense, sensorVarNum, decimalResolution, varName,
+                      varUnit, varCode, uuid) {}
+
+float ResultMaximum::calculateValue() {
+    if (_sensor == nullptr) { return MS_INVALID_VALUE; }
+    return _sensor->getMaximum(_resultNumber);
 }
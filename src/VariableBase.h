@@ -63,6 +63,16 @@ class Sensor;
  */
 class Variable {
  public:
+    /**
+     * @brief The size of a buffer big enough for any value formatted by
+     * formatValueChars(), including the terminating null.
+     */
+    static const uint8_t VALUE_BUFFER_SIZE = 22;
+    /**
+     * @brief The most decimal places formatValueChars() will write.
+     */
+    static const uint8_t MAX_VALUE_DECIMALS = 9;
+
     /**
      * @brief Construct a new Variable objectfor a measured variable - that is,
      * one whose values are updated by a sensor.
@@ -151,6 +161,14 @@ class Variable {
      * @return The parent sensor's concatenated name and location.
      */
     String getParentSensorNameAndLocation();
+    /**
+     * @brief Print the parent sensor name, if applicable, without building a
+     * String.
+     *
+     * @param stream The stream to print to.
+     * @return The number of characters printed.
+     */
+    size_t printParentSensorName(Stream* stream);
 
     /**
      * @brief Set the calculation function for a calculated variable
@@ -158,6 +176,46 @@ class Variable {
      * @param calcFxn Any function returning a float value.
      */
     void setCalculation(float (*calcFxn)());
+    /**
+     * @brief Declare the variables a calculated variable's value is computed
+     * from.
+     *
+     * Once a calculated variable has inputs, a VariableArray evaluates it
+     * after any calculated inputs in the same array, whatever their order in
+     * the array.  The calculation function is only run again when the value
+     * of at least one input has changed, and isn't run at all when any input
+     * is #MS_INVALID_VALUE - the value is set to #MS_INVALID_VALUE instead.
+     *
+     * @code{.cpp}
+     * Variable* rhoInputs[] = {ds18Temp, bme280Press};
+     * Variable* rho = new Variable(calculateWaterDensity, 4, "density",
+     *                              "kilogramPerCubicMeter", "Rho");
+     * rho->setInputs(rhoInputs, 2);
+     * @endcode
+     *
+     * @note The calculation function must only depend on the declared inputs;
+     * a function that also reads a clock or another variable will not be
+     * re-run when only that changes.
+     *
+     * @param inputList An array of pointers to the input variables.  The
+     * array is not copied and must outlive this variable.
+     * @param inputCount The number of variables in the array.
+     */
+    void setInputs(Variable* inputList[], uint8_t inputCount);
+    /**
+     * @brief Get the number of declared input variables.
+     *
+     * @return The input count
+     */
+    uint8_t getInputCount();
+    /**
+     * @brief Get a declared input variable.
+     *
+     * @param inputNumber The position of the input in the list of inputs.
+     * @return A pointer to the input, or a null pointer if there's no such
+     * input.
+     */
+    Variable* getInput(uint8_t inputNumber);
 
     // This gets/sets the variable's resolution for value strings
     /**
@@ -178,6 +236,12 @@ class Variable {
      * @return The variable name
      */
     String getVarName();
+    /**
+     * @brief Get the variable name as a C-style string
+     *
+     * @return The variable name, or an empty string if it isn't set
+     */
+    const char* getVarNameChars();
     /**
      * @brief Set the variable name.
      *
@@ -194,6 +258,12 @@ class Variable {
      * @return The variable unit
      */
     String getVarUnit();
+    /**
+     * @brief Get the variable unit as a C-style string
+     *
+     * @return The variable unit, or an empty string if it isn't set
+     */
+    const char* getVarUnitChars();
     /**
      * @brief Set the variable unit.
      *
@@ -210,6 +280,12 @@ class Variable {
      * @return The customized code for the variable
      */
     String getVarCode();
+    /**
+     * @brief Get the customized code for the variable as a C-style string
+     *
+     * @return The variable code, or an empty string if it isn't set
+     */
+    const char* getVarCodeChars();
     /**
      * @brief Set a customized code for the variable
      *
@@ -274,6 +350,51 @@ class Variable {
      * @return The formatted value of the variable
      */
     String formatValueString(float value);
+    /**
+     * @brief Get current value of the variable as a C-style string with the
+     * correct decimal resolution, without building a String.
+     *
+     * @param buffer A buffer of at least #VALUE_BUFFER_SIZE characters.
+     * @param updateValue True to ask the parent sensor to take a measurement
+     * and return a new value or to re-run the calculation function for a
+     * calculated value.  Default is false.
+     * @return The number of characters written, not counting the null.
+     */
+    uint8_t getValueChars(char buffer[], bool updateValue = false);
+    /**
+     * @brief Format a particular value of the variable into a buffer with the
+     * correct decimal resolution.
+     *
+     * This uses integer arithmetic instead of the floating point formatting
+     * behind String(float, decimals) and writes the same text: values are
+     * rounded half away from zero, and a resolution of 0 truncates toward
+     * zero.  At most #MAX_VALUE_DECIMALS decimal places are written.  Like
+     * Print::print(float), values too large for 32 bits are written as "ovf",
+     * and NaN and infinity as "nan" and "inf".
+     *
+     * @param value value to format
+     * @param buffer A buffer of at least #VALUE_BUFFER_SIZE characters.
+     * @return The number of characters written, not counting the null.
+     */
+    uint8_t formatValueChars(float value, char buffer[]);
+    /**
+     * @brief Split a value into its whole part and its fraction rounded to a
+     * number of decimal places, exactly as formatValueChars() writes them.
+     *
+     * The fraction is rounded half away from zero, carrying into the whole
+     * part, and with no decimal places the value is truncated.  The sign of
+     * the value is ignored.  Anything that stores a rounded value, like the
+     * LogBuffer, uses this so that it keeps the value that will be printed.
+     *
+     * @param value The value to split; its magnitude must be no more than
+     * 4294967040.
+     * @param decimals The number of decimal places, no more than
+     * #MAX_VALUE_DECIMALS.
+     * @param whole The whole part of the rounded magnitude.
+     * @param fraction The rounded fraction, in units of 10^-decimals.
+     */
+    static void splitValue(float value, uint8_t decimals, uint32_t& whole,
+                           uint32_t& fraction);
 
     /**
      * @brief Pointer to the parent sensor
@@ -323,6 +444,34 @@ class Variable {
      */
     float _currentValue = MS_INVALID_VALUE;
 
+    /**
+     * @brief Construct a new Variable object for a calculated variable whose
+     * value is calculated by a derived class overriding calculateValue().
+     *
+     * @param decimalResolution The resolution (in decimal places) of the value.
+     * @param varName The name of the variable per the [ODM2 variable name
+     * controlled vocabulary](http://vocabulary.odm2.org/variablename/)
+     * @param varUnit The unit of the variable per the [ODM2 unit controlled
+     * vocabulary](http://vocabulary.odm2.org/units/)
+     * @param varCode A custom code for the variable.  This can be any short
+     * text helping to identify the variable in files.
+     * @param uuid A universally unique identifier for the variable.
+     */
+    Variable(uint8_t decimalResolution, const char* varName,
+             const char* varUnit, const char* varCode, const char* uuid);
+
+    /**
+     * @brief Calculate the value of a calculated variable.
+     *
+     * This runs the calculation function.  A derived class can override it to
+     * calculate the value from something a plain function can't reach, like
+     * the state of a particular sensor.
+     *
+     * @return The calculated value, or #MS_INVALID_VALUE if there is no
+     * calculation function.
+     */
+    virtual float calculateValue();
+
 
  private:
     /**
@@ -330,7 +479,45 @@ class Variable {
      * value.
      */
     float (*_calcFxn)() = nullptr;
+    /**
+     * @brief The variables a calculated variable's value depends on, or a
+     * null pointer if none were declared.
+     */
+    Variable** _inputs = nullptr;
+    /**
+     * @brief The number of variables in #_inputs.
+     */
+    uint8_t _inputCount = 0;
+    /**
+     * @brief The number of times the value has changed, modulo 256.
+     *
+     * Calculated variables compare the sum of their inputs' change counts to
+     * tell whether any input has changed since they were last calculated.
+     */
+    uint8_t _valueChanges = 0;
+    /**
+     * @brief The sum of the inputs' #_valueChanges when the value was last
+     * calculated.
+     */
+    uint8_t _inputChangeStamp = 0;
+    /**
+     * @brief Whether the value has been calculated from the current inputs at
+     * least once.
+     */
+    bool _calculatedFromInputs = false;
 
+    /**
+     * @brief Set the current value, counting it as a change if it differs
+     * from the previous value.
+     *
+     * @param value The new value
+     */
+    void setCurrentValue(float value);
+    /**
+     * @brief Run the calculation function, skipping it if the declared inputs
+     * are unchanged or invalid.
+     */
+    void runCalculation();
 
     /**
      * @brief The position in the sensor's value array of this variable's value.
@@ -362,4 +549,213 @@ class Variable {
     const char* _uuid = nullptr;
 };
 
+
+/**
+ * @anchor sensor_breaker_state
+ * @name Failing Sensor Breaker State
+ * The state of a sensor's failing sensor breaker.
+ */
+/**@{*/
+/// @brief Decimals places in string representation; the state is a whole
+/// number of cycles.
+#define SENSOR_BREAKER_STATE_RESOLUTION 0
+/// @brief Variable name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/variablename/);
+/// "instrumentStatusCode"
+#define SENSOR_BREAKER_STATE_VAR_NAME "instrumentStatusCode"
+/// @brief Variable unit name in
+/// [ODM2 controlled vocabulary](http://vocabulary.odm2.org/units/);
+/// "dimensionless"
+#define SENSOR_BREAKER_STATE_UNIT_NAME "dimensionless"
+/// @brief Default variable short code; "breakerState"
+#define SENSOR_BREAKER_STATE_DEFAULT_CODE "breakerState"
+/**@}*/
+
+/**
+ * @brief The Variable sub-class used for the state of a sensor's failing
+ * sensor breaker.
+ *
+ * The value is the number of logged cycles the sensor is skipped for after
+ * each failed probe, or 0 while the sensor is working normally; see
+ * Sensor::setBreakerThreshold().  It is a calculated variable, so it is
+ * updated after every sensor in the variable array, and it reports the state
+ * left by the update that was just logged.
+ *
+ * @ingroup base_classes
+ */
+class SensorBreakerState : public Variable {
+ public:
+    /**
+     * @brief Construct a new SensorBreakerState object.
+     *
+     * @param sensor The sensor whose breaker state is reported.
+     * @param uuid A universally unique identifier (UUID or GUID) for the
+     * variable; optional with the default value of an empty string.
+     * @param varCode A short code to help identify the variable in files;
+     * optional with a default value of "breakerState".
+     */
+    explicit SensorBreakerState(
+        Sensor* sensor, const char* uuid = "",
+        const char* varCode = SENSOR_BREAKER_STATE_DEFAULT_CODE);
+    /**
+     * @brief Destroy the SensorBreakerState object - no action needed.
+     */
+    ~SensorBreakerState() override = default;
+
+ protected:
+    /**
+     * @copydoc Variable::calculateValue()
+     */
+    float calculateValue() override;
+
+ private:
+    /**
+     * @brief The sensor whose breaker state is reported.
+     */
+    Sensor* _sensor;
+};
+
+
+/**
+ * @brief The base class for the variables reporting a statistic of the valid
+ * values measured for one of a sensor's results.
+ *
+ * Creating one of these enables the sensor's statistics; see
+ * Sensor::enableStatistics().  The statistic is calculated after every sensor
+ * in the variable array has updated, so it describes the values averaged into
+ * the result that was just logged.
+ *
+ * @ingroup base_classes
+ */
+class ResultStatistic : public Variable {
+ public:
+    /**
+     * @brief Destroy the ResultStatistic object - no action needed.
+     */
+    ~ResultStatistic() override = default;
+
+ protected:
+    /**
+     * @brief Construct a new ResultStatistic object.
+     *
+     * @param parentSense The sensor whose result is described.
+     * @param sensorVarNum The position of the result within the sensor's
+     * result array.
+     * @param decimalResolution The resolution (in decimal places) of the value.
+     * @param varName The name of the variable per the [ODM2 variable name
+     * controlled vocabulary](http://vocabulary.odm2.org/variablename/)
+     * @param varUnit The unit of the variable per the [ODM2 unit controlled
+     * vocabulary](http://vocabulary.odm2.org/units/)
+     * @param varCode A custom code for the variable.  This can be any short
+     * text helping to identify the variable in files.
+     * @param uuid A universally unique identifier for the variable.
+     */
+    ResultStatistic(Sensor* parentSense, uint8_t sensorVarNum,
+                    uint8_t decimalResolution, const char* varName,
+                    const char* varUnit, const char* varCode,
+                    const char* uuid);
+
+    /**
+     * @brief The sensor whose result is described.
+     */
+    Sensor* _sensor;
+    /**
+     * @brief The position of the result within the sensor's result array.
+     */
+    uint8_t _resultNumber;
+};
+
+/**
+ * @brief The Variable sub-class used for the sample standard deviation of the
+ * valid values measured for a sensor's result.
+ *
+ * @code{.cpp}
+ * Variable* obs3TurbSD = new ResultStandardDeviation(
+ *     &obs3, OBS3_TURB_VAR_NUM, 3, "turbidity", "nephelometricTurbidityUnit",
+ *     "TurbSD");
+ * @endcode
+ *
+ * The value is #MS_INVALID_VALUE if there were fewer than two valid values.
+ *
+ * @ingroup base_classes
+ */
+class ResultStandardDeviation : public ResultStatistic {
+ public:
+    /**
+     * @copydoc ResultStatistic::ResultStatistic
+     */
+    ResultStandardDeviation(Sensor* parentSense, uint8_t sensorVarNum,
+                            uint8_t decimalResolution, const char* varName,
+                            const char* varUnit, const char* varCode,
+                            const char* uuid = "");
+    /**
+     * @brief Destroy the ResultStandardDeviation object - no action needed.
+     */
+    ~ResultStandardDeviation() override = default;
+
+ protected:
+    /**
+     * @copydoc Variable::calculateValue()
+     */
+    float calculateValue() override;
+};
+
+/**
+ * @brief The Variable sub-class used for the smallest valid value measured for
+ * a sensor's result.
+ *
+ * The value is #MS_INVALID_VALUE if there were no valid values.
+ *
+ * @ingroup base_classes
+ */
+class ResultMinimum : public ResultStatistic {
+ public:
+    /**
+     * @copydoc ResultStatistic::ResultStatistic
+     */
+    ResultMinimum(Sensor* parentSense, uint8_t sensorVarNum,
+                  uint8_t decimalResolution, const char* varName,
+                  const char* varUnit, const char* varCode,
+                  const char* uuid = "");
+    /**
+     * @brief Destroy the ResultMinimum object - no action needed.
+     */
+    ~ResultMinimum() override = default;
+
+ protected:
+    /**
+     * @copydoc Variable::calculateValue()
+     */
+    float calculateValue() override;
+};
+
+/**
+ * @brief The Variable sub-class used for the largest valid value measured for
+ * a sensor's result.
+ *
+ * The value is #MS_INVALID_VALUE if there were no valid values.
+ *
+ * @ingroup base_classes
+ */
+class ResultMaximum : public ResultStatistic {
+ public:
+    /**
+     * @copydoc ResultStatistic::ResultStatistic
+     */
+    ResultMaximum(Sensor* parentSense, uint8_t sensorVarNum,
+                  uint8_t decimalResolution, const char* varName,
+                  const char* varUnit, const char* varCode,
+                  const char* uuid = "");
+    /**
+     * @brief Destroy the ResultMaximum object - no action needed.
+     */
+    ~ResultMaximum() override = default;
+
+ protected:
+    /**
+     * @copydoc Variable::calculateValue()
+     */
+    float calculateValue() override;
+};
+
 #endif  // SRC_VARIABLEBASE_H_
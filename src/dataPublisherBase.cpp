@@ -14,6 +14,12 @@
 char    dataPublisher::txBuffer[MS_SEND_BUFFER_SIZE];
 Client* dataPublisher::txBufferOutClient = nullptr;
 size_t  dataPublisher::txBufferLen;
+bool    dataPublisher::txBufferChunked = false;
+
+// Room at the start of the TX buffer for the size line of a chunk (three hex
+// digits and CRLF) and at the end for the CRLF after the data
+#define TX_CHUNK_HEADER_SIZE 5
+#define TX_CHUNK_TRAILER_SIZE 2
 
 // Basic chunks of HTTP
 const char* dataPublisher::getHeader  = "GET ";
@@ -106,7 +112,8 @@ void dataPublisher::txBufferInit(Client* outClient) {
     // remember client we are sending to
     txBufferOutClient = outClient;
     // reset buffer length to be empty
-    txBufferLen = 0;
+    txBufferLen     = 0;
+    txBufferChunked = false;
     // clear the buffer
     memset(txBuffer, '\0', MS_SEND_BUFFER_SIZE);
 
@@ -117,9 +124,12 @@ void dataPublisher::txBufferInit(Client* outClient) {
 
 void dataPublisher::txBufferAppend(const char* data, size_t length,
                                    bool debug_flush) {
+    // leave room to finish the chunk when using chunked transfer encoding
+    size_t capacity = MS_SEND_BUFFER_SIZE -
+        (txBufferChunked ? TX_CHUNK_TRAILER_SIZE : 0);
     while (length > 0) {
         // space left in the buffer
-        size_t remaining = MS_SEND_BUFFER_SIZE - txBufferLen;
+        size_t remaining = capacity - txBufferLen;
         // the number of characters that will be added to the buffer
         // this will be the lesser of the length desired and the space left in
         // the buffer
@@ -139,7 +149,7 @@ void dataPublisher::txBufferAppend(const char* data, size_t length,
                     F("remaining to append:"), length);
 
         // write out the buffer if it fills
-        if (txBufferLen == MS_SEND_BUFFER_SIZE) { txBufferFlush(debug_flush); }
+        if (txBufferLen == capacity) { txBufferFlush(debug_flush); }
     }
 }
 
@@ -151,26 +161,60 @@ void dataPublisher::txBufferAppend(char c, bool debug_flush) {
     txBufferAppend(&c, 1, debug_flush);
 }
 
+void dataPublisher::txBufferStartChunks(bool debug_flush) {
+    // anything before the body goes out as it is
+    txBufferFlush(debug_flush);
+    txBufferChunked = true;
+    txBufferLen     = TX_CHUNK_HEADER_SIZE;
+}
+
+void dataPublisher::txBufferEndChunks(bool debug_flush) {
+    if (!txBufferChunked) { return; }
+    txBufferFlush(debug_flush);
+    txBufferChunked = false;
+    txBufferLen     = 0;
+    // a chunk with no data ends the body
+    txBufferAppend("0\r\n\r\n", false);
+    txBufferFlush(false);
+}
+
 void dataPublisher::txBufferFlush(bool debug_flush) {
     MS_DBG(F("Flushing Tx buffer:"));
+    // with chunked transfer encoding, the data starts after the size line
+    size_t start = txBufferChunked ? TX_CHUNK_HEADER_SIZE : 0;
 
 #if !defined(MS_SILENT)
     if (debug_flush) {
         // write out to the printout stream for debugging
-        MS_SERIAL_OUTPUT.write((const uint8_t*)txBuffer, txBufferLen);
+        MS_SERIAL_OUTPUT.write((const uint8_t*)txBuffer + start,
+                               txBufferLen - start);
         MS_SERIAL_OUTPUT.println();
         MS_SERIAL_OUTPUT.flush();
     }
 #endif
 
     // If there's nothing to send or nowhere to send it to, just return
-    if ((txBufferOutClient == nullptr) || (txBufferLen == 0)) {
+    if ((txBufferOutClient == nullptr) || (txBufferLen == start)) {
         MS_DBG(F("No client, obliterating buffer content!"));
         // forget that data existed...
-        txBufferLen = 0;
+        txBufferLen = start;
         return;
     }
 
+    if (txBufferChunked) {
+        // frame the data as one chunk: its size as three hex digits (leading
+        // zeros are allowed) and CRLF before it, and CRLF after it
+        const char* hexDigits = "0123456789ABCDEF";
+        size_t      size      = txBufferLen - start;
+        txBuffer[0]           = hexDigits[(size >> 8) & 0xF];
+        txBuffer[1]           = hexDigits[(size >> 4) & 0xF];
+        txBuffer[2]           = hexDigits[size & 0xF];
+        txBuffer[3]           = '\r';
+        txBuffer[4]           = '\n';
+        txBuffer[txBufferLen++] = '\r';
+        txBuffer[txBufferLen++] = '\n';
+    }
+
     // write out to the client, attempting 10x to send the whole buffer
     uint8_t        tries = 10;
     const uint8_t* ptr   = (const uint8_t*)txBuffer;
@@ -187,6 +231,7 @@ void dataPublisher::txBufferFlush(bool debug_flush) {
         ptr += sent;
         if (txBufferLen == 0) {
             // whole message is successfully sent, we are done
+            txBufferLen = start;
             return;
         }
 
@@ -196,7 +241,7 @@ void dataPublisher::txBufferFlush(bool debug_flush) {
             // the connection now so it will get reset and we can try to
             // transmit the data again later
             txBufferOutClient = nullptr;
-            txBufferLen       = 0;
+            txBufferLen       = start;
             return;
         }
     }
@@ -360,6 +360,11 @@ class dataPublisher {
      * @brief The number of used characters in the TX buffer.
      */
     static size_t txBufferLen;
+    /**
+     * @brief True while the TX buffer is framing its contents as the chunks
+     * of an HTTP body sent with chunked transfer encoding.
+     */
+    static bool txBufferChunked;
     /**
      * @brief Initialize the TX buffer to be empty and start writing to the
      * given client.
@@ -396,6 +401,25 @@ class dataPublisher {
      * @param debug_flush If true, flush the TX buffer to the debugging port.
      */
     static void txBufferFlush(bool debug_flush = true);
+    /**
+     * @brief Flush the TX buffer, then send everything appended after this as
+     * the chunks of an HTTP body with chunked transfer encoding.
+     *
+     * Each time the TX buffer is flushed its contents are sent as one chunk,
+     * so the body can be sent as it's generated without knowing its length
+     * ahead of time. The request headers must include "Transfer-Encoding:
+     * chunked" and no Content-Length.
+     *
+     * @param debug_flush If true, flush the TX buffer to the debugging port.
+     */
+    static void txBufferStartChunks(bool debug_flush = true);
+    /**
+     * @brief Flush the last chunk of a body started with
+     * txBufferStartChunks() and send the empty chunk that ends the body.
+     *
+     * @param debug_flush If true, flush the TX buffer to the debugging port.
+     */
+    static void txBufferEndChunks(bool debug_flush = true);
 
     /**
      * @brief Use the connected base logger's logger modem and underlying
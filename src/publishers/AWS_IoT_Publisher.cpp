@@ -282,20 +282,23 @@ int16_t AWS_IoT_Publisher::publishData(Client* outClient, bool) {
 
     // add the timestamp tag
     txBufferAppend(timestampTag);
-    txBufferAppend(
-        Logger::formatDateTime_ISO8601(Logger::markedLocalUnixTime).c_str());
+    char timeBuffer[loggerClock::ISO8601_BUFFER_SIZE];
+    Logger::formatDateTime_ISO8601(timeBuffer, Logger::markedLocalUnixTime);
+    txBufferAppend(timeBuffer);
     txBufferAppend('"');
     txBufferAppend(',');
 
     // add values for each variable
     char num_buf[6];
+    char valueBuffer[Variable::VALUE_BUFFER_SIZE];
     for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
         itoa(i, num_buf, 10);
         txBufferAppend('"');
         txBufferAppend(num_buf);
         txBufferAppend('"');
         txBufferAppend(':');
-        txBufferAppend(_baseLogger->getValueStringAtI(i).c_str());
+        _baseLogger->getValueCharsAtI(i, valueBuffer);
+        txBufferAppend(valueBuffer);
         if (i + 1 != _baseLogger->getArrayVarCount()) {
             txBufferAppend(',');
         } else {
@@ -480,14 +483,14 @@ int16_t AWS_IoT_Publisher::publishMetadata(Client* outClient) {
             itoa(i, num_buf, 10);
             txBufferAppend(num_buf);
             txBufferAppend(",\"variable_name\":\"");
-            txBufferAppend(_baseLogger->getVarNameAtI(i).c_str());
+            txBufferAppend(_baseLogger->getVarNameCharsAtI(i));
             txBufferAppend("\",\"variable_unit\":\"");
-            txBufferAppend(_baseLogger->getVarUnitAtI(i).c_str());
+            txBufferAppend(_baseLogger->getVarUnitCharsAtI(i));
             txBufferAppend("\",\"variable_resolution\":\"");
             itoa(_baseLogger->getVarResolutionAtI(i), num_buf, 10);
             txBufferAppend(num_buf);
             txBufferAppend("\",\"variable_code\":\"");
-            txBufferAppend(_baseLogger->getVarCodeAtI(i).c_str());
+            txBufferAppend(_baseLogger->getVarCodeCharsAtI(i));
             txBufferAppend("\",\"variable_uuid\":\"");
             txBufferAppend(_baseLogger->getVarUUIDAtI(i));
             txBufferAppend("}");
@@ -95,11 +95,13 @@ int16_t DreamHostPublisher::publishData(Client* outClient, bool) {
              10);  // BASE 10
         txBufferAppend(tempBuffer);
 
+        char valueBuffer[Variable::VALUE_BUFFER_SIZE];
         for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
             txBufferAppend('&');
-            txBufferAppend(_baseLogger->getVarCodeAtI(i).c_str());
+            txBufferAppend(_baseLogger->getVarCodeCharsAtI(i));
             txBufferAppend('=');
-            txBufferAppend(_baseLogger->getValueStringAtI(i).c_str());
+            _baseLogger->getValueCharsAtI(i, valueBuffer);
+            txBufferAppend(valueBuffer);
         }
 
         // add the rest of the HTTP GET headers to the outgoing buffer
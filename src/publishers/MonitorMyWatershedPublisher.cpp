@@ -22,6 +22,8 @@
 const char* MonitorMyWatershedPublisher::tokenHeader = "\r\nTOKEN: ";
 const char* MonitorMyWatershedPublisher::contentLengthHeader =
     "\r\nContent-Length: ";
+const char* MonitorMyWatershedPublisher::transferEncodingHeader =
+    "\r\nTransfer-Encoding: chunked";
 const char* MonitorMyWatershedPublisher::contentTypeHeader =
     "\r\nContent-Type: application/json\r\n\r\n";
 
@@ -29,6 +31,10 @@ const char* MonitorMyWatershedPublisher::samplingFeatureTag =
     "{\"sampling_feature\":\"";
 const char* MonitorMyWatershedPublisher::timestampTag = "\",\"timestamp\":";
 
+// The spool file starts with the position of the first unsent record, then the
+// number of variables in each record
+#define MMW_SPOOL_HEADER_SIZE 5
+
 
 // Constructors
 // Primary constructor with all parameters
@@ -37,7 +43,7 @@ MonitorMyWatershedPublisher::MonitorMyWatershedPublisher(
     const char* samplingFeatureUUID, int sendEveryX,
     uint8_t startupTransmissions)
     : dataPublisher(baseLogger, inClient, sendEveryX, startupTransmissions) {
-    _logBuffer.setNumVariables(_baseLogger->getArrayVarCount());
+    initializeLogBuffer();
     setHost("monitormywatershed.org");
     setPath("/api/data-stream/");
     setPort(80);
@@ -120,10 +126,28 @@ void MonitorMyWatershedPublisher::setToken(const char* registrationToken) {
 }
 
 
+void MonitorMyWatershedPublisher::setSpoolFileName(const char* spoolFileName) {
+    _spoolFileName = spoolFileName;
+}
+
+
+// Sizes the log buffer for the logger's variables and quantizes each one to
+// the resolution it will be formatted with
+void MonitorMyWatershedPublisher::initializeLogBuffer() {
+    uint8_t variables = _baseLogger->getArrayVarCount();
+    _logBuffer.setNumVariables(variables);
+    for (uint8_t i = 0; i < variables; i++) {
+        _logBuffer.setVariableResolution(i, _baseLogger->getVarResolutionAtI(i));
+    }
+}
+
+
 // Calculates how long the JSON will be
 uint16_t MonitorMyWatershedPublisher::calculateJsonSize() {
+    return calculateJsonSize(_logBuffer.getNumRecords());
+}
+uint16_t MonitorMyWatershedPublisher::calculateJsonSize(int records) {
     uint8_t variables = _logBuffer.getNumVariables();
-    int     records   = _logBuffer.getNumRecords();
     MS_DBG(F("Number of records in log buffer:"), records);
     MS_DBG(F("Number of variables in log buffer:"), variables);
     MS_DBG(F("Number of variables in base logger:"),
@@ -136,7 +160,7 @@ uint16_t MonitorMyWatershedPublisher::calculateJsonSize() {
     }
 
     uint16_t jsonLength = strlen(samplingFeatureTag);
-    jsonLength += 36;  // sampling feature UUID
+    jsonLength += strlen(_baseLogger->getSamplingFeatureUUID());
     jsonLength += strlen(timestampTag);
     // markedISO8601Time + quotes and commas
     jsonLength += records * (25 + 2) + records - 1;
@@ -145,9 +169,10 @@ uint16_t MonitorMyWatershedPublisher::calculateJsonSize() {
     } else {
         jsonLength += 1;  // ,
     }
+    char valueBuffer[Variable::VALUE_BUFFER_SIZE];
     for (uint8_t var = 0; var < variables; var++) {
-        jsonLength += 1;   //  "
-        jsonLength += 36;  // variable UUID
+        jsonLength += 1;  //  "
+        jsonLength += strlen(_baseLogger->getVarUUIDAtI(var));
         if (records > 1) {
             jsonLength += 4;  //  ":[]
         } else {
@@ -157,7 +182,7 @@ uint16_t MonitorMyWatershedPublisher::calculateJsonSize() {
         for (int rec = 0; rec < records; rec++) {
             float value = _logBuffer.getRecordValue(rec, var);
             jsonLength +=
-                _baseLogger->formatValueStringAtI(var, value).length();
+                _baseLogger->formatValueCharsAtI(var, value, valueBuffer);
             if (rec + 1 != records) {
                 jsonLength += 1;  // ,
             }
@@ -182,7 +207,7 @@ void MonitorMyWatershedPublisher::begin(Logger& baseLogger, Client* inClient,
     if (samplingFeatureUUID != nullptr) {
         _baseLogger->setSamplingFeatureUUID(samplingFeatureUUID);
     }
-    _logBuffer.setNumVariables(_baseLogger->getArrayVarCount());
+    initializeLogBuffer();
 }
 void MonitorMyWatershedPublisher::begin(Logger&     baseLogger,
                                         const char* registrationToken,
@@ -258,7 +283,7 @@ int16_t MonitorMyWatershedPublisher::publishData(Client* outClient,
               "variables in logger."));
         PRINTOUT(F("THIS WILL ERASE THE BUFFER AND DELETE"),
                  _logBuffer.getNumRecords(), F("UNSENT RECORDS!"));
-        _logBuffer.setNumVariables(_baseLogger->getArrayVarCount());
+        initializeLogBuffer();
     }
 
     // Do we intend to flush this call? If so, we have just returned true from
@@ -270,6 +295,9 @@ int16_t MonitorMyWatershedPublisher::publishData(Client* outClient,
            willFlush ? F("and then \"flushing\" (publishing)")
                      : F("without publishing"));
 
+    // move the buffer to the SD card rather than dropping the oldest record
+    if (_spoolFileName != nullptr && _logBuffer.isFull()) { spillToSpool(); }
+
     // create record to hold timestamp and variable values in the log buffer
     int record = _logBuffer.addRecord(
         static_cast<uint32_t>(Logger::markedLocalUnixTime));
@@ -297,11 +325,6 @@ int16_t MonitorMyWatershedPublisher::publishData(Client* outClient,
 }
 
 int16_t MonitorMyWatershedPublisher::flushDataBuffer(Client* outClient) {
-    // Create a buffer for the portions of the request and response
-    char    tempBuffer[37] = "";
-    int16_t did_respond    = 0;
-    int16_t responseCode   = 0;
-
     // Early return if no records to send
     if (_logBuffer.getNumRecords() == 0) {
         MS_DBG(F("No records to send, returning without action"));
@@ -326,6 +349,168 @@ int16_t MonitorMyWatershedPublisher::flushDataBuffer(Client* outClient) {
         return -4;
     }
 
+    // Send the backlog oldest first in bounded chunks, removing each chunk
+    // from the buffer as soon as the server acknowledges it so a failure only
+    // leaves the unacknowledged records to be retried
+    int16_t responseCode;
+    do {
+        int records = min(_logBuffer.getNumRecords(), MS_MAX_RECORDS_PER_POST);
+        MS_DBG(F("Posting"), records, F("of"), _logBuffer.getNumRecords(),
+               F("buffered records"));
+        responseCode = postRecords(outClient, records);
+        if (responseCode != 201) { break; }
+        // data was successfully transmitted, we can discard it from the buffer
+        _logBuffer.removeRecords(records);
+    } while (_logBuffer.getNumRecords() > 0);
+
+    // with the buffer empty, catch up on anything spooled to the SD card
+    if (responseCode == 201) { responseCode = drainSpool(outClient); }
+
+    return responseCode;
+}
+
+bool MonitorMyWatershedPublisher::openSpool(File& spool, bool create) {
+    if (_spoolFileName == nullptr || !_baseLogger->initializeSDCard()) {
+        return false;
+    }
+    if (!spool.open(_spoolFileName, create ? (O_RDWR | O_CREAT) : O_RDWR)) {
+        MS_DBG(F("Unable to open spool file"), _spoolFileName);
+        return false;
+    }
+
+    uint8_t variables = _logBuffer.getNumVariables();
+    if (spool.fileSize() >= MMW_SPOOL_HEADER_SIZE) {
+        spool.seekSet(sizeof(uint32_t));
+        if (spool.read() == variables) { return true; }
+        // the records can't be matched up with the current variables
+        PRINTOUT(F("Number of variables in spool file does not match number "
+                   "of variables in logger. DELETING SPOOLED RECORDS!"));
+        spool.remove();
+        if (!create || !spool.open(_spoolFileName, O_RDWR | O_CREAT)) {
+            return false;
+        }
+    } else if (!create) {
+        spool.close();
+        return false;
+    }
+
+    // a new spool starts with nothing sent
+    spool.truncate(0);
+    if (!writeSpoolCursor(spool, MMW_SPOOL_HEADER_SIZE) ||
+        spool.write(variables) != 1) {
+        spool.close();
+        return false;
+    }
+    return true;
+}
+
+bool MonitorMyWatershedPublisher::writeSpoolCursor(File& spool,
+                                                   uint32_t cursor) {
+    spool.seekSet(0);
+    return spool.write(&cursor, sizeof(cursor)) == sizeof(cursor);
+}
+
+bool MonitorMyWatershedPublisher::spillToSpool() {
+    // a record needs at least one value, and so does the values array
+    uint8_t variables = _logBuffer.getNumVariables();
+    if (variables == 0) { return false; }
+    File spool;
+    if (!openSpool(spool, true)) { return false; }
+
+    float    values[variables];
+    uint32_t timestamp;
+    int      spilled = 0;
+    spool.seekEnd();
+    // records are appended as a raw timestamp and floats, oldest first
+    while (_logBuffer.popRecord(timestamp, values)) {
+        uint32_t recordStart = spool.curPosition();
+        if (spool.write(&timestamp, sizeof(timestamp)) != sizeof(timestamp) ||
+            spool.write(values, sizeof(float) * variables) !=
+                sizeof(float) * variables) {
+            // don't leave part of a record to misalign the ones after it
+            spool.truncate(recordStart);
+            PRINTOUT(F("Unable to write to spool file!"));
+            break;
+        }
+        spilled++;
+    }
+    spool.close();
+    MS_DBG(F("Spooled"), spilled, F("records to"), _spoolFileName);
+    return spilled > 0;
+}
+
+int16_t MonitorMyWatershedPublisher::drainSpool(Client* outClient) {
+    int16_t responseCode = 201;
+    uint8_t variables    = _logBuffer.getNumVariables();
+    if (variables == 0) { return responseCode; }
+    File spool;
+    if (!openSpool(spool, false)) { return responseCode; }
+
+    int      valuesSize = sizeof(float) * variables;
+    uint32_t recordSize = sizeof(uint32_t) + valuesSize;
+    float    values[variables];
+    bool     readFailed = false;
+    uint32_t cursor;
+    spool.seekSet(0);
+    if (spool.read(&cursor, sizeof(cursor)) != sizeof(cursor)) {
+        spool.close();
+        return responseCode;
+    }
+
+    // load the oldest spooled records into the empty buffer in batches; each
+    // batch stays in the spool until the server acknowledges it
+    while (responseCode == 201 && !readFailed &&
+           cursor + recordSize <= spool.fileSize()) {
+        spool.seekSet(cursor);
+        int records = 0;
+        while (records < MS_MAX_RECORDS_PER_POST && !_logBuffer.isFull() &&
+               cursor + (records + 1) * recordSize <= spool.fileSize()) {
+            uint32_t timestamp;
+            // post what was read, but leave an unreadable record and
+            // everything after it in the spool
+            if (spool.read(&timestamp, sizeof(timestamp)) !=
+                    sizeof(timestamp) ||
+                spool.read(values, valuesSize) != valuesSize) {
+                PRINTOUT(F("Unable to read from spool file!"));
+                readFailed = true;
+                break;
+            }
+            int record = _logBuffer.addRecord(timestamp);
+            for (uint8_t i = 0; i < variables; i++) {
+                _logBuffer.setRecordValue(record, i, values[i]);
+            }
+            records++;
+        }
+        if (records == 0) { break; }
+
+        MS_DBG(F("Posting"), records, F("records from"), _spoolFileName);
+        responseCode = postRecords(outClient, records);
+        _logBuffer.clear();
+        if (responseCode == 201) {
+            // persist the new position so a restart doesn't resend the batch
+            cursor += records * recordSize;
+            writeSpoolCursor(spool, cursor);
+            spool.sync();
+        }
+    }
+
+    if (!readFailed && cursor + recordSize > spool.fileSize()) {
+        // everything has been sent
+        MS_DBG(F("All spooled records sent, removing"), _spoolFileName);
+        spool.remove();
+    } else {
+        spool.close();
+    }
+    return responseCode;
+}
+
+int16_t MonitorMyWatershedPublisher::postRecords(Client* outClient,
+                                                 int     records) {
+    // Create a buffer for the portions of the request and response
+    char    tempBuffer[37] = "";
+    int16_t did_respond    = 0;
+    int16_t responseCode   = 0;
+
     // Open a TCP/IP connection to Monitor My Watershed
     MS_DBG(F("Connecting client"));
     MS_START_DEBUG_TIMER;
@@ -344,11 +529,19 @@ int16_t MonitorMyWatershedPublisher::flushDataBuffer(Client* outClient) {
         txBufferAppend(tokenHeader);
         txBufferAppend(_registrationToken);
 
+#if MS_MMW_USE_CHUNKED_TRANSFER
+        txBufferAppend(transferEncodingHeader);
+        txBufferAppend(contentTypeHeader);
+        // the JSON is sent as it's formatted, so each value is only formatted
+        // once and the length doesn't need to be calculated first
+        txBufferStartChunks();
+#else
         txBufferAppend(contentLengthHeader);
-        itoa(calculateJsonSize(), tempBuffer, 10);  // BASE 10
+        itoa(calculateJsonSize(records), tempBuffer, 10);  // BASE 10
         txBufferAppend(tempBuffer);
 
         txBufferAppend(contentTypeHeader);
+#endif
 
         // put the start of the JSON into the outgoing response_buffer
         txBufferAppend(samplingFeatureTag);
@@ -357,12 +550,15 @@ int16_t MonitorMyWatershedPublisher::flushDataBuffer(Client* outClient) {
         txBufferAppend(timestampTag);
 
         // write out list of timestamps
-        int records = _logBuffer.getNumRecords();
+        // NOTE: Consecutive timestamps on the same day only have their time
+        // of day reformatted
+        char timeBuffer[loggerClock::ISO8601_BUFFER_SIZE];
         if (records > 1) { txBufferAppend('['); }
         for (int rec = 0; rec < records; rec++) {
             txBufferAppend('"');
             uint32_t timestamp = _logBuffer.getRecordTimestamp(rec);
-            txBufferAppend(Logger::formatDateTime_ISO8601(timestamp).c_str());
+            Logger::formatDateTime_ISO8601(timeBuffer, timestamp);
+            txBufferAppend(timeBuffer);
             txBufferAppend('"');
             if (rec + 1 != records) { txBufferAppend(','); }
         }
@@ -371,6 +567,7 @@ int16_t MonitorMyWatershedPublisher::flushDataBuffer(Client* outClient) {
 
         // write out a list of the values of each variable
         uint8_t variables = _logBuffer.getNumVariables();
+        char    valueBuffer[Variable::VALUE_BUFFER_SIZE];
         for (uint8_t var = 0; var < variables; var++) {
             txBufferAppend('"');
             txBufferAppend(_baseLogger->getVarUUIDAtI(var));
@@ -380,8 +577,8 @@ int16_t MonitorMyWatershedPublisher::flushDataBuffer(Client* outClient) {
 
             for (int rec = 0; rec < records; rec++) {
                 float value = _logBuffer.getRecordValue(rec, var);
-                txBufferAppend(
-                    _baseLogger->formatValueStringAtI(var, value).c_str());
+                _baseLogger->formatValueCharsAtI(var, value, valueBuffer);
+                txBufferAppend(valueBuffer);
                 if (rec + 1 != records) { txBufferAppend(','); }
             }
             if (records > 1) { txBufferAppend(']'); }
@@ -394,7 +591,11 @@ int16_t MonitorMyWatershedPublisher::flushDataBuffer(Client* outClient) {
         }
 
         // Flush the complete request
+#if MS_MMW_USE_CHUNKED_TRANSFER
+        txBufferEndChunks();
+#else
         txBufferFlush();
+#endif
 
         // Wait 30 seconds for a response from the server
         uint32_t start = millis();
@@ -443,10 +644,6 @@ int16_t MonitorMyWatershedPublisher::flushDataBuffer(Client* outClient) {
             "\n -- Unable to Establish Connection to Monitor My Watershed --"));
         responseCode = -5;  // Connection failure
     }
-    if (responseCode == 201) {
-        // data was successfully transmitted, we can discard it from the buffer
-        _logBuffer.clear();
-    }
 
     return responseCode;
 }
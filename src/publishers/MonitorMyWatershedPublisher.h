@@ -247,6 +247,31 @@ class MonitorMyWatershedPublisher : public dataPublisher {
      */
     uint16_t calculateJsonSize();
 
+    /**
+     * @brief Set the name of a file on the SD card to spool records to when
+     * the log buffer is full.
+     *
+     * When the buffer fills, for example during a long network outage, the
+     * buffered records are moved to the end of this file instead of the oldest
+     * being dropped. Once the buffer has been sent, the spooled records are
+     * sent oldest first in batches of at most #MS_MAX_RECORDS_PER_POST. The
+     * position of the first unsent record is saved in the file after each
+     * acknowledged batch, so records are neither resent nor lost after a
+     * restart. The file is deleted once everything in it has been sent.
+     *
+     * @param spoolFileName The spool file name, or nullptr to disable
+     * spooling. The string must remain valid while the publisher is in use.
+     */
+    void setSpoolFileName(const char* spoolFileName);
+    /**
+     * @brief Calculates how long the outgoing JSON will be for the given
+     * number of the oldest buffered records
+     *
+     * @param records The number of records to include
+     * @return The number of characters in the JSON object.
+     */
+    uint16_t calculateJsonSize(int records);
+
 
     /**
      * @copydoc dataPublisher::begin(Logger& baseLogger, Client* inClient)
@@ -309,6 +334,7 @@ class MonitorMyWatershedPublisher : public dataPublisher {
     int                monitorMWPort = 80;       ///< The host port
     static const char* tokenHeader;              ///< The token header text
     static const char* contentLengthHeader;  ///< The content length header text
+    static const char* transferEncodingHeader;  ///< The chunked encoding text
     static const char* contentTypeHeader;    ///< The content type header text
     /**@}*/
 
@@ -330,15 +356,81 @@ class MonitorMyWatershedPublisher : public dataPublisher {
     /**
      * @brief Transmit data from the data buffer to an external site
      *
+     * The buffered records are sent in requests of at most
+     * #MS_MAX_RECORDS_PER_POST records, oldest first. The records of each
+     * request are removed from the buffer when the server responds with a
+     * 201; sending stops at the first request that fails.
+     *
      * @param outClient The client to publish the data over
-     * @return The HTTP response code from the publish attempt
+     * @return The HTTP response code from the last publish attempt
      *
      * @note A 504 will be returned automatically if the server does not
      * respond within 30 seconds.
      */
     int16_t flushDataBuffer(Client* outClient);
 
+    /**
+     * @brief Transmit the oldest records in the data buffer in a single
+     * request.
+     *
+     * This does not remove the records from the buffer.
+     *
+     * @param outClient The client to publish the data over
+     * @param records The number of records to send
+     * @return The HTTP response code from the publish attempt
+     */
+    int16_t postRecords(Client* outClient, int records);
+
+    /**
+     * @brief Set the number of variables in the log buffer to match the logger
+     * and set the resolution each variable is stored with.
+     *
+     * This erases any records in the buffer.
+     */
+    void initializeLogBuffer();
+
+    /**
+     * @brief Open the spool file and check that it matches the current
+     * variables.
+     *
+     * A spool file with a different number of variables is deleted.
+     *
+     * @param spool The file to open
+     * @param create True to create a new spool file if there isn't one
+     * @return True if the spool file is open and positioned after its header.
+     */
+    bool openSpool(File& spool, bool create);
+    /**
+     * @brief Save the position of the first unsent record in the spool file.
+     *
+     * @param spool The open spool file
+     * @param cursor The position of the first unsent record
+     * @return True if the position was written.
+     */
+    bool writeSpoolCursor(File& spool, uint32_t cursor);
+    /**
+     * @brief Move every record in the log buffer to the end of the spool file.
+     *
+     * @return True if any records were spooled.
+     */
+    bool spillToSpool();
+    /**
+     * @brief Send the records in the spool file in batches, oldest first.
+     *
+     * The log buffer must be empty; it's used to hold each batch.
+     *
+     * @param outClient The client to publish the data over
+     * @return The HTTP response code from the last publish attempt, or 201 if
+     * there was nothing to send.
+     */
+    int16_t drainSpool(Client* outClient);
+
  private:
+    /**
+     * @brief The name of the file on the SD card to spool records to, or
+     * nullptr to not spool.
+     */
+    const char* _spoolFileName = nullptr;
     /**
      * @brief Internal reference to the Monitor My Watershed registration token.
      */
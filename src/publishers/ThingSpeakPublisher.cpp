@@ -184,17 +184,19 @@ int16_t ThingSpeakPublisher::publishData(Client* outClient, bool) {
         // The txBuffer is used for the **payload** only
         txBufferInit(outClient);
         txBufferAppend("created_at=");
-        txBufferAppend(
-            Logger::formatDateTime_ISO8601(Logger::markedLocalUnixTime)
-                .c_str());
+        char timeBuffer[loggerClock::ISO8601_BUFFER_SIZE];
+        Logger::formatDateTime_ISO8601(timeBuffer, Logger::markedLocalUnixTime);
+        txBufferAppend(timeBuffer);
 
         char tempBuffer[2] = "";  // for the field number
+        char valueBuffer[Variable::VALUE_BUFFER_SIZE];
         for (uint8_t i = 0; i < numFields; i++) {
             txBufferAppend("&field");
             itoa(i + 1, tempBuffer, 10);  // BASE 10
             txBufferAppend(tempBuffer);
             txBufferAppend('=');
-            txBufferAppend(_baseLogger->getValueStringAtI(i).c_str());
+            _baseLogger->getValueCharsAtI(i, valueBuffer);
+            txBufferAppend(valueBuffer);
         }
         txBufferAppend("\0");  // null terminate!
         MS_DBG(F("Message length:"), txBufferLen);
@@ -259,7 +261,7 @@ int16_t ThingSpeakPublisher::publishMetadata(Client* outClient) {
             itoa(i + 1, tempBuffer, 10);  // BASE 10
             txBufferAppend(tempBuffer);
             txBufferAppend('=');
-            txBufferAppend(_baseLogger->getVarCodeAtI(i).c_str());
+            txBufferAppend(_baseLogger->getVarCodeCharsAtI(i));
         }
 
         // add the rest of the HTTP GET headers to the outgoing buffer
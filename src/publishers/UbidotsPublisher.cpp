@@ -69,12 +69,13 @@ uint16_t UbidotsPublisher::calculateJsonSize() {
     // jsonLength += 15;          // ","timestamp":"
     // jsonLength += 25;          // markedISO8601Time
     // jsonLength += 2;           //  ",
+    char valueBuffer[Variable::VALUE_BUFFER_SIZE];
     for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
         jsonLength += 1;  //  "
         jsonLength +=
             strlen(_baseLogger->getVarUUIDAtI(i));  // parameter ID length
         jsonLength += 11;                           //  ":{"value":
-        jsonLength += _baseLogger->getValueStringAtI(i).length();
+        jsonLength += _baseLogger->getValueCharsAtI(i, valueBuffer);
         jsonLength += 13;  // ,"timestamp":
         jsonLength += 13;  // epoch time in milliseconds
         if (i + 1 != _baseLogger->getArrayVarCount()) {
@@ -163,11 +164,13 @@ int16_t UbidotsPublisher::publishData(Client* outClient, bool) {
         // put the start of the JSON into the outgoing response_buffer
         txBufferAppend(payload);
 
+        char valueBuffer[Variable::VALUE_BUFFER_SIZE];
         for (uint8_t i = 0; i < _baseLogger->getArrayVarCount(); i++) {
             txBufferAppend('"');
             txBufferAppend(_baseLogger->getVarUUIDAtI(i));
             txBufferAppend("\":{\"value\":");
-            txBufferAppend(_baseLogger->getValueStringAtI(i).c_str());
+            _baseLogger->getValueCharsAtI(i, valueBuffer);
+            txBufferAppend(valueBuffer);
             txBufferAppend(",\"timestamp\":");
             ltoa(Logger::markedUTCUnixTime, tempBuffer, 10);  // BASE 10
             txBufferAppend(tempBuffer);
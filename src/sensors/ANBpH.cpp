@@ -562,6 +562,13 @@ bool ANBpH::isMeasurementComplete() {
 }
 
 
+uint32_t ANBpH::getMillisToNextEvent() {
+    // The measurement completion is polled from the sensor, not timed
+    if (getStatusBit(MEASUREMENT_ATTEMPTED)) { return 0; }
+    return Sensor::getMillisToNextEvent();
+}
+
+
 bool ANBpH::setSalinityMode(ANBSalinityMode newSalinityMode) {
     MS_DBG(F("Set sensor salinity mode..."));
     bool salinitySet = _anb_sensor.setSalinityMode(newSalinityMode);
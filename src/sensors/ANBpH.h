@@ -610,6 +610,15 @@ class ANBpH : public Sensor {
      */
     bool isMeasurementComplete() override;
 
+    /**
+     * @copydoc Sensor::getMillisToNextEvent()
+     *
+     * The ANB pH sensor is queried for a completed measurement from the moment
+     * the measurement is started, so the measurement time is not a lower bound
+     * and this returns 0 while a measurement is in progress.
+     */
+    uint32_t getMillisToNextEvent() override;
+
     /**
      * @brief Set the sensor salinity mode
      *
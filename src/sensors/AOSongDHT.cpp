@@ -31,11 +31,17 @@ bool AOSongDHT::setup() {
 
 
 String AOSongDHT::getSensorName() {
+    return getTypeName();
+}
+size_t AOSongDHT::printSensorName(Stream* stream) {
+    return stream->print(getTypeName());
+}
+const __FlashStringHelper* AOSongDHT::getTypeName() {
     switch (_dhtType) {
-        case 11: return "AOSongDHT11";
-        case 12: return "AOSongDHT12";
-        case 21: return "AOSongDHT21";  // DHT 21 or AM2301
-        default: return "AOSongDHT22";
+        case 11: return F("AOSongDHT11");
+        case 12: return F("AOSongDHT12");
+        case 21: return F("AOSongDHT21");  // DHT 21 or AM2301
+        default: return F("AOSongDHT22");
     }
 }
 
@@ -282,10 +282,17 @@ class AOSongDHT : public Sensor {
     bool setup() override;
 
     String getSensorName() override;
+    size_t printSensorName(Stream* stream) override;
 
     bool addSingleMeasurementResult() override;
 
  private:
+    /**
+     * @brief Get the name of the sensor for its DHT type.
+     *
+     * @return The sensor name, stored in flash.
+     */
+    const __FlashStringHelper* getTypeName();
     DHT     dht_internal;  ///< Internal reference to the Adafruit DHT object
     uint8_t _dhtType;      ///< Internal reference to the DHT type
 };
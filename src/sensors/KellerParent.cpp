@@ -60,12 +60,14 @@ bool KellerParent::setup() {
 
 #ifdef MS_KELLERPARENT_DEBUG_DEEP
     _ksensor.setDebugStream(&MS_SERIAL_OUTPUT);
+    _modbus.setDebugStream(&MS_SERIAL_OUTPUT);
 #endif
 
     // This sensor begin is just setting more pin modes, etc, no sensor power
     // required This really can't fail so adding the return value is just for
     // show
     retVal &= _ksensor.begin(_model, _modbusAddress, _stream, _RS485EnablePin);
+    retVal &= _modbus.begin(_modbusAddress, _stream, _RS485EnablePin);
 
     return retVal;
 }
@@ -93,12 +95,19 @@ bool KellerParent::addSingleMeasurementResult() {
 
     MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
 
-    // NOTE: As of KellerModbus library version 0.2.7, the getValues function
-    // will *always* return true.  We set the success with it here for
-    // future-readiness.
-    success = _ksensor.getValues(waterPressureBar, waterTemperatureC);
-    // Since we can't depend on the return value, we check for success by
-    // checking that the value variables are not MS_INVALID_VALUE or NaN.
+    // NOTE: The KellerModbus library getValues function reads the pressure
+    // and the temperature in separate transactions and will *always* return
+    // true.  Instead, read the whole range of holding registers from P1 to
+    // TOB1 in one transaction and decode both values from the response.
+    ModbusRegisterRange values(_modbus, KELLER_P1_REGISTER,
+                               KELLER_TOB1_REGISTER + 1);
+    success = values.read();
+    if (success) {
+        waterPressureBar  = values.getFloat(KELLER_P1_REGISTER);
+        waterTemperatureC = values.getFloat(KELLER_TOB1_REGISTER);
+    }
+    // Also check for success by checking that the value variables are not
+    // MS_INVALID_VALUE or NaN.
     success &=
         (!isnan(waterPressureBar) && waterPressureBar != MS_INVALID_VALUE &&
          !isnan(waterTemperatureC) && waterTemperatureC != MS_INVALID_VALUE);
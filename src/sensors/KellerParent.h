@@ -103,6 +103,7 @@
 #include "VariableBase.h"
 #include "SensorBase.h"
 #include <KellerModbus.h>
+#include "sensors/ModbusRegisterRange.h"
 
 /** @ingroup keller_group */
 /**@{*/
@@ -120,6 +121,22 @@
 #define KELLER_INC_CALC_VARIABLES 0
 /**@}*/
 
+/**
+ * @anchor keller_registers
+ * @name Modbus Registers
+ * The holding registers of the process values read from the Keller sensors.
+ * Each value is a big-endian float filling two registers, so the pressure and
+ * temperature can be read together as one contiguous range.
+ */
+/**@{*/
+/// @brief The holding register of P1, the pressure in bar; the first register
+/// read.
+#define KELLER_P1_REGISTER 0x0002
+/// @brief The holding register of TOB1, the temperature in °C; the last value
+/// read.
+#define KELLER_TOB1_REGISTER 0x0008
+/**@}*/
+
 /**
  * @anchor keller_pressure
  * @name Pressure
@@ -263,6 +280,11 @@ class KellerParent : public Sensor {
      * Keller sensor.
      */
     keller _ksensor;
+    /**
+     * @brief Private reference to a modbus master used to read all of the
+     * process values from the Keller sensor in a single transaction.
+     */
+    modbusMaster _modbus;
     /**
      * @brief Private reference to the model of Keller sensor
      */
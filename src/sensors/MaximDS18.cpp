@@ -11,6 +11,10 @@
 #include "MaximDS18.h"
 
 
+// The list of all DS18s, for sharing conversions between probes on one pin
+MaximDS18* MaximDS18::_lastDS18 = nullptr;
+
+
 // The constructor - if the hex address is known - also need the power pin and
 // the data pin
 MaximDS18::MaximDS18(DeviceAddress OneWireAddress, int8_t powerPin,
@@ -22,6 +26,7 @@ MaximDS18::MaximDS18(DeviceAddress OneWireAddress, int8_t powerPin,
       _internalOneWire(dataPin),
       _internalDallasTemp(&_internalOneWire) {
     for (uint8_t i = 0; i < 8; i++) _OneWireAddress[i] = OneWireAddress[i];
+    linkDS18();
 }
 // The constructor - if the hex address is NOT known - only need the power pin
 // and the data pin Can only use this if there is only a single sensor on the
@@ -33,7 +38,29 @@ MaximDS18::MaximDS18(int8_t powerPin, int8_t dataPin,
              dataPin, measurementsToAverage, DS18_INC_CALC_VARIABLES),
       _addressKnown(false),
       _internalOneWire(dataPin),
-      _internalDallasTemp(&_internalOneWire) {}
+      _internalDallasTemp(&_internalOneWire) {
+    linkDS18();
+}
+// Destructor - take this probe out of the list
+MaximDS18::~MaximDS18() {
+    if (_lastDS18 == this) {
+        _lastDS18 = _previousDS18;
+        return;
+    }
+    for (MaximDS18* ds = _lastDS18; ds != nullptr; ds = ds->_previousDS18) {
+        if (ds->_previousDS18 == this) {
+            ds->_previousDS18 = _previousDS18;
+            return;
+        }
+    }
+}
+
+
+// Adds this probe to the front of the list of all DS18s
+void MaximDS18::linkDS18() {
+    _previousDS18 = _lastDS18;
+    _lastDS18     = this;
+}
 
 
 // Turns the address into a printable string
@@ -158,14 +185,38 @@ bool MaximDS18::startSingleMeasurement() {
     // reason to go on.
     if (!Sensor::startSingleMeasurement()) return false;
 
-    // Send the command to get temperatures
-    MS_DBG(F("Asking DS18 to take a measurement"));
-    bool success =
-        _internalDallasTemp.requestTemperaturesByAddress(_OneWireAddress);
+    // If another probe on this pin already started a conversion that's still
+    // running, it's converting this probe too; wait for the same conversion.
+    // A conversion started before this probe was awake didn't reach it.
+    uint32_t sinceConversion = millis() - _millisConversionStarted;
+    if (_conversionPending && sinceConversion <= _measurementTime_ms &&
+        sinceConversion <= millis() - _millisSensorActivated) {
+        MS_DBG(F("Sharing the conversion already started on pin"), _dataPin);
+        _millisMeasurementRequested = _millisConversionStarted;
+        return true;
+    }
+
+    // Send one command (skip ROM) to get temperatures from every probe on the
+    // bus
+    MS_DBG(F("Asking all DS18s on pin"), _dataPin,
+           F("to take a measurement"));
+    bool success = _internalOneWire.reset() == 1;
+    if (success) {
+        _internalOneWire.skip();
+        // Hold the bus high during the conversion for parasite-powered probes
+        _internalOneWire.write(DS18_CONVERT_T_COMMAND,
+                               _internalDallasTemp.isParasitePowerMode());
+    }
 
     if (success) {
         // Update the time that a measurement was requested
         _millisMeasurementRequested = millis();
+        // Let every probe on this pin know its conversion has started
+        for (MaximDS18* ds = _lastDS18; ds != nullptr; ds = ds->_previousDS18) {
+            if (ds->_dataPin != _dataPin) continue;
+            ds->_conversionPending       = true;
+            ds->_millisConversionStarted = _millisMeasurementRequested;
+        }
     } else {
         // Set the status error bit (bit 7)
         setStatusBit(ERROR_OCCURRED);
@@ -191,6 +242,8 @@ bool MaximDS18::addSingleMeasurementResult() {
     MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
     result = _internalDallasTemp.getTempC(_OneWireAddress);
     MS_DBG(F("  Received"), result, F("°C"));
+    // The shared conversion has been used up
+    _conversionPending = false;
 
     // If a DS18 cannot get a good measurement, it returns 85
     // If the sensor is not properly connected, it returns -127
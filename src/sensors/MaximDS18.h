@@ -60,6 +60,12 @@
  * example provided within the Dallas Temperature library.  The sensor address
  * is programmed at the factory and cannot be changed.
  *
+ * Any number of DS18 probes can share one data pin.  The probes on a pin
+ * share their temperature conversions: the first probe to start a measurement
+ * sends a single convert command to every probe on the bus and the others
+ * wait for that same conversion and read their own results, so a string of
+ * probes takes one conversion time rather than one per probe.
+ *
  * @section sensor_ds18_datasheet Sensor Datasheet
  * - [DS18B20 Datasheet](https://github.com/EnviroDIY/ModularSensors/wiki/Sensor-Datasheets/Maxim-DS18B20-1-Wire-Temperature-Probe-Datasheet.pdf)
  * - [DS18S20 Datasheet](https://github.com/EnviroDIY/ModularSensors/wiki/Sensor-Datasheets/Maxim-DS18S20-1-Wire-Temperature-Probe-Datasheet.pdf)
@@ -175,6 +181,8 @@
 #define DS18_BAD_MEASUREMENT_VALUE 85.0f
 /// @brief Value returned when DS18 sensor is not properly connected
 #define DS18_DISCONNECTED_VALUE -127.0f
+/// @brief The OneWire Convert T command, which starts a temperature conversion
+#define DS18_CONVERT_T_COMMAND 0x44
 /**@}*/
 
 /* clang-format off */
@@ -231,9 +239,10 @@ class MaximDS18 : public Sensor {
     MaximDS18(int8_t powerPin, int8_t dataPin,
               uint8_t measurementsToAverage = 1);
     /**
-     * @brief Destroy the Maxim DS18 object
+     * @brief Destroy the Maxim DS18 object and remove it from the list of
+     * probes sharing conversions.
      */
-    ~MaximDS18() override = default;
+    ~MaximDS18() override;
 
     /**
      * @brief Do any one-time preparations needed before the sensor will be able
@@ -250,10 +259,41 @@ class MaximDS18 : public Sensor {
 
     String getSensorLocation() override;
 
+    /**
+     * @copydoc Sensor::startSingleMeasurement()
+     *
+     * If another DS18 on the same data pin has started a conversion that is
+     * still running, this probe is being converted too and no command is
+     * sent.  Otherwise a single convert command is sent to every probe on the
+     * bus.
+     */
     bool startSingleMeasurement() override;
     bool addSingleMeasurementResult() override;
 
  private:
+    /**
+     * @brief The most recently constructed DS18, the start of a list of every
+     * DS18 used to find the probes sharing a data pin.
+     */
+    static MaximDS18* _lastDS18;
+    /**
+     * @brief The DS18 constructed before this one, or a null pointer for the
+     * first.
+     */
+    MaximDS18* _previousDS18 = nullptr;
+    /**
+     * @brief True when a conversion covering this probe has been started on
+     * the bus and its result hasn't been read yet.
+     */
+    bool _conversionPending = false;
+    /**
+     * @brief The time the last conversion on the bus was started.
+     */
+    uint32_t _millisConversionStarted = 0;
+    /**
+     * @brief Add this probe to the list of every DS18.
+     */
+    void linkDS18();
     /**
      * @brief Internal reference to the OneWire device address.
      *
@@ -0,0 +1,167 @@
+/**
+ * @file ModbusRegisterRange.h
+ * @copyright Stroud Water Research Center
+ * Part of the EnviroDIY ModularSensors library for Arduino.
+ * This library is published under the BSD-3 license.
+ *
+ * @brief Contains the ModbusRegisterRange class, which reads a contiguous
+ * range of Modbus registers in a single transaction.
+ *
+ * This depends on the SensorModbusMaster library.
+ */
+
+// Header Guards
+#ifndef SRC_SENSORS_MODBUSREGISTERRANGE_H_
+#define SRC_SENSORS_MODBUSREGISTERRANGE_H_
+
+// Include the library config before anything else
+#include "ModSensorConfig.h"
+
+// Include other in-library and external dependencies
+#include <SensorModbusMaster.h>
+
+/**
+ * @brief A contiguous range of Modbus registers read in one transaction.
+ *
+ * Sensor drivers commonly read each value with its own request, so a sensor
+ * reporting several values spends several round trips on the RS-485 bus for
+ * one measurement.  When the values sit in neighboring registers, a parent
+ * sensor class can instead read every register from the first value to the
+ * last with read() and decode each value by its register number.  Registers
+ * between the values are read and ignored.
+ *
+ * The values are decoded from the response frame kept by the modbus master,
+ * so they must be taken before the master is used for anything else.
+ *
+ * @code{.cpp}
+ * ModbusRegisterRange range(_modbus, 0x0002, 0x0009);
+ * if (range.read()) {
+ *     float first = range.getFloat(0x0002);
+ *     float last  = range.getFloat(0x0008);
+ * }
+ * @endcode
+ */
+class ModbusRegisterRange {
+ public:
+    /**
+     * @brief The most registers a Modbus RTU read may request.
+     */
+    static const uint8_t MAX_REGISTERS = 125;
+
+    /**
+     * @brief Construct a new Modbus Register Range object
+     *
+     * @param modbus The modbus master, already begun with the sensor's address
+     * and stream.
+     * @param firstRegister The first register of the range.
+     * @param lastRegister The last register of the range.
+     * @param registerType The Modbus function code used to read the range;
+     * optional with a default value of 0x03, read holding registers.
+     */
+    ModbusRegisterRange(modbusMaster& modbus, uint16_t firstRegister,
+                        uint16_t lastRegister, byte registerType = 0x03)
+        : _modbus(modbus),
+          _firstRegister(firstRegister),
+          _lastRegister(lastRegister),
+          _registerType(registerType) {}
+
+    /**
+     * @brief Read the whole range in a single transaction.
+     *
+     * @return True if the sensor answered.
+     */
+    bool read() {
+        _read = false;
+        if (_lastRegister < _firstRegister ||
+            _lastRegister - _firstRegister + 1 > MAX_REGISTERS) {
+            return false;
+        }
+        _read = _modbus.getRegisters(_registerType, _firstRegister,
+                                     _lastRegister - _firstRegister + 1);
+        return _read;
+    }
+
+    /**
+     * @brief Check whether the last read() covered a value.
+     *
+     * @param reg The first register of the value.
+     * @param count The number of registers the value fills.
+     * @return True if the value was read.
+     */
+    bool contains(uint16_t reg, uint8_t count = 1) const {
+        return _read && reg >= _firstRegister &&
+            static_cast<uint32_t>(reg) + count - 1 <= _lastRegister;
+    }
+
+    /**
+     * @brief Decode a float filling two registers.
+     *
+     * @param reg The first of the two registers.
+     * @param endian The byte order of the value; optional with a default value
+     * of bigEndian.
+     * @return The value, or #MS_INVALID_VALUE if it wasn't read.
+     */
+    float getFloat(uint16_t reg, endianness endian = bigEndian) {
+        if (!contains(reg, 2)) { return MS_INVALID_VALUE; }
+        return _modbus.float32FromFrame(endian, frameIndex(reg));
+    }
+    /**
+     * @brief Decode a signed integer filling one register.
+     *
+     * @param reg The register.
+     * @param endian The byte order of the value; optional with a default value
+     * of bigEndian.
+     * @return The value, or #MS_INVALID_VALUE if it wasn't read.
+     */
+    int16_t getInt16(uint16_t reg, endianness endian = bigEndian) {
+        if (!contains(reg)) { return MS_INVALID_VALUE; }
+        return _modbus.int16FromFrame(endian, frameIndex(reg));
+    }
+    /**
+     * @brief Decode an unsigned integer filling one register.
+     *
+     * @param reg The register.
+     * @param endian The byte order of the value; optional with a default value
+     * of bigEndian.
+     * @return The value, or 0 if it wasn't read.
+     */
+    uint16_t getUint16(uint16_t reg, endianness endian = bigEndian) {
+        if (!contains(reg)) { return 0; }
+        return _modbus.uint16FromFrame(endian, frameIndex(reg));
+    }
+
+ private:
+    /**
+     * @brief The position of a register's value in the response frame, after
+     * the address, function code, and byte count.
+     *
+     * @param reg The register.
+     * @return The index in the response frame.
+     */
+    int frameIndex(uint16_t reg) const {
+        return 3 + 2 * (reg - _firstRegister);
+    }
+
+    /**
+     * @brief The modbus master the range is read through.
+     */
+    modbusMaster& _modbus;
+    /**
+     * @brief The first register of the range.
+     */
+    uint16_t _firstRegister;
+    /**
+     * @brief The last register of the range.
+     */
+    uint16_t _lastRegister;
+    /**
+     * @brief The Modbus function code used to read the range.
+     */
+    byte _registerType;
+    /**
+     * @brief True if the last read() was answered.
+     */
+    bool _read = false;
+};
+
+#endif  // SRC_SENSORS_MODBUSREGISTERRANGE_H_
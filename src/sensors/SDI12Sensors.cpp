@@ -32,6 +32,10 @@
 #endif
 
 
+// The list of all SDI-12 sensors, for batching measurements on one pin
+SDI12Sensors* SDI12Sensors::_lastSDI12 = nullptr;
+
+
 // The constructor - need the number of measurements the sensor will return,
 // SDI-12 address, the power pin, and the data pin
 SDI12Sensors::SDI12Sensors(char SDI12address, int8_t powerPin, int8_t dataPin,
@@ -47,7 +51,9 @@ SDI12Sensors::SDI12Sensors(char SDI12address, int8_t powerPin, int8_t dataPin,
              measurementsToAverage, incCalcValues),
       _SDI12Internal(dataPin),
       _SDI12address(SDI12address),
-      _extraWakeTime(extraWakeTime) {}
+      _extraWakeTime(extraWakeTime) {
+    linkSDI12();
+}
 // Delegating constructor
 SDI12Sensors::SDI12Sensors(char* SDI12address, int8_t powerPin, int8_t dataPin,
                            uint8_t       measurementsToAverage,
@@ -74,6 +80,27 @@ SDI12Sensors::SDI12Sensors(int SDI12address, int8_t powerPin, int8_t dataPin,
                    measurementsToAverage, sensorName, totalReturnedValues,
                    warmUpTime_ms, stabilizationTime_ms, measurementTime_ms,
                    extraWakeTime, incCalcValues) {}
+// Destructor - take this sensor out of the list
+SDI12Sensors::~SDI12Sensors() {
+    if (_lastSDI12 == this) {
+        _lastSDI12 = _previousSDI12;
+        return;
+    }
+    for (SDI12Sensors* sdi = _lastSDI12; sdi != nullptr;
+         sdi                = sdi->_previousSDI12) {
+        if (sdi->_previousSDI12 == this) {
+            sdi->_previousSDI12 = _previousSDI12;
+            return;
+        }
+    }
+}
+
+
+// Adds this sensor to the front of the list of all SDI-12 sensors
+void SDI12Sensors::linkSDI12() {
+    _previousSDI12 = _lastSDI12;
+    _lastSDI12     = this;
+}
 
 
 bool SDI12Sensors::setup() {
@@ -145,9 +172,9 @@ bool SDI12Sensors::requestSensorAcknowledgement() {
     _SDI12Internal.clearBuffer();
 
     MS_DBG(F("  Asking for sensor acknowledgement"));
-    String myCommand = "";
-    myCommand += _SDI12address;
-    myCommand += "!";  // sends 'acknowledge active' command [address][!]
+    // sends 'acknowledge active' command [address][!]
+    const char myCommand[3] = {_SDI12address, '!', '\0'};
+    char       sdiResponse[SDI12_MAX_RESPONSE_LENGTH + 1];
 
     bool    didAcknowledge = false;
     uint8_t ntries         = 0;
@@ -158,18 +185,18 @@ bool SDI12Sensors::requestSensorAcknowledgement() {
 
         // wait for acknowledgement with format:
         // [address]<CR><LF>
-        String sdiResponse = _SDI12Internal.readStringUntil('\n');
-        sdiResponse.trim();
+        size_t respLen = readSDI12Response(_SDI12Internal, sdiResponse,
+                                           sizeof(sdiResponse));
         MS_DEEP_DBG(F("    <<<"), sdiResponse);
 
         // Empty the buffer again
         _SDI12Internal.clearBuffer();
 
-        if (sdiResponse == String(_SDI12address)) {
+        if (respLen == 1 && sdiResponse[0] == _SDI12address) {
             MS_DBG(F("   "), getSensorNameAndLocation(),
                    F("replied as expected."));
             didAcknowledge = true;
-        } else if (sdiResponse.startsWith(String(_SDI12address))) {
+        } else if (respLen > 1 && sdiResponse[0] == _SDI12address) {
             MS_DBG(F("   "), getSensorNameAndLocation(),
                    F("replied, strangely"));
             didAcknowledge = true;
@@ -185,6 +212,118 @@ bool SDI12Sensors::requestSensorAcknowledgement() {
 }
 
 
+// Reads one response into the buffer, without the line ending or any
+// surrounding whitespace
+size_t SDI12Sensors::readSDI12Response(SDI12& sdi12, char* buffer,
+                                       size_t bufferSize) {
+    size_t len = sdi12.readBytesUntil('\n', buffer, bufferSize - 1);
+    // trim the carriage return and any other whitespace off the end
+    while (len > 0 && isspace(static_cast<unsigned char>(buffer[len - 1]))) {
+        len--;
+    }
+    // trim any whitespace off the front
+    size_t start = 0;
+    while (start < len && isspace(static_cast<unsigned char>(buffer[start]))) {
+        start++;
+    }
+    if (start > 0) { memmove(buffer, buffer + start, len - start); }
+    len -= start;
+    buffer[len] = '\0';
+    return len;
+}
+
+
+// Adds one byte to a running SDI-12 CRC-16, per SDI-12 Protocol v1.4,
+// Section 4.4.12
+uint16_t SDI12Sensors::addToSDI12CRC(uint16_t crc, uint8_t value) {
+    crc ^= value;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        if (crc & 0x0001) {
+            crc = (crc >> 1) ^ 0xA001;
+        } else {
+            crc >>= 1;
+        }
+    }
+    return crc;
+}
+
+
+// Checks the 3 character CRC at the end of a response against the CRC-16 of
+// the rest of the response
+bool SDI12Sensors::checkSDI12CRC(const char* response, size_t length) {
+    if (length < 4) { return false; }
+    uint16_t crc = 0;
+    for (size_t i = 0; i < length - 3; i++) {
+        crc = addToSDI12CRC(crc, static_cast<uint8_t>(response[i]));
+    }
+    // The CRC is sent as three characters, each holding 6 bits OR'd with 0x40
+    return response[length - 3] == static_cast<char>(0x40 | (crc >> 12)) &&
+        response[length - 2] == static_cast<char>(0x40 | ((crc >> 6) & 0x3F)) &&
+        response[length - 1] == static_cast<char>(0x40 | (crc & 0x3F));
+}
+
+
+// Parses the values of a data response in a single pass
+int8_t SDI12Sensors::parseSDI12Values(const char* values, size_t length,
+                                      float results[], uint8_t maxResults) {
+    // the value portion must be structred as pd.d
+    // - p - the polarity sign (+ or -)
+    // - d - numeric digits before the decimal place
+    // - . - the decimal point (optional)
+    // - d - numeric digits after the decimal point
+    // From SDI-12 Protocol v1.4, Table 11, a value has at most 7 digits, so
+    // the digits are read into an integer and scaled once at the end of the
+    // value.
+    uint8_t numResults = 0;
+    int32_t mantissa   = 0;
+    uint8_t nDigits    = 0;
+    int8_t  nDecimals  = -1;  // -1 until the decimal point is read
+    bool    negative   = false;
+    bool    inValue    = false;
+    for (size_t i = 0; i <= length; i++) {
+        // a polarity sign or the end of the response ends the previous value
+        char c = i < length ? values[i] : '+';
+        if (c == '+' || c == '-') {
+            if (inValue) {
+                // a sign, a decimal point, or too many digits alone is bad
+                if (nDigits == 0 || nDigits > 9) { return -1; }
+                float scale = 1;
+                for (int8_t d = 0; d < nDecimals; d++) { scale *= 10; }
+                float result = static_cast<float>(mantissa) / scale;
+                if (negative) { result = -result; }
+                MS_DBG(F("Result"), numResults, F("Parsed value:"),
+                       String(result, nDecimals > 0 ? nDecimals : 0));
+                // The SDI-12 library should return our set timeout value of
+                // MS_INVALID_VALUE on timeout; those aren't counted
+                if (result == MS_INVALID_VALUE) {
+                    MS_DBG(F("Result is not valid!"));
+                } else if (numResults < maxResults) {
+                    results[numResults++] = result;
+                }
+            }
+            // start the next value
+            inValue   = true;
+            negative  = c == '-';
+            mantissa  = 0;
+            nDigits   = 0;
+            nDecimals = -1;
+        } else if (c >= '0' && c <= '9') {
+            inValue = true;
+            if (nDigits < 9) { mantissa = mantissa * 10 + (c - '0'); }
+            nDigits++;
+            if (nDecimals >= 0) { nDecimals++; }
+        } else if (c == '.' && nDecimals < 0) {
+            inValue   = true;
+            nDecimals = 0;
+        } else {
+            MS_DEEP_DBG(F("Invalid data response character:"), c);
+            return -1;
+        }
+    }
+    return numResults;
+}
+
+
 // A helper function to run the "sensor info" SDI12 command
 bool SDI12Sensors::getSensorInfo() {
     activate();
@@ -288,16 +427,36 @@ String SDI12Sensors::getSensorLocation() {
 }
 
 // Sending the command to start a measurement
-int8_t SDI12Sensors::startSDI12Measurement(bool isConcurrent) {
-    String startCommand;
-    String sdiResponse;
-    String returnedAddress;
+int16_t SDI12Sensors::startSDI12Measurement(bool isConcurrent,
+                                            SDI12* bus) {
+    // Send on the given (already active) SDI-12 object, or on our own
+    SDI12& sdi12 = bus != nullptr ? *bus : _SDI12Internal;
+
+    // The start command is [address][M or C][C to request a CRC][!] or, for
+    // a high volume binary measurement, [address][H][B][!]
+    char    startCommand[5];
+    uint8_t cmdLen         = 0;
+    startCommand[cmdLen++] = _SDI12address;
+    if (_highVolumeBinary) {
+        // Binary data packets always include a CRC
+        startCommand[cmdLen++] = 'H';
+        startCommand[cmdLen++] = 'B';
+    } else {
+        // Start concurrent measurement - 'C' or standard measurement - 'M'
+        startCommand[cmdLen++] = isConcurrent ? 'C' : 'M';
+        if (MS_SDI12_USE_CRC) {
+            startCommand[cmdLen++] = 'C';  // Add C to request a CRC
+        }
+    }
+    startCommand[cmdLen++] = '!';  // All commands end with '!'
+    startCommand[cmdLen]   = '\0';
+    char sdiResponse[SDI12_MAX_RESPONSE_LENGTH + 1];
 
     // Try up to 5 times to start a measurement
-    uint8_t numVariables   = 0;
-    uint8_t ntries         = 0;
-    bool    didAcknowledge = false;
-    int8_t  wait           = -1;  // NOTE: The wait time can be 0!
+    uint16_t numVariables   = 0;
+    uint8_t  ntries         = 0;
+    bool     didAcknowledge = false;
+    int16_t  wait           = -1;  // NOTE: The wait time can be 0!
     while (!didAcknowledge && ntries < 5) {
         if (isConcurrent) {
             MS_DBG(F("  Beginning concurrent measurement on"),
@@ -306,48 +465,50 @@ int8_t SDI12Sensors::startSDI12Measurement(bool isConcurrent) {
             MS_DBG(F("  Beginning NON-concurrent (standard) measurement on"),
                    getSensorNameAndLocation());
         }
-        startCommand = "";
-        startCommand += _SDI12address;
-        if (isConcurrent) {
-            startCommand += "C";  // Start concurrent measurement - 'C'
-        } else {
-            startCommand += "M";  // Start standard measurement - 'M'
-        }
-        if (MS_SDI12_USE_CRC) {
-            startCommand += "C";  // Add C to request a CRC
-        }
-        startCommand += "!";  // All commands end with '!'
-        _SDI12Internal.clearBuffer();
-        _SDI12Internal.sendCommand(startCommand, _extraWakeTime);
+        sdi12.clearBuffer();
+        sdi12.sendCommand(startCommand, _extraWakeTime);
         delay(30);  // It just needs this little delay
         MS_DEEP_DBG(F("    >>>"), startCommand);
 
         // wait for acknowledgement with format
         // [address][ttt (3 char, seconds)][number of values to be returned,
-        // 0-9]<CR><LF>
-        sdiResponse = _SDI12Internal.readStringUntil('\n');
-        sdiResponse.trim();
-        _SDI12Internal.clearBuffer();
+        // 0-9, or 0-999 for high volume]<CR><LF>
+        size_t respLen = readSDI12Response(sdi12, sdiResponse,
+                                           sizeof(sdiResponse));
+        sdi12.clearBuffer();
         MS_DEEP_DBG(F("    <<<"), sdiResponse);
 
-        // find out how long we have to wait (in seconds).
-        if (sdiResponse.length() > 3) {
-            returnedAddress = sdiResponse.substring(0, 1);
-            wait = static_cast<uint8_t>(sdiResponse.substring(1, 4).toInt());
-            numVariables =
-                static_cast<uint8_t>(sdiResponse.substring(4).toInt());
+        // find out how long we have to wait (in seconds) and how many values
+        // will be returned, reading the digits in a single pass
+        char returnedAddress = '\0';
+        wait                 = -1;
+        numVariables         = 0;
+        if (respLen > 3) {
+            returnedAddress = sdiResponse[0];
+            int16_t ttt     = 0;
+            for (size_t i = 1; i < respLen; i++) {
+                char c = sdiResponse[i];
+                if (c < '0' || c > '9') break;
+                if (i < 4) {
+                    ttt = ttt * 10 + (c - '0');
+                } else {
+                    numVariables = numVariables * 10 + (c - '0');
+                }
+            }
+            wait = ttt;
         }
         MS_DEEP_DBG(F("   Responding address:"), returnedAddress,
                     F("wait time:"), wait, F("result count:"), numVariables);
         // Only require that the responding address be correct to consider the
         // result to have been started
-        if (returnedAddress == String(_SDI12address)) {
+        if (returnedAddress == _SDI12address) {
             didAcknowledge = true;
         } else {
             // print a warning if the responding address is wrong (and try
             // again)
             MS_DBG(F("   Wrong address replied, got"), returnedAddress,
                    F("instead of"), _SDI12address);
+            wait = -1;
         }
         // Print a warning if the wait is going to be longer than we expect
         if (wait > ceil(_measurementTime_ms / 1000)) {
@@ -361,7 +522,7 @@ int8_t SDI12Sensors::startSDI12Measurement(bool isConcurrent) {
         }
 
         // Empty the buffer again
-        _SDI12Internal.clearBuffer();
+        sdi12.clearBuffer();
         ntries++;
     }
 
@@ -373,6 +534,17 @@ int8_t SDI12Sensors::startSDI12Measurement(bool isConcurrent) {
 
 
 #ifndef MS_SDI12_NON_CONCURRENT
+// Checks if another sensor is ready to have a concurrent measurement started
+// along with ours: on the same pin, awake, stable, and not already measuring
+bool SDI12Sensors::canJoinBatch(int8_t dataPin) {
+    return _dataPin == dataPin && !_concurrentPending &&
+        getStatusBit(SETUP_SUCCESSFUL) && getStatusBit(WAKE_SUCCESSFUL) &&
+        !getStatusBit(MEASUREMENT_ATTEMPTED) &&
+        getCompletedMeasurements() < getNumberMeasurementsToAverage() &&
+        isStable();
+}
+
+
 // Sending the command to get a concurrent measurement
 bool SDI12Sensors::startSingleMeasurement() {
     // Sensor::startSingleMeasurement() checks that if it's awake/active and
@@ -380,21 +552,40 @@ bool SDI12Sensors::startSingleMeasurement() {
     // reason to go on.
     if (!Sensor::startSingleMeasurement()) return false;
 
+    // If another sensor on this pin already started our measurement along with
+    // its own since we were woken, use that one
+    if (_concurrentPending &&
+        millis() - _millisConcurrentStarted <=
+            millis() - _millisSensorActivated) {
+        MS_DBG(F("    Concurrent measurement already started with the other"),
+               F("sensors on pin"), _dataPin);
+        _millisMeasurementRequested = _millisConcurrentStarted;
+        return true;
+    }
+    _concurrentPending = false;
+
     // activate the SDI-12 object
     activate();
 
-    // Check that the sensor is there and responding
-    if (!requestSensorAcknowledgement()) {
-        setStatusBit(ERROR_OCCURRED);
-        _millisMeasurementRequested = 0;
-        clearStatusBit(MEASUREMENT_SUCCESSFUL);
-        deactivate();
-        return false;
-    }
-
     // send the commands to start the measurement; true = concurrent
-    // the returned wait time should always be non-zero
-    int8_t wait = startSDI12Measurement(true);
+    // NOTE: The sensor must reply to the start command with its own address,
+    // so there's no need for a separate acknowledgement first.
+    int16_t wait = startSDI12Measurement(true);
+
+    // While the bus is active, start a concurrent measurement on every other
+    // sensor on this pin that is ready for one
+    if (wait >= 0) {
+        for (SDI12Sensors* sdi = _lastSDI12; sdi != nullptr;
+             sdi                = sdi->_previousSDI12) {
+            if (sdi == this || !sdi->canJoinBatch(_dataPin)) continue;
+            int16_t sdiWait = sdi->startSDI12Measurement(true,
+                                                         &_SDI12Internal);
+            if (sdiWait < 0) continue;
+            sdi->_concurrentPending       = true;
+            sdi->_millisConcurrentStarted = millis();
+            sdi->_concurrentWait_ms       = sdi->concurrentWait(sdiWait);
+        }
+    }
 
     // Empty the buffer and de-activate the SDI-12 Object
     deactivate();
@@ -404,6 +595,7 @@ bool SDI12Sensors::startSingleMeasurement() {
         MS_DBG(F("    Concurrent measurement started."));
         // Update the time that a measurement was requested
         _millisMeasurementRequested = millis();
+        _concurrentWait_ms          = concurrentWait(wait);
         // Set the status bit for measurement start success (bit 6)
         setStatusBit(MEASUREMENT_SUCCESSFUL);
         return true;
@@ -417,24 +609,67 @@ bool SDI12Sensors::startSingleMeasurement() {
         return false;
     }
 }
+
+
+// The wait for a concurrent measurement is the one the sensor returned, but
+// never less than the measurement time set for it
+uint32_t SDI12Sensors::concurrentWait(int16_t wait) {
+    return max(static_cast<uint32_t>(wait) * 1000, _measurementTime_ms);
+}
+
+
+// The measurement is done when the wait the sensor returned has passed
+bool SDI12Sensors::isMeasurementComplete() {
+    if (!getStatusBit(MEASUREMENT_SUCCESSFUL)) {
+        return Sensor::isMeasurementComplete();
+    }
+
+    uint32_t elapsed_since_meas_start = millis() - _millisMeasurementRequested;
+    if (elapsed_since_meas_start > _concurrentWait_ms) {
+        MS_DBG(F("It's been"), elapsed_since_meas_start,
+               F("ms, and measurement by"), getSensorNameAndLocation(),
+               F("should be complete!"));
+        return true;
+    }
+    return false;
+}
+
+
+uint32_t SDI12Sensors::getMillisToNextEvent() {
+    if (!getStatusBit(MEASUREMENT_ATTEMPTED) ||
+        !getStatusBit(MEASUREMENT_SUCCESSFUL)) {
+        return Sensor::getMillisToNextEvent();
+    }
+    // The timing checks require strictly more than the wait time to pass
+    uint32_t elapsed = millis() - _millisMeasurementRequested;
+    if (elapsed > _concurrentWait_ms) { return 0; }
+    return _concurrentWait_ms - elapsed + 1;
+}
+
+
+// A concurrent measurement started by another sensor in an earlier update is
+// stale; the sensor may have been awake since before it was started
+void SDI12Sensors::clearMeasurementStatus() {
+    Sensor::clearMeasurementStatus();
+    _concurrentPending = false;
+}
 #endif
 
 bool SDI12Sensors::getResults(bool verify_crc) {
+    // High volume binary data come in binary packets, which always carry a CRC
+    if (_highVolumeBinary) { return getBinaryResults(); }
+
     // activate the SDI-12 object
     activate();
 
     MS_DBG(getSensorNameAndLocation(), F("is reporting:"));
+    uint8_t resultsExpected = _numReturnedValues - _incCalcValues;
     uint8_t resultsReceived = 0;
     uint8_t cmd_number      = 0;
     uint8_t cmd_retries     = 0;
 
     // the result is structured <addr><values><CR><LF> or
     // <addr><values><CRC><CR><LF>
-    // the value portion must be structred as pd.d
-    // - p - the polarity sign (+ or -)
-    // - d - numeric digits before the decimal place
-    // - . - the decimal point (optional)
-    // - d - numeric digits after the decimal point
 
     // From SDI-12 Protocol v1.4, Section 4.4 SDI-12 Commands and Responses:
     // The maximum number of characters that can be returned in the <values>
@@ -443,20 +678,9 @@ bool SDI12Sensors::getResults(bool verify_crc) {
     // command, or in response to a high-volume ASCII measurement command, the
     // maximum is 75. The maximum is also 75 in response to a continuous
     // measurement command. Otherwise, the maximum is 35.
-    int max_sdi_response = 76;
-    // From SDI-12 Protocol v1.4, Table 11 The send data command (aD0!, aD1! . .
-    // . aD9!):
-    // - the maximum number of digits for a data value is 7, even without a
-    // decimal point
-    // - the minimum number of digits for a data value (excluding the decimal
-    // point) is 1
-    // - the maximum number of characters in a data value is 9 (the (polarity
-    // sign + 7 digits + the decimal point))
-    // - SRGD Note: The polarity symbol (+ or -) acts as a delimeter between the
-    // numeric values
-    int max_sdi_digits = 10;
-
-    String compiled_response = "";
+    char resp_buffer[SDI12_MAX_RESPONSE_LENGTH + 1];
+    // SDI-12 command to get data [address][D][dataOption][!]
+    char getDataCommand[5] = {_SDI12address, 'D', '0', '!', '\0'};
 
     bool success = true;
 
@@ -466,21 +690,14 @@ bool SDI12Sensors::getResults(bool verify_crc) {
     // (D1-9).  Since this is a parent to all sensors, we're going to keep
     // requesting data until we either get as many results as we expect or no
     // more data is returned.
-    while (resultsReceived < (_numReturnedValues - _incCalcValues) &&
-           cmd_number <= 9 && cmd_retries < 5) {
+    while (resultsReceived < resultsExpected && cmd_number <= 9 &&
+           cmd_retries < 5) {
         MS_DEEP_DBG(F("Attempt"), cmd_retries, F("to get data number"),
                     cmd_number);
-        bool    gotResults  = false;
-        uint8_t cmd_results = 0;
         // Assemble the command based on how many commands we've already sent,
         // starting with D0 and ending with D9
-        // SDI-12 command to get data [address][D][dataOption][!]
         _SDI12Internal.clearBuffer();
-        String getDataCommand = "";
-        getDataCommand += _SDI12address;
-        getDataCommand += "D";
-        getDataCommand += cmd_number;
-        getDataCommand += "!";
+        getDataCommand[2] = static_cast<char>('0' + cmd_number);
         _SDI12Internal.sendCommand(getDataCommand, _extraWakeTime);
         delay(30);  // It just needs this little delay
         MS_DEEP_DBG(F("    >>>"), getDataCommand);
@@ -494,20 +711,11 @@ bool SDI12Sensors::getResults(bool verify_crc) {
             // wait
         }
 
-        // create a temporary buffer for incoming values
-        char resp_buffer[max_sdi_response] = {'\0'};
-
         // read bytes into the char array until we get to a new line (\r\n)
-        size_t bytes_read = _SDI12Internal.readBytesUntil('\n', resp_buffer,
-                                                          max_sdi_response);
-        MS_DEEP_DBG(F("Received"), bytes_read, F(" characters"));
-
-        size_t data_bytes_read = bytes_read -
-            1;  // subtract one for the /r before the /n
-        String sdiResponse = String(resp_buffer);
-        compiled_response += sdiResponse;
-        sdiResponse.trim();
-        MS_DEEP_DBG(F("    <<<"), sdiResponse);
+        size_t data_bytes_read = readSDI12Response(
+            _SDI12Internal, resp_buffer, sizeof(resp_buffer));
+        MS_DEEP_DBG(F("Received"), data_bytes_read, F(" characters"));
+        MS_DEEP_DBG(F("    <<<"), resp_buffer);
 
         // read and clear anything else from the buffer
         int extra_chars = 0;
@@ -528,12 +736,12 @@ bool SDI12Sensors::getResults(bool verify_crc) {
 
         // check the crc, break if it's incorrect
         if (verify_crc) {
-            bool crcMatch = _SDI12Internal.verifyCRC(sdiResponse);
-            // subtract the 3 characters of the CRC from the total number of
-            // data values
-            data_bytes_read = data_bytes_read - 3;
+            bool crcMatch = checkSDI12CRC(resp_buffer, data_bytes_read);
             if (crcMatch) {
                 MS_DEEP_DBG(F("CRC valid"));
+                // subtract the 3 characters of the CRC from the total number
+                // of data values
+                data_bytes_read -= 3;
             } else {
                 MS_DBG(F("CRC check failed!"));
                 success = false;
@@ -554,11 +762,9 @@ bool SDI12Sensors::getResults(bool verify_crc) {
         // we're not checking the CRC or we got a well formed response from the
         // wrong sensor.
         char returnedAddress = resp_buffer[0];
-        if (returnedAddress != _SDI12address) {
+        if (data_bytes_read == 0 || returnedAddress != _SDI12address) {
             MS_DBG(F("Wrong address returned!"));
-            MS_DBG(F("Expected"), String(_SDI12address), F("Got"),
-                   String(returnedAddress));
-            MS_DEEP_DBG(String(resp_buffer));
+            MS_DBG(F("Expected"), _SDI12address, F("Got"), returnedAddress);
             success = false;
             // if we didn't get the correct address, add one to the retry
             // attempts but do not bump up the command number or transfer any
@@ -570,104 +776,17 @@ bool SDI12Sensors::getResults(bool verify_crc) {
             continue;
         }
 
-        // create a temporary rx buffer for incoming values
-        // this buffer will have a maximum size of the number of measured values
-        // of the sensor
-        float cmd_rx[_numReturnedValues - _incCalcValues];
-        // flag to mark a bad numeric value within the response
-        bool bad_read = false;
-        // another small buffer to hold the float values for atof
-        char float_buffer[max_sdi_digits] = {'\0'};
-        // flag to mark if we've gotten a decimal point in the float buffer, so
-        // we can check for bad repeated decimals
-        bool got_decimal = false;
-#if defined(MS_SDI12SENSORS_DEBUG) && !defined(MS_SILENT)
-        // mark to keep track of the decimal point in the float buffer, just
-        // used for pretty printing
-        char* dec_pl = float_buffer;
-#endif
-        // a pointer to our place in the float buffer - start at start of buffer
-        uint8_t fb_pos = 0;
-        // iterate through the char array and to check results
-        // NOTE: start at 1 since we already looked at the address!
-        for (size_t i = 1; i <= data_bytes_read; i++) {
-            // Get the character at position
-            char c = resp_buffer[i];
-            // if we get a polarity sign (+ or -) that is not the first
-            // character after the address, or we've reached the end of the
-            // buffer, then we're at the end of the previous number and can
-            // parse the float buffer
-            if ((((c == '-' || c == '+') && i != 1) || i == data_bytes_read) &&
-                strnlen(float_buffer, max_sdi_digits) > 0) {
-                // Read the float only skipping the '+' if it's included as the
-                // polarity.  Reading the numbers as a float will remove them
-                // from the buffer.
-                float result = atof(float_buffer);
-#if defined(MS_SDI12SENSORS_DEBUG) && !defined(MS_SILENT)
-                // NOTE: This bit below is just for pretty-printing
-                dec_pl              = strchr(float_buffer, '.');
-                size_t len_post_dec = 0;
-                if (dec_pl != nullptr) {
-                    len_post_dec = strnlen(dec_pl, max_sdi_digits) - 1;
-                }
-                MS_DBG(F("Result"), cmd_results, F("Raw value:"), float_buffer,
-                       F("Parsed value:"), String(result, len_post_dec));
-#endif
-                // The SDI-12 library should return our set timeout value of
-                // MS_INVALID_VALUE on timeout
-                if (result == MS_INVALID_VALUE || isnan(result)) {
-                    MS_DBG(F("Result is not valid!"));
-                    result = MS_INVALID_VALUE;
-                }
-                // Put the read value into the temporary buffer. After each
-                // result is read, tick up the number of results received so
-                // that the next one goes in the next spot in the holding
-                // buffer.
-                cmd_rx[cmd_results] = result;
-                // add how many results we have
-                if (result != MS_INVALID_VALUE) {
-                    gotResults = true;
-                    cmd_results++;
-                }
-                // empty the float buffer so it's ready for the next number
-                float_buffer[0] = '\0';
-                fb_pos          = 0;
-                got_decimal     = false;
-            }
-            // if we just read the last byte, continue to the next iteration
-            // which will parse the float out of it
-            if (i == data_bytes_read) { continue; }
-            // if we're mid-number and there's a digit, a decimal, or a negative
-            // sign in the sdi12 response buffer, add it to the current float
-            // buffer
-            if (c == '-' || (c >= '0' && c <= '9') ||
-                (c == '.' && !got_decimal)) {
-                float_buffer[fb_pos] = c;
-                fb_pos++;
-                float_buffer[fb_pos] = '\0';  // null terminate the buffer
-            } else if (c == '+') {
-                // if we get a "+", it's a valid SDI-12 polarity indicator, but
-                // not something accepted by atof in parsing the float, so we
-                // just ignore it NOTE: A mis-read like this should also cause
-                // the CRC to be wrong, but still check here in case we're not
-                // using a CRC.
-            } else {  //(c != '-' && c != '+' && (c < '0' || c > '9') && c !=
-                      //'.')
-#if defined(MS_SDI12SENSORS_DEBUG_DEEP) && !defined(MS_SILENT)
-                MS_SERIAL_OUTPUT.print("Invalid data response character: ");
-                MS_SERIAL_OUTPUT.write(c);
-                MS_SERIAL_OUTPUT.println();
-#endif
-                bad_read = true;
-            }
-            // if we get a decimal, mark it so we can verify we don't get
-            // repeated decimals
-            if (c == '.') { got_decimal = true; }
-        }
+        // Parse the values straight out of the response (after the address)
+        // into the temporary buffer, which holds no more than the remaining
+        // number of measured values of the sensor
+        float   cmd_rx[resultsExpected];
+        int8_t  cmd_results = parseSDI12Values(resp_buffer + 1,
+                                               data_bytes_read - 1, cmd_rx,
+                                               resultsExpected - resultsReceived);
 
         // if we got results and none of them are bad, transfer from the
         // temporary buffer to the sensor's variable array
-        if (gotResults && !bad_read) {
+        if (cmd_results > 0) {
             for (uint8_t cr = 0; cr < cmd_results; cr++) {
                 MS_DEEP_DBG(F("Moving result #"), cr, '(', cmd_rx[cr],
                             F(") to result"), resultsReceived,
@@ -676,8 +795,7 @@ bool SDI12Sensors::getResults(bool verify_crc) {
                 resultsReceived++;
             }
             MS_DBG(F("  Total Results Received:"), resultsReceived,
-                   F("Remaining:"),
-                   (_numReturnedValues - _incCalcValues) - resultsReceived);
+                   F("Remaining:"), resultsExpected - resultsReceived);
             cmd_number++;
         } else {
             // if we got a bad charater in the response, add one to the retry
@@ -693,16 +811,200 @@ bool SDI12Sensors::getResults(bool verify_crc) {
     _SDI12Internal.clearBuffer();
 
     MS_DEEP_DBG(F("After"), cmd_number, F("data commands got"), resultsReceived,
-                F("results of the expected"),
-                _numReturnedValues - _incCalcValues, F("expected. This is a"),
-                resultsReceived == _numReturnedValues - _incCalcValues
-                    ? F("success.")
-                    : F("failure."));
+                F("results of the expected"), resultsExpected,
+                F("expected. This is a"),
+                resultsReceived == resultsExpected ? F("success.")
+                                                   : F("failure."));
+
+    // Empty the buffer and de-activate the SDI-12 Object
+    deactivate();
+
+    return success && resultsExpected == resultsReceived;
+}
+
+
+// Gets the results of a high volume binary measurement
+bool SDI12Sensors::getBinaryResults() {
+    // activate the SDI-12 object
+    activate();
+
+    MS_DBG(getSensorNameAndLocation(), F("is reporting binary data:"));
+    uint8_t  resultsExpected = _numReturnedValues - _incCalcValues;
+    uint8_t  resultsReceived = 0;
+    uint16_t cmd_number      = 0;
+    uint8_t  cmd_retries     = 0;
+    bool     success         = true;
+
+    // From SDI-12 Protocol v1.4, Section 5.2, each binary data packet is
+    // structured <addr><packet size (2 bytes)><data type (1 byte)><values>
+    // <CRC (2 bytes)>, with no line ending.  The packet size is the number of
+    // bytes of values and all multi-byte fields are sent least significant
+    // byte first.
+    // The size in bytes of each value for data types 0-10
+    static const uint8_t valueSizes[] = {0, 1, 1, 2, 2, 4, 4, 8, 8, 4, 8};
+
+    // SDI-12 command to get binary data [address][D][B][packet number][!]
+    char getDataCommand[8];
+
+    // Keep requesting packets (DB0-DB999) until we either get as many results
+    // as we expect or no more data is returned.
+    while (resultsReceived < resultsExpected && cmd_number <= 999 &&
+           cmd_retries < 5) {
+        MS_DEEP_DBG(F("Attempt"), cmd_retries, F("to get binary packet"),
+                    cmd_number);
+        uint8_t cmdLen           = 0;
+        getDataCommand[cmdLen++] = _SDI12address;
+        getDataCommand[cmdLen++] = 'D';
+        getDataCommand[cmdLen++] = 'B';
+        if (cmd_number >= 100) {
+            getDataCommand[cmdLen++] = '0' + cmd_number / 100;
+        }
+        if (cmd_number >= 10) {
+            getDataCommand[cmdLen++] = '0' + (cmd_number / 10) % 10;
+        }
+        getDataCommand[cmdLen++] = '0' + cmd_number % 10;
+        getDataCommand[cmdLen++] = '!';
+        getDataCommand[cmdLen]   = '\0';
+        _SDI12Internal.clearBuffer();
+        _SDI12Internal.sendCommand(getDataCommand, _extraWakeTime);
+        MS_DEEP_DBG(F("    >>>"), getDataCommand);
+
+        // Read the packet header
+        uint8_t header[4];
+        if (_SDI12Internal.readBytes(header, 4) != 4 ||
+            header[0] != static_cast<uint8_t>(_SDI12address)) {
+            MS_DBG(F("No binary packet from the correct address!"));
+            _SDI12Internal.clearBuffer();
+            success = false;
+            cmd_retries++;
+            continue;
+        }
+        uint16_t packetSize = header[1] | (static_cast<uint16_t>(header[2])
+                                           << 8);
+        uint8_t  dataType   = header[3];
+        uint8_t  valueSize  = dataType < sizeof(valueSizes) ? valueSizes[dataType]
+                                                            : 0;
+        MS_DEEP_DBG(F("    <<< Packet size:"), packetSize, F("data type:"),
+                    dataType);
+        if (valueSize == 0 || packetSize % valueSize != 0) {
+            // An empty packet or one we can't read; drop the rest of it
+            MS_DBG(F("No readable values in binary packet!  Will retry!"));
+            delay(30);
+            _SDI12Internal.clearBuffer();
+            cmd_retries++;
+            continue;
+        }
+
+        uint16_t crc = 0;
+        for (uint8_t i = 0; i < 4; i++) { crc = addToSDI12CRC(crc, header[i]); }
+
+        // Read the values straight out of the stream, one at a time, into a
+        // temporary buffer that holds no more than the remaining number of
+        // measured values of the sensor
+        float    cmd_rx[resultsExpected];
+        uint8_t  cmd_results = 0;
+        bool     readFailed  = false;
+        uint16_t numValues   = packetSize / valueSize;
+        for (uint16_t v = 0; v < numValues; v++) {
+            uint8_t raw[8];
+            if (_SDI12Internal.readBytes(raw, valueSize) != valueSize) {
+                readFailed = true;
+                break;
+            }
+            for (uint8_t i = 0; i < valueSize; i++) {
+                crc = addToSDI12CRC(crc, raw[i]);
+            }
+            if (cmd_results < resultsExpected - resultsReceived) {
+                cmd_rx[cmd_results++] = binaryValueToFloat(raw, dataType);
+            }
+        }
+        uint8_t crcBytes[2];
+        if (readFailed || _SDI12Internal.readBytes(crcBytes, 2) != 2 ||
+            crc != (crcBytes[0] | (static_cast<uint16_t>(crcBytes[1]) << 8))) {
+            MS_DBG(F("Binary packet incomplete or CRC check failed!"));
+            _SDI12Internal.clearBuffer();
+            success = false;
+            cmd_retries++;
+            continue;
+        }
+        _SDI12Internal.clearBuffer();
+
+        for (uint8_t cr = 0; cr < cmd_results; cr++) {
+            MS_DEEP_DBG(F("Moving result #"), cr, '(', cmd_rx[cr],
+                        F(") to result"), resultsReceived,
+                        F("of the sensor value array"));
+            verifyAndAddMeasurementResult(resultsReceived, cmd_rx[cr]);
+            resultsReceived++;
+        }
+        MS_DBG(F("  Total Results Received:"), resultsReceived,
+               F("Remaining:"), resultsExpected - resultsReceived);
+        cmd_number++;
+    }
 
     // Empty the buffer and de-activate the SDI-12 Object
     deactivate();
 
-    return success && (_numReturnedValues - _incCalcValues) == resultsReceived;
+    return success && resultsExpected == resultsReceived;
+}
+
+
+// Converts one little-endian binary value of an SDI-12 data type to a float
+float SDI12Sensors::binaryValueToFloat(const uint8_t* raw, uint8_t dataType) {
+    uint32_t low = static_cast<uint32_t>(raw[0]) |
+        (static_cast<uint32_t>(raw[1]) << 8) |
+        (static_cast<uint32_t>(raw[2]) << 16) |
+        (static_cast<uint32_t>(raw[3]) << 24);
+    switch (dataType) {
+        case 1: return static_cast<int8_t>(raw[0]);
+        case 2: return raw[0];
+        case 3: return static_cast<int16_t>(raw[0] | (raw[1] << 8));
+        case 4: return static_cast<uint16_t>(raw[0] | (raw[1] << 8));
+        case 5: return static_cast<int32_t>(low);
+        case 6: return low;
+        case 7:
+        case 8: {
+            uint64_t full = low;
+            for (uint8_t i = 4; i < 8; i++) {
+                full |= static_cast<uint64_t>(raw[i]) << (8 * i);
+            }
+            if (dataType == 7) { return static_cast<int64_t>(full); }
+            return full;
+        }
+        case 9: {
+            float result;
+            memcpy(&result, &low, sizeof(result));
+            if (isnan(result) || isinf(result)) { return MS_INVALID_VALUE; }
+            return result;
+        }
+        case 10: {
+            // A double may only be 4 bytes (ie, on AVR), so build the float
+            // from the sign, exponent and top 24 bits of the significand
+            uint32_t high     = static_cast<uint32_t>(raw[4]) |
+                (static_cast<uint32_t>(raw[5]) << 8) |
+                (static_cast<uint32_t>(raw[6]) << 16) |
+                (static_cast<uint32_t>(raw[7]) << 24);
+            int16_t  exponent = (high >> 20) & 0x7FF;
+            if (exponent == 0x7FF) { return MS_INVALID_VALUE; }
+            if (exponent == 0) { return 0; }
+            uint32_t significand = 0x800000UL | ((high & 0xFFFFFUL) << 3) |
+                (low >> 29);
+            float result = ldexp(static_cast<float>(significand),
+                                 exponent - 1023 - 23);
+            return (high & 0x80000000UL) ? -result : result;
+        }
+        default: return MS_INVALID_VALUE;
+    }
+}
+
+
+// Turns high volume binary measurements on or off
+void SDI12Sensors::enableHighVolumeBinary(bool enable) {
+    _highVolumeBinary = enable;
+}
+
+// Whether high volume binary measurements are used
+bool SDI12Sensors::getHighVolumeBinary() {
+    return _highVolumeBinary;
 }
 
 
@@ -715,6 +1017,8 @@ bool SDI12Sensors::addSingleMeasurementResult() {
     if (!initializeMeasurementResult()) { return false; }
 
     bool success = getResults(MS_SDI12_USE_CRC);
+    // The batched measurement, if any, has been used up
+    _concurrentPending = false;
 
     // Return success value when finished
     return finalizeMeasurementAttempt(success);
@@ -731,9 +1035,6 @@ bool SDI12Sensors::addSingleMeasurementResult() {
 
     bool success = false;
 
-    String startCommand;
-    String sdiResponse;
-
     // activate the SDI-12 object
     activate();
 
@@ -741,7 +1042,7 @@ bool SDI12Sensors::addSingleMeasurementResult() {
     if (requestSensorAcknowledgement()) {
         // send the commands to start the measurement; false = not concurrent
         // the returned wait time should always be non-zero
-        int8_t wait = startSDI12Measurement(false);
+        int16_t wait = startSDI12Measurement(false);
 
         // Set the times we've activated the sensor and asked for a measurement
         if (wait >= 0) {
@@ -760,19 +1061,14 @@ bool SDI12Sensors::addSingleMeasurementResult() {
                    static_cast<uint32_t>(1000 * (wait))) {
                 // sensor can interrupt us to let us know it is done early
                 if (_SDI12Internal.available()) {
-#ifdef MS_SDI12SENSORS_DEBUG_DEEP
-                    // if we're debugging print out early response
-                    MS_DEEP_DBG(F("    <<<"),
-                                _SDI12Internal.readStringUntil('\n'));
+                    // read the response to make sure it's removed from the
+                    // buffer, and print it if we're debugging
+                    char serviceRequest[SDI12_MAX_RESPONSE_LENGTH + 1];
+                    readSDI12Response(_SDI12Internal, serviceRequest,
+                                      sizeof(serviceRequest));
+                    MS_DEEP_DBG(F("    <<<"), serviceRequest);
                     _SDI12Internal.clearBuffer();
                     break;
-#else
-                    // if we're not debugging, just read the response to make
-                    // sure it's removed from the buffer
-                    _SDI12Internal.readStringUntil('\n');
-                    _SDI12Internal.clearBuffer();
-                    break;
-#endif
                 }
             }
             // Wait for anything else and clear it out
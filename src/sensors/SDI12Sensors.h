@@ -49,6 +49,19 @@
  * SDI12 sensor, no interrupts (or tips) will be registered during SDI12
  * communication.
  *
+ * Any number of SDI-12 sensors with different addresses can share one data
+ * pin.  When concurrent measurements are used, the first sensor on a pin to
+ * start a measurement also starts concurrent measurements on every other
+ * sensor on that pin that is awake and stable, all in one activation of the
+ * bus.  Each sensor's data are collected once the wait it returned has passed,
+ * so the sensors are read in the order their data become ready.
+ *
+ * Sensors supporting the SDI-12 v1.4 high volume binary commands can be told
+ * to use them with SDI12Sensors::enableHighVolumeBinary().  The values are then
+ * collected in binary packets holding many more values than an ASCII data
+ * response, which cuts the number of data commands for sensors that return
+ * many values.
+ *
  * @section sdi12_group_flags Build flags
  * - `-D MS_SDI12_NON_CONCURRENT`
  *    - Instructs *all* SDI-12 sensors to take non-concurrent measurements
@@ -99,6 +112,13 @@
 // SDI12_EXTERNAL_PCINT Unfortunately, that is not compatible with the Arduino
 // IDE
 
+/**
+ * @brief The longest response to an SDI-12 command, not counting the line
+ * feed: the address, up to 75 characters of values, a 3 character CRC and the
+ * carriage return.
+ */
+#define SDI12_MAX_RESPONSE_LENGTH 80
+
 /**
  * @brief The main class for SDI-12 Sensors
  */
@@ -163,9 +183,10 @@ class SDI12Sensors : public Sensor {
                  uint32_t measurementTime_ms = 0, int8_t extraWakeTime = 0,
                  uint8_t incCalcValues = 0);
     /**
-     * @brief Destroy the SDI12Sensors object - no action taken
+     * @brief Destroy the SDI12Sensors object and remove it from the list of
+     * sensors sharing measurements on a data pin.
      */
-    ~SDI12Sensors() override = default;
+    ~SDI12Sensors() override;
 
     /**
      * @brief Get the stored sensor vendor name returned by a previously called
@@ -207,6 +228,27 @@ class SDI12Sensors : public Sensor {
      */
     String getSensorLocation() override;
 
+    /**
+     * @brief Turn high volume binary measurements on or off.
+     *
+     * When on, measurements are started with the SDI-12 v1.4 high volume
+     * binary measurement command [address][H][B][!] and the results are
+     * collected with the binary data commands [address][D][B][0-999][!].  Each
+     * binary data packet can carry many more values than an ASCII data
+     * response, so sensors returning many values can be read with far fewer
+     * commands.  This is off by default; only turn it on for sensors that
+     * support the high volume binary commands.
+     *
+     * @param enable True to use high volume binary measurements.
+     */
+    void enableHighVolumeBinary(bool enable = true);
+    /**
+     * @brief Check whether high volume binary measurements are used.
+     *
+     * @return True if high volume binary measurements are used.
+     */
+    bool getHighVolumeBinary();
+
     /**
      * @brief Calls the begin for the SDI-12 object to set all of the
      * pre-scalers and timers.
@@ -238,7 +280,38 @@ class SDI12Sensors : public Sensor {
 // Only need this for concurrent measurements.
 // NOTE:  By default, concurrent measurements are used!
 #ifndef MS_SDI12_NON_CONCURRENT
+    /**
+     * @copydoc Sensor::startSingleMeasurement()
+     *
+     * If another SDI-12 sensor on the same data pin already started a
+     * concurrent measurement on this sensor since it was woken, no command is
+     * sent.  Otherwise a concurrent measurement is started on this sensor and,
+     * in the same activation of the bus, on every other sensor on the pin that
+     * is awake, stable and not already measuring.
+     */
     bool startSingleMeasurement() override;
+    /**
+     * @brief Check whether or not the wait the sensor returned in reply to
+     * the concurrent measurement command has passed.
+     *
+     * @return True indicates that the sensor's data should be ready.
+     */
+    bool isMeasurementComplete() override;
+    /**
+     * @copydoc Sensor::getMillisToNextEvent()
+     *
+     * While a measurement is in progress, this counts down to the wait the
+     * sensor returned rather than the measurement time.
+     */
+    uint32_t getMillisToNextEvent() override;
+    /**
+     * @copydoc Sensor::clearMeasurementStatus()
+     *
+     * This also drops any concurrent measurement another sensor on the pin
+     * started on this one during an earlier update, whose data were never
+     * collected.
+     */
+    void clearMeasurementStatus() override;
 #endif
     bool addSingleMeasurementResult() override;
 
@@ -269,11 +342,14 @@ class SDI12Sensors : public Sensor {
      *
      * @param isConcurrent Whether to start a concurrent or standard
      * measurement.  Defaults to 'true' for a concurrent measurement.
+     * @param bus The SDI-12 object to send the command on, which must already
+     * be active on this sensor's data pin.  Defaults to this sensor's own.
      *
-     * @return The length of time the measurement is expected to
-     * take.
+     * @return The number of seconds (0-999) the sensor said the measurement
+     * will take, or -1 if it did not start a measurement.
      */
-    int8_t startSDI12Measurement(bool isConcurrent = true);
+    int16_t startSDI12Measurement(bool isConcurrent = true,
+                                  SDI12* bus         = nullptr);
     /**
      * @brief Gets the results of either a standard or a concurrent measurement
      *
@@ -283,6 +359,73 @@ class SDI12Sensors : public Sensor {
      * returned.
      */
     virtual bool getResults(bool verify_crc);
+    /**
+     * @brief Gets the results of a high volume binary measurement.
+     *
+     * The values are read straight out of each binary data packet and the
+     * packet CRC is always checked.
+     *
+     * @return True if the full number of expected results was
+     * returned.
+     */
+    bool getBinaryResults();
+    /**
+     * @brief Convert one value from a binary data packet to a float.
+     *
+     * @param raw The bytes of the value, least significant first.
+     * @param dataType The SDI-12 binary data type of the value (1-10).
+     * @return The value, or #MS_INVALID_VALUE for an unknown data type or a
+     * value that isn't a number.
+     */
+    static float binaryValueToFloat(const uint8_t* raw, uint8_t dataType);
+    /**
+     * @brief Add one byte to a running SDI-12 CRC-16.
+     *
+     * @param crc The CRC of the bytes before this one, starting from 0.
+     * @param value The next byte.
+     * @return The CRC including this byte.
+     */
+    static uint16_t addToSDI12CRC(uint16_t crc, uint8_t value);
+    /**
+     * @brief Read a single response from the SDI-12 bus into a buffer.
+     *
+     * The line ending and any whitespace around the response are removed and
+     * the buffer is null terminated.
+     *
+     * @param sdi12 The active SDI-12 object to read from.
+     * @param buffer The buffer to read into.
+     * @param bufferSize The size of the buffer, including the terminator.
+     * @return The number of characters in the response.
+     */
+    static size_t readSDI12Response(SDI12& sdi12, char* buffer,
+                                    size_t bufferSize);
+    /**
+     * @brief Check the 3 character CRC at the end of a response.
+     *
+     * @param response The response, without the line ending.
+     * @param length The number of characters in the response, including the
+     * CRC.
+     * @return True if the CRC matches the rest of the response.
+     */
+    static bool checkSDI12CRC(const char* response, size_t length);
+    /**
+     * @brief Parse the values of a data response in a single pass, without
+     * copying them.
+     *
+     * Each value is a polarity sign followed by up to 9 digits and an optional
+     * decimal point.  Values equal to #MS_INVALID_VALUE are skipped, as are
+     * any values beyond the space in the results array.
+     *
+     * @param values The values portion of the response, after the address and
+     * without a CRC or line ending.
+     * @param length The number of characters in the values portion.
+     * @param results The array to fill with the parsed values.
+     * @param maxResults The number of values the results array can hold.
+     * @return The number of values put in the results array, or -1 if the
+     * response contains a character that can't be part of a value.
+     */
+    static int8_t parseSDI12Values(const char* values, size_t length,
+                                   float results[], uint8_t maxResults);
     /**
      * @brief Internal reference to the SDI-12 object.
      */
@@ -296,8 +439,60 @@ class SDI12Sensors : public Sensor {
      * and the time the command is sent.
      */
     int8_t _extraWakeTime;
+    /**
+     * @brief True to use high volume binary measurements.
+     */
+    bool _highVolumeBinary = false;
 
  private:
+    /**
+     * @brief The most recently constructed SDI-12 sensor, the start of a list
+     * of every SDI-12 sensor used to find the sensors sharing a data pin.
+     */
+    static SDI12Sensors* _lastSDI12;
+    /**
+     * @brief The SDI-12 sensor constructed before this one, or a null pointer
+     * for the first.
+     */
+    SDI12Sensors* _previousSDI12 = nullptr;
+    /**
+     * @brief True when another sensor on the pin started a concurrent
+     * measurement on this sensor and its data haven't been collected yet.
+     */
+    bool _concurrentPending = false;
+    /**
+     * @brief The time another sensor on the pin started a concurrent
+     * measurement on this sensor.
+     */
+    uint32_t _millisConcurrentStarted = 0;
+    /**
+     * @brief The wait in ms for the current concurrent measurement: the wait
+     * the sensor returned, but no less than the measurement time.
+     */
+    uint32_t _concurrentWait_ms = 0;
+    /**
+     * @brief Add this sensor to the list of every SDI-12 sensor.
+     */
+    void linkSDI12();
+#ifndef MS_SDI12_NON_CONCURRENT
+    /**
+     * @brief Check whether a concurrent measurement can be started on this
+     * sensor along with one on another sensor.
+     *
+     * @param dataPin The data pin of the sensor starting its measurement.
+     * @return True if this sensor is on the same pin, awake, stable and not
+     * already measuring.
+     */
+    bool canJoinBatch(int8_t dataPin);
+    /**
+     * @brief Get how long to wait for a concurrent measurement.
+     *
+     * @param wait The wait in seconds the sensor returned, 0-999.
+     * @return The wait in ms, but no less than the measurement time.
+     */
+    uint32_t concurrentWait(int16_t wait);
+#endif
+
     String _sensorVendor;   ///< The vendor (manufacturer) of the SDI-12 sensor
     String _sensorModel;    ///< The model of the SDI-12 sensor
     String _sensorVersion;  ///< The version of the SDI-12 sensor
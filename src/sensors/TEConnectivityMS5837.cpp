@@ -61,6 +61,12 @@ TEConnectivityMS5837::TEConnectivityMS5837(int8_t powerPin, MS5837Model model,
 
 
 String TEConnectivityMS5837::getSensorName() {
+    return getModelName();
+}
+size_t TEConnectivityMS5837::printSensorName(Stream* stream) {
+    return stream->print(getModelName());
+}
+const __FlashStringHelper* TEConnectivityMS5837::getModelName() {
     auto modelEnum = static_cast<MS5837Model>(_model);
     switch (modelEnum) {
         case MS5837Model::MS5837_02BA: return F("TEConnectivityMS5837_02BA");
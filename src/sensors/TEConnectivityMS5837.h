@@ -498,6 +498,7 @@ class TEConnectivityMS5837 : public Sensor {
     bool wake() override;
 
     String getSensorName() override;
+    size_t printSensorName(Stream* stream) override;
     String getSensorLocation() override;
 
     bool addSingleMeasurementResult() override;
@@ -557,6 +558,12 @@ class TEConnectivityMS5837 : public Sensor {
      * value, false otherwise.
      */
     bool validateAndCorrectModel();
+    /**
+     * @brief Get the name of the sensor for its configured model.
+     *
+     * @return The sensor name, stored in flash.
+     */
+    const __FlashStringHelper* getModelName();
 };
 
 